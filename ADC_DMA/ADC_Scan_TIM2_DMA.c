@@ -0,0 +1,79 @@
+// Three analog inputs scanned at 20 kHz: TIM2 TRGO triggers ADC1, DMA double buffer, fixed-point filtering (STM32F411)
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/ADC_DMA_Driver_STM32F4xx.h"
+
+#define GPIOA_ODR (*(volatile uint32_t *)(GPIOA_BASE + 0x14))
+#define GPIOA_BSRR (*(volatile uint32_t *)(GPIOA_BASE + 0x18))
+
+#define HSI_CLK 16000000U
+#define SCAN_RATE_HZ 20000U // 3 channels * 96 ADC clocks at 8 MHz = 36 us per scan, period 50 us
+#define FRAMES_PER_HALF 16U // callback every 16 scans = 0.8 ms
+#define CHANNEL_COUNT 3U
+#define VREF_MV 3300U
+
+#define LED_PA5 5
+
+// Rank order in each frame: PA0 (IN0), PA1 (IN1), PA4 (IN4)
+const uint8_t Channels[CHANNEL_COUNT] = {0, 1, 4};
+
+uint16_t Adc_Buffer[2U * FRAMES_PER_HALF * CHANNEL_COUNT];
+
+ADC_Filter_t Pot_Filter;
+
+volatile uint16_t sensor_14bit = 0; // IN0, oversampled 16x -> 14 bits
+volatile uint16_t sensor_avg = 0;   // IN1, average of 16 frames
+volatile uint16_t pot_filtered = 0; // IN4, exponential average
+volatile uint32_t pot_mv = 0;       // IN4 in millivolts
+volatile uint32_t blocks = 0;
+
+// Runs at DMA priority while the DMA fills the other half of Adc_Buffer
+void Adc_Block_Ready(const uint16_t *Frames, uint16_t Frame_Count)
+{
+    (void)Frame_Count;
+
+    sensor_14bit = ADC_Channel_Oversample(Frames, 2, CHANNEL_COUNT, 0);
+    sensor_avg = ADC_Channel_Average(Frames, 4, CHANNEL_COUNT, 1);
+    pot_filtered = ADC_Filter_Update(&Pot_Filter, ADC_Channel_Average(Frames, 4, CHANNEL_COUNT, 2));
+
+    blocks++;
+}
+
+int main(void)
+{
+    uint32_t last_block = 0;
+
+    NVIC_Init();
+
+    RCC_Clock_Ensure(RCC_CLK_GPIOA);
+    GPIOA_MODER &= ~(3U << (LED_PA5 * 2));
+    GPIOA_MODER |= (1U << (LED_PA5 * 2));
+
+    ADC_Filter_Init(&Pot_Filter, 3, 0);
+    ADC_Scan_Init(Channels, CHANNEL_COUNT, ADC_SAMPLE_84, Adc_Buffer, FRAMES_PER_HALF, Adc_Block_Ready);
+    ADC_Trigger_TIM2_Init(HSI_CLK, SCAN_RATE_HZ);
+
+    while (1)
+    {
+        __asm volatile("wfi"); // wakes at every half buffer
+
+        if (blocks == last_block)
+        {
+            continue;
+        }
+
+        last_block = blocks;
+
+        // LED on above half scale (14-bit value -> half scale = 8192)
+        if (sensor_14bit > 8192U)
+        {
+            GPIOA_BSRR = 1U << LED_PA5;
+        }
+        else
+        {
+            GPIOA_BSRR = 1U << (LED_PA5 + 16);
+        }
+
+        pot_mv = ADC_To_Millivolts(pot_filtered, VREF_MV);
+    }
+}
@@ -0,0 +1,285 @@
+// Interrupt-safe atomic operations for Cortex-M4 (STM32F411 / F446) built on LDREX / STREX
+// Exception entry and return clear the local exclusive monitor, so an interrupt that lands between the
+// exclusive load and store makes the store fail and the loop retries. No interrupt is ever masked.
+// On a host PC every operation maps to the GCC __atomic builtins with the same semantics, for tests.
+// ATOMIC_CRITICAL covers what LDREX / STREX cannot (64-bit values, multi-word updates) with a BASEPRI
+// section on the target and a spin lock on the host. ARM cores without LDREX / STREX (Cortex-M0 / M0+)
+// are rejected at build time: the builtins become library calls there, and a spin lock taken by thread
+// code deadlocks an ISR that contends for it.
+
+#ifndef ATOMICS_H
+#define ATOMICS_H
+
+#include <stdint.h>
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+
+#define ATOMIC_LDREX 1
+#include "../Device_Driver_Devlopment/NVIC_Driver_STM32F4xx.h"
+
+/*-------------------------------------------Exclusive access----------------------------------------------*/
+
+static inline uint32_t Atomic_LDREX(volatile uint32_t *P)
+{
+    uint32_t value;
+
+    __asm volatile("ldrex %0, %1" : "=r"(value) : "Q"(*P) : "memory");
+    return value;
+}
+
+// 0 = stored, 1 = the monitor was cleared (interrupt, other exclusive access): retry
+static inline uint32_t Atomic_STREX(volatile uint32_t *P, uint32_t Value)
+{
+    uint32_t failed;
+
+    __asm volatile("strex %0, %2, %1" : "=&r"(failed), "=Q"(*P) : "r"(Value) : "memory");
+    return failed;
+}
+
+static inline uint8_t Atomic_LDREXB(volatile uint8_t *P)
+{
+    uint32_t value;
+
+    __asm volatile("ldrexb %0, %1" : "=r"(value) : "Q"(*P) : "memory");
+    return (uint8_t)value;
+}
+
+static inline uint32_t Atomic_STREXB(volatile uint8_t *P, uint8_t Value)
+{
+    uint32_t failed;
+
+    __asm volatile("strexb %0, %2, %1" : "=&r"(failed), "=Q"(*P) : "r"((uint32_t)Value) : "memory");
+    return failed;
+}
+
+// Drop a pending reservation when a loop gives up without storing (failed compare)
+static inline void Atomic_CLREX(void)
+{
+    __asm volatile("clrex" ::: "memory");
+}
+
+/*-------------------------------------------32-bit operations---------------------------------------------*/
+
+// All return the previous value
+static inline uint32_t Atomic_Fetch_Add(volatile uint32_t *P, uint32_t Value)
+{
+    uint32_t old;
+
+    do
+    {
+        old = Atomic_LDREX(P);
+    } while (Atomic_STREX(P, old + Value));
+
+    return old;
+}
+
+static inline uint32_t Atomic_Fetch_Sub(volatile uint32_t *P, uint32_t Value)
+{
+    uint32_t old;
+
+    do
+    {
+        old = Atomic_LDREX(P);
+    } while (Atomic_STREX(P, old - Value));
+
+    return old;
+}
+
+static inline uint32_t Atomic_Set_Bits(volatile uint32_t *P, uint32_t Mask)
+{
+    uint32_t old;
+
+    do
+    {
+        old = Atomic_LDREX(P);
+    } while (Atomic_STREX(P, old | Mask));
+
+    return old;
+}
+
+static inline uint32_t Atomic_Clear_Bits(volatile uint32_t *P, uint32_t Mask)
+{
+    uint32_t old;
+
+    do
+    {
+        old = Atomic_LDREX(P);
+    } while (Atomic_STREX(P, old & ~Mask));
+
+    return old;
+}
+
+static inline uint32_t Atomic_Swap(volatile uint32_t *P, uint32_t Value)
+{
+    uint32_t old;
+
+    do
+    {
+        old = Atomic_LDREX(P);
+    } while (Atomic_STREX(P, Value));
+
+    return old;
+}
+
+// Stores Desired only if *P == *Expected. Returns 1 on success; on failure *Expected = the current value.
+static inline uint8_t Atomic_Compare_Exchange(volatile uint32_t *P, uint32_t *Expected, uint32_t Desired)
+{
+    uint32_t old;
+
+    do
+    {
+        old = Atomic_LDREX(P);
+
+        if (old != *Expected)
+        {
+            Atomic_CLREX();
+            *Expected = old;
+            return 0;
+        }
+    } while (Atomic_STREX(P, Desired));
+
+    return 1;
+}
+
+/*-------------------------------------------8-bit operations----------------------------------------------*/
+
+static inline uint8_t Atomic_Fetch_Add_8(volatile uint8_t *P, uint8_t Value)
+{
+    uint8_t old;
+
+    do
+    {
+        old = Atomic_LDREXB(P);
+    } while (Atomic_STREXB(P, (uint8_t)(old + Value)));
+
+    return old;
+}
+
+static inline uint8_t Atomic_Compare_Exchange_8(volatile uint8_t *P, uint8_t *Expected, uint8_t Desired)
+{
+    uint8_t old;
+
+    do
+    {
+        old = Atomic_LDREXB(P);
+
+        if (old != *Expected)
+        {
+            Atomic_CLREX();
+            *Expected = old;
+            return 0;
+        }
+    } while (Atomic_STREXB(P, Desired));
+
+    return 1;
+}
+
+/*-------------------------------------------BASEPRI fallback----------------------------------------------*/
+
+// Masks the IRQs at Ceiling and below for the body; more urgent ones keep running (see NVIC priority plan)
+#define ATOMIC_CRITICAL(Ceiling)                                                                         \
+    for (uint32_t atomic_state_ = NVIC_Enter_Critical(Ceiling), atomic_once_ = 1U; atomic_once_;          \
+         NVIC_Exit_Critical(atomic_state_), atomic_once_ = 0U)
+
+#elif defined(__arm__)
+
+#error "Atomics.h: this ARM core has no LDREX / STREX (ARMv6-M); use PRIMASK critical sections instead"
+
+#else // host PC: GCC builtins, same semantics
+
+#define ATOMIC_LDREX 0
+
+static inline uint32_t Atomic_Fetch_Add(volatile uint32_t *P, uint32_t Value)
+{
+    return __atomic_fetch_add(P, Value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t Atomic_Fetch_Sub(volatile uint32_t *P, uint32_t Value)
+{
+    return __atomic_fetch_sub(P, Value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t Atomic_Set_Bits(volatile uint32_t *P, uint32_t Mask)
+{
+    return __atomic_fetch_or(P, Mask, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t Atomic_Clear_Bits(volatile uint32_t *P, uint32_t Mask)
+{
+    return __atomic_fetch_and(P, ~Mask, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t Atomic_Swap(volatile uint32_t *P, uint32_t Value)
+{
+    return __atomic_exchange_n(P, Value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint8_t Atomic_Compare_Exchange(volatile uint32_t *P, uint32_t *Expected, uint32_t Desired)
+{
+    return __atomic_compare_exchange_n(P, Expected, Desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 1U : 0U;
+}
+
+static inline uint8_t Atomic_Fetch_Add_8(volatile uint8_t *P, uint8_t Value)
+{
+    return __atomic_fetch_add(P, Value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint8_t Atomic_Compare_Exchange_8(volatile uint8_t *P, uint8_t *Expected, uint8_t Desired)
+{
+    return __atomic_compare_exchange_n(P, Expected, Desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 1U : 0U;
+}
+
+// One global spin lock stands in for BASEPRI; Ceiling is dropped unexpanded, so the NVIC_PREEMPT_* names
+// need not exist on the host
+static volatile uint8_t Atomic_Host_Lock;
+
+static inline void Atomic_Host_Acquire(void)
+{
+    while (__atomic_test_and_set(&Atomic_Host_Lock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+#define ATOMIC_CRITICAL(Ceiling)                                                                         \
+    for (uint32_t atomic_once_ = (Atomic_Host_Acquire(), 1U); atomic_once_;                              \
+         __atomic_clear(&Atomic_Host_Lock, __ATOMIC_RELEASE), atomic_once_ = 0U)
+
+#endif
+
+/*-------------------------------------------Composite operations------------------------------------------*/
+
+// Aligned word loads / stores are single accesses on both targets; the barrier keeps the compiler from
+// caching or reordering them around the atomics
+static inline uint32_t Atomic_Load(volatile uint32_t *P)
+{
+    uint32_t value = *P;
+
+    __asm volatile("" ::: "memory");
+    return value;
+}
+
+static inline void Atomic_Store(volatile uint32_t *P, uint32_t Value)
+{
+    __asm volatile("" ::: "memory");
+    *P = Value;
+}
+
+// (value + Step) % Modulus in one step: wrap-around counters and state indices (no transient out-of-range value)
+static inline uint32_t Atomic_Fetch_Add_Mod(volatile uint32_t *P, uint32_t Step, uint32_t Modulus)
+{
+    uint32_t old = Atomic_Load(P);
+
+    while (!Atomic_Compare_Exchange(P, &old, (old + Step) % Modulus))
+    {
+    }
+
+    return old;
+}
+
+// Read-and-clear of an event counter / flag word shared with an ISR
+static inline uint32_t Atomic_Take(volatile uint32_t *P)
+{
+    return Atomic_Swap(P, 0);
+}
+
+#endif
@@ -0,0 +1,149 @@
+// Shared counters updated from main and from a 100 kHz TIM2 interrupt: plain ++ loses updates, the
+// LDREX / STREX atomics do not, and cost a few cycles without masking anything (STM32F411 / F446).
+// Same file on the host (gcc -O2 -pthread Atomics_Shared_Counter.c) runs main's loop in two threads
+// against the __atomic fallbacks and prints the counts.
+
+#include <stdint.h>
+#include "Atomics.h"
+
+#define ITERATIONS 1000000UL
+#define EVENT_BITS 0x5U
+
+volatile uint32_t Plain_Counter;
+volatile uint32_t Atomic_Counter;
+volatile uint32_t Event_Flags;
+volatile uint64_t Wide_Counter; // 64-bit: no LDREXD on the M4, updated under ATOMIC_CRITICAL
+
+// Every context does the same: one increment of each counter, one flag set
+static void Count_Once(void)
+{
+    Plain_Counter++; // LDR, ADD, STR: an update between LDR and STR is overwritten
+    Atomic_Fetch_Add(&Atomic_Counter, 1);
+    Atomic_Set_Bits(&Event_Flags, EVENT_BITS);
+
+    ATOMIC_CRITICAL(NVIC_PREEMPT_TIMEBASE)
+    {
+        Wide_Counter++;
+    }
+}
+
+#if defined(__arm__)
+
+#include "../Device_Driver_Devlopment/GP_Timer_STM32F4xx.h"
+
+#define DEMCR (*(volatile uint32_t *)(0xE000EDFCUL))
+#define DWT_CTRL (*(volatile uint32_t *)(0xE0001000UL))
+#define DWT_CYCCNT (*(volatile uint32_t *)(0xE0001004UL))
+
+#define HSI_CLK 16000000UL
+#define ISR_HZ 100000UL
+
+volatile uint32_t Isr_Count;
+volatile uint32_t Lost_Updates;   // main + ISR increments that Plain_Counter missed
+volatile uint32_t Atomic_Errors;  // must stay 0
+volatile uint32_t Cycles_Atomic;  // Atomic_Fetch_Add, no contention
+volatile uint32_t Cycles_Basepri; // the same increment inside ATOMIC_CRITICAL
+
+void TIM2_IRQHandler(void)
+{
+    TIMx_SR(TIM_2) = ~TIM_SR_UIF;
+    Isr_Count++;
+    Count_Once();
+}
+
+static void Measure_Cycles(void)
+{
+    uint32_t start;
+
+    DEMCR |= 1UL << 24; // TRCENA
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1U;
+
+    start = DWT_CYCCNT;
+    Atomic_Fetch_Add(&Atomic_Counter, 1);
+    Cycles_Atomic = DWT_CYCCNT - start;
+
+    start = DWT_CYCCNT;
+    ATOMIC_CRITICAL(NVIC_PREEMPT_TIMEBASE)
+    {
+        Atomic_Counter++;
+    }
+    Cycles_Basepri = DWT_CYCCNT - start;
+
+    Atomic_Counter = 0;
+}
+
+int main(void)
+{
+    NVIC_Init();
+    Measure_Cycles();
+
+    RCC_Clock_Enable(GP_Timer_Clock(TIM_2));
+    GP_Timer_Reset(TIM_2);
+    TIMx_ARR(TIM_2) = (HSI_CLK / ISR_HZ) - 1U;
+    GP_Timer_Load_Prescaler(TIM_2, 0);
+    TIMx_DIER(TIM_2) = TIM_DIER_UIE;
+    NVIC_Setup_IRQ(GP_Timer_IRQn[TIM_2], NVIC_PREEMPT_TIMEBASE, 0);
+    TIMx_CR1(TIM_2) = TIM_CR1_CEN;
+
+    for (uint32_t i = 0; i < ITERATIONS; i++)
+    {
+        Count_Once();
+    }
+
+    TIMx_CR1(TIM_2) = 0;
+
+    Lost_Updates = (ITERATIONS + Isr_Count) - Plain_Counter;
+    Atomic_Errors = ((ITERATIONS + Isr_Count) != Atomic_Counter) + ((ITERATIONS + Isr_Count) != Wide_Counter);
+
+    while (1)
+    {
+        __asm volatile("wfi");
+    }
+}
+
+#else
+
+#include <stdio.h>
+#include <pthread.h>
+
+static void *Worker(void *Arg)
+{
+    (void)Arg;
+
+    for (uint32_t i = 0; i < ITERATIONS; i++)
+    {
+        Count_Once();
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    pthread_t thread[2];
+    uint32_t expected = 2U * ITERATIONS;
+    uint32_t flags;
+
+    for (uint8_t i = 0; i < 2U; i++)
+    {
+        pthread_create(&thread[i], 0, Worker, 0);
+    }
+
+    for (uint8_t i = 0; i < 2U; i++)
+    {
+        pthread_join(thread[i], 0);
+    }
+
+    flags = Atomic_Take(&Event_Flags);
+
+    printf("expected %u\n", (unsigned)expected);
+    printf("plain    %u (lost %u)\n", (unsigned)Plain_Counter, (unsigned)(expected - Plain_Counter));
+    printf("atomic   %u\n", (unsigned)Atomic_Counter);
+    printf("wide     %llu\n", (unsigned long long)Wide_Counter);
+    printf("flags    0x%X, after take 0x%X\n", (unsigned)flags, (unsigned)Event_Flags);
+
+    return ((Atomic_Counter == expected) && (Wide_Counter == expected)) ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,144 @@
+// bxCAN self test on the Nucleo-F446RE: silent loopback, hardware filter banks, RX rings, prioritised TX
+// No transceiver or bus is needed. LD2 (PA5) turns on when every frame was accepted or rejected as expected.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/CAN_Driver_STM32F446RE.h"
+
+#define GPIOA_MODER (*(volatile uint32_t *)(0x40020000UL + 0x00))
+#define GPIOA_BSRR (*(volatile uint32_t *)(0x40020000UL + 0x18))
+
+#define LED_PA5 5
+
+#define BITRATE 500000UL // 16 MHz / (2 x 16 tq), sample point 87.5 %
+
+/*-------------------------------------------Acceptance list---------------------------------------------------
+  Index = value of CAN_Frame_t.filter on reception.
+----------------------------------------------------------------------------------------------------------*/
+
+typedef enum FILTER_INDEX
+{
+    FILTER_ENGINE = 0,   // 0x100 exact
+    FILTER_BRAKES = 1,   // 0x101 exact
+    FILTER_DOORS = 2,    // 0x102 exact
+    FILTER_LIGHTS = 3,   // 0x103 exact        -> one 16-bit list bank holds all four
+    FILTER_DIAG = 4,     // 0x7E0 .. 0x7EF      -> 16-bit mask bank
+    FILTER_J1939_EEC = 5, // 0x0CF00400 exact   -> 32-bit list bank
+    FILTER_J1939_PGN = 6, // PGN 0xFEF1, any SA -> 32-bit mask bank
+    FILTER_COUNT = 7
+} FILTER_INDEX;
+
+const CAN_Filter_t Filters[FILTER_COUNT] =
+{
+    {0x100, CAN_STD_MASK, 0, 0},
+    {0x101, CAN_STD_MASK, 0, 0},
+    {0x102, CAN_STD_MASK, 0, 0},
+    {0x103, CAN_STD_MASK, 0, 0},
+    {0x7E0, 0x7F0, 0, 1},
+    {0x0CF00400, CAN_EXT_MASK, 1, 1},
+    {0x18FEF100, 0x03FFFF00, 1, 1},
+};
+
+typedef struct TEST_FRAME
+{
+    uint32_t id;
+    uint8_t extended;
+    int8_t expected_filter; // -1 = must be rejected by the hardware
+} TEST_FRAME;
+
+const TEST_FRAME Test_Frames[] =
+{
+    {0x103, 0, FILTER_LIGHTS},
+    {0x100, 0, FILTER_ENGINE},
+    {0x7E8, 0, FILTER_DIAG},
+    {0x104, 0, -1},
+    {0x0CF00400, 1, FILTER_J1939_EEC},
+    {0x18FEF117, 1, FILTER_J1939_PGN},
+    {0x18FEF200, 1, -1},
+    {0x101, 0, FILTER_BRAKES},
+    {0x7DF, 0, -1},
+    {0x102, 0, FILTER_DOORS},
+    {0x100, 1, -1}, // extended 0x100 is not standard 0x100
+};
+
+#define TEST_COUNT (sizeof(Test_Frames) / sizeof(Test_Frames[0]))
+
+uint32_t received[FILTER_COUNT];
+uint32_t expected[FILTER_COUNT];
+uint32_t receive_order[TEST_COUNT]; // IDs per FIFO in arrival order: queued frames leave in priority order
+uint8_t received_total;
+
+int main(void)
+{
+    CAN_Frame_t frame = {0};
+    uint8_t pass = 1;
+
+    NVIC_Init();
+
+    RCC_Clock_Ensure(RCC_CLK_GPIOA);
+    GPIOA_MODER |= (1 << (LED_PA5 * 2));
+
+    if ((CAN_Init(CAN_1, BITRATE, CAN_MODE_SILENT_LOOPBACK) != CAN_OK) ||
+        (CAN_Filter_Configure(CAN_1, Filters, FILTER_COUNT) != CAN_OK))
+    {
+        while (1)
+        {
+        }
+    }
+
+    // All frames queued at once: 3 go to the mailboxes, the rest wait in the sorted software queue
+    for (uint8_t i = 0; i < TEST_COUNT; i++)
+    {
+        frame.id = Test_Frames[i].id;
+        frame.extended = Test_Frames[i].extended;
+        frame.dlc = 8;
+        frame.data[0] = i;
+
+        (void)CAN_Transmit(CAN_1, &frame);
+
+        if (Test_Frames[i].expected_filter >= 0)
+        {
+            expected[Test_Frames[i].expected_filter]++;
+        }
+    }
+
+    while (CAN_Controllers[CAN_1].tx_sent < TEST_COUNT)
+    {
+    }
+
+    for (uint8_t fifo = 0; fifo < 2U; fifo++)
+    {
+        while (CAN_Receive(CAN_1, fifo, &frame))
+        {
+            received[frame.filter]++;
+
+            if (received_total < TEST_COUNT)
+            {
+                receive_order[received_total++] = frame.id;
+            }
+
+            // The payload byte names the test frame: the hardware must have matched the expected filter
+            if ((frame.data[0] >= TEST_COUNT) || (Test_Frames[frame.data[0]].expected_filter != (int8_t)frame.filter))
+            {
+                pass = 0;
+            }
+        }
+    }
+
+    for (uint8_t f = 0; f < FILTER_COUNT; f++)
+    {
+        if (received[f] != expected[f])
+        {
+            pass = 0;
+        }
+    }
+
+    if (pass)
+    {
+        GPIOA_BSRR = (1 << LED_PA5);
+    }
+
+    while (1)
+    {
+        __asm volatile("wfi");
+    }
+}
@@ -0,0 +1,144 @@
+// Stackless coroutines (protothreads) for super-loop firmware on STM32F411x / STM32F446xx
+// Each coroutine is a plain function that resumes where it yielded. State = 8 bytes (CO_t), no stack.
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <stdint.h>
+
+/*-------------------------------------------DWT cycle counter (time base)--------------------------------*/
+
+#define DEMCR (*(volatile uint32_t *)(0xE000EDFCUL))
+#define DWT_CTRL (*(volatile uint32_t *)(0xE0001000UL))
+#define DWT_CYCCNT (*(volatile uint32_t *)(0xE0001004UL))
+
+#define DEMCR_TRCENA (1UL << 24)
+#define DWT_CTRL_CYCCNTENA (1UL << 0)
+
+#ifndef CLK_FRQ
+#define CLK_FRQ 16000000UL // Using STM32F411 CPU Clock (HSI)
+#endif
+
+#define CO_CYCLES_PER_US (CLK_FRQ / 1000000UL)
+#define CO_CYCLES_PER_MS (CLK_FRQ / 1000UL)
+
+// Free-running 32-bit cycle counter: 1 cycle resolution, wraps after 2^32 / CLK_FRQ (268 s at 16 MHz).
+// Longest single wait is therefore just under that.
+void CO_Timebase_Init(void)
+{
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+#define CO_NOW() (DWT_CYCCNT)
+#define CO_ELAPSED(start, cycles) ((uint32_t)(CO_NOW() - (start)) >= (uint32_t)(cycles))
+
+/*-------------------------------------------Coroutine state----------------------------------------------*/
+
+typedef enum CO_STATUS
+{
+    CO_WAITING = 0, // yielded, call again
+    CO_DONE = 1     // ran to CO_END, restarts from the top on the next call
+} CO_STATUS;
+
+typedef struct CO_t
+{
+    uint16_t lc;    // resume point (source line of the last yield), 0 = start
+    uint16_t flags; // free for the coroutine itself
+    uint32_t t0;    // start time of the current wait
+} CO_t;
+
+typedef CO_STATUS (*CO_Function_t)(CO_t *co);
+
+/*-------------------------------------------Coroutine body macros------------------------------------------
+  Body runs inside one switch statement: local variables do NOT survive a yield (keep them in static
+  or in the structure that owns the CO_t). Do not use switch inside a coroutine body.
+----------------------------------------------------------------------------------------------------------*/
+
+#define CO_BEGIN(co) \
+    switch ((co)->lc) \
+    {                 \
+    case 0:
+
+#define CO_END(co) \
+    }              \
+    (co)->lc = 0;  \
+    return CO_DONE
+
+#define CO_YIELD(co)              \
+    do                            \
+    {                             \
+        (co)->lc = __LINE__;      \
+        return CO_WAITING;        \
+    case __LINE__:;               \
+    } while (0)
+
+#define CO_WAIT_UNTIL(co, cond)   \
+    do                            \
+    {                             \
+        (co)->lc = __LINE__;      \
+    case __LINE__:                \
+        if (!(cond))              \
+        {                         \
+            return CO_WAITING;    \
+        }                         \
+    } while (0)
+
+#define CO_WAIT_WHILE(co, cond) CO_WAIT_UNTIL(co, !(cond))
+
+#define CO_DELAY_CYCLES(co, cycles)                    \
+    do                                                 \
+    {                                                  \
+        (co)->t0 = CO_NOW();                           \
+        CO_WAIT_UNTIL(co, CO_ELAPSED((co)->t0, (cycles))); \
+    } while (0)
+
+#define CO_DELAY_US(co, us) CO_DELAY_CYCLES(co, (uint32_t)(us) * CO_CYCLES_PER_US)
+#define CO_DELAY_MS(co, ms) CO_DELAY_CYCLES(co, (uint32_t)(ms) * CO_CYCLES_PER_MS)
+
+// Fixed-rate loop: next wake = previous wake + period, so body run time does not add drift
+#define CO_PERIOD_MS(co, ms)                                                   \
+    do                                                                         \
+    {                                                                          \
+        CO_WAIT_UNTIL(co, CO_ELAPSED((co)->t0, (uint32_t)(ms) * CO_CYCLES_PER_MS)); \
+        (co)->t0 += (uint32_t)(ms) * CO_CYCLES_PER_MS;                         \
+    } while (0)
+
+#define CO_RESTART(co)     \
+    do                     \
+    {                      \
+        (co)->lc = 0;      \
+        return CO_WAITING; \
+    } while (0)
+
+/*-------------------------------------------Scheduler----------------------------------------------------*/
+
+typedef struct CO_Task_t
+{
+    CO_Function_t function;
+    CO_t co;
+} CO_Task_t;
+
+void CO_Init(CO_Task_t *Tasks, uint8_t Count)
+{
+    uint32_t now = CO_NOW();
+
+    for (uint8_t i = 0; i < Count; i++)
+    {
+        Tasks[i].co.lc = 0;
+        Tasks[i].co.flags = 0;
+        Tasks[i].co.t0 = now;
+    }
+}
+
+// One pass over all coroutines. Call from the super-loop; latency = one pass, no blocking delays anywhere.
+void CO_Run(CO_Task_t *Tasks, uint8_t Count)
+{
+    for (uint8_t i = 0; i < Count; i++)
+    {
+        Tasks[i].function(&Tasks[i].co);
+    }
+}
+
+#endif
@@ -0,0 +1,194 @@
+// LED blink, PWM duty ramp and button-driven LED state machine interleaved as stackless coroutines (STM32F411)
+// Same behaviour as LED_Blinking_SysTimer.c, STM32_PWM_TM2.c and Finite_State_Machine.c, but without delay_ms()
+
+#include <stdint.h>
+#include "Coroutine.h"
+
+/* ===================== RCC ===================== */
+#define RCC_BASE 0x40023800UL
+#define RCC_AHB1ENR (*(volatile uint32_t *)(RCC_BASE + 0x30))
+#define RCC_APB1ENR (*(volatile uint32_t *)(RCC_BASE + 0x40))
+
+/* ===================== GPIOA ===================== */
+#define GPIOA_BASE 0x40020000UL
+#define GPIOA_MODER (*(volatile uint32_t *)(GPIOA_BASE + 0x00))
+#define GPIOA_IDR (*(volatile uint32_t *)(GPIOA_BASE + 0x10))
+#define GPIOA_ODR (*(volatile uint32_t *)(GPIOA_BASE + 0x14))
+#define GPIOA_BSRR (*(volatile uint32_t *)(GPIOA_BASE + 0x18))
+#define GPIOA_AFRL (*(volatile uint32_t *)(GPIOA_BASE + 0x20))
+
+/* ===================== TIM2 ===================== */
+#define TIM2_BASE 0x40000000UL
+#define TIM2_CR1 (*(volatile uint32_t *)(TIM2_BASE + 0x00))
+#define TIM2_EGR (*(volatile uint32_t *)(TIM2_BASE + 0x14))
+#define TIM2_CCMR1 (*(volatile uint32_t *)(TIM2_BASE + 0x18))
+#define TIM2_CCER (*(volatile uint32_t *)(TIM2_BASE + 0x20))
+#define TIM2_PSC (*(volatile uint32_t *)(TIM2_BASE + 0x28))
+#define TIM2_ARR (*(volatile uint32_t *)(TIM2_BASE + 0x2C))
+#define TIM2_CCR1 (*(volatile uint32_t *)(TIM2_BASE + 0x34))
+
+#define PWM_PA0 0    // TIM2_CH1 (AF1)
+#define BUTTON_PA1 1
+#define LED_PA3 3    // 1 s blink
+#define LED_PA4 4    // OFF / ON / TOGGLE state machine
+
+#define GPIO_BSRR_RESET 16U
+
+void GPIO_Pin_Toggle(uint8_t Pin)
+{
+    if (GPIOA_ODR & (1 << Pin))
+    {
+        GPIOA_BSRR = 1 << (Pin + GPIO_BSRR_RESET);
+    }
+    else
+    {
+        GPIOA_BSRR = 1 << Pin;
+    }
+}
+
+void GPIOA_Init(void)
+{
+    RCC_AHB1ENR |= (1 << 0);
+
+    GPIOA_MODER &= ~((3 << (2 * PWM_PA0)) | (3 << (2 * BUTTON_PA1)) | (3 << (2 * LED_PA3)) | (3 << (2 * LED_PA4)));
+    GPIOA_MODER |= (2 << (2 * PWM_PA0)) | (1 << (2 * LED_PA3)) | (1 << (2 * LED_PA4));
+
+    GPIOA_AFRL &= ~(0xF << (4 * PWM_PA0));
+    GPIOA_AFRL |= (1 << (4 * PWM_PA0)); // AF1 = TIM2_CH1
+}
+
+void TIM2_PWM_Init(void)
+{
+    RCC_APB1ENR |= (1 << 0);
+
+    TIM2_PSC = 15;   // 16MHz / 16 = 1MHz
+    TIM2_ARR = 1000; // 1kHz PWM
+    TIM2_CCR1 = 0;
+
+    TIM2_CCMR1 = (6 << 4) | (1 << 3); // PWM mode 1, preload
+    TIM2_CCER = (1 << 0);
+
+    TIM2_CR1 |= (1 << 7);
+    TIM2_EGR = (1 << 0);
+    TIM2_CR1 |= (1 << 0);
+}
+
+/* ===================== Coroutines ===================== */
+
+// LED_Blinking_SysTimer.c: toggle, delay_ms(1000), repeat
+CO_STATUS Blink_Task(CO_t *co)
+{
+    CO_BEGIN(co);
+
+    while (1)
+    {
+        GPIO_Pin_Toggle(LED_PA3);
+        CO_PERIOD_MS(co, 1000);
+    }
+
+    CO_END(co);
+}
+
+// STM32_PWM_TM2.c: duty 0..100 %, one step every 50 ms
+static uint8_t duty = 0;
+
+CO_STATUS Pwm_Ramp_Task(CO_t *co)
+{
+    CO_BEGIN(co);
+
+    while (1)
+    {
+        TIM2_CCR1 = (TIM2_ARR * duty) / 100;
+        CO_PERIOD_MS(co, 50);
+
+        duty++;
+        if (duty > 100)
+        {
+            duty = 0;
+        }
+    }
+
+    CO_END(co);
+}
+
+// Button edge detector with 20 ms debounce; publishes presses through a flag
+static volatile uint8_t button_pressed = 0;
+
+CO_STATUS Button_Task(CO_t *co)
+{
+    CO_BEGIN(co);
+
+    while (1)
+    {
+        CO_WAIT_UNTIL(co, GPIOA_IDR & (1 << BUTTON_PA1));
+        CO_DELAY_MS(co, 20);
+
+        if (GPIOA_IDR & (1 << BUTTON_PA1))
+        {
+            button_pressed = 1;
+            CO_WAIT_WHILE(co, GPIOA_IDR & (1 << BUTTON_PA1));
+            CO_DELAY_MS(co, 20);
+        }
+    }
+
+    CO_END(co);
+}
+
+// Finite_State_Machine.c states as sequential code: each press moves to the next block
+#define BUTTON_EVENT() (button_pressed ? (button_pressed = 0, 1) : 0)
+
+CO_STATUS Led_State_Task(CO_t *co)
+{
+    CO_BEGIN(co);
+
+    while (1)
+    {
+        // LED_OFF
+        GPIOA_BSRR = 1 << (LED_PA4 + GPIO_BSRR_RESET);
+        CO_WAIT_UNTIL(co, BUTTON_EVENT());
+
+        // LED_ON
+        GPIOA_BSRR = 1 << LED_PA4;
+        CO_WAIT_UNTIL(co, BUTTON_EVENT());
+
+        // LED_TOGGLE: reacts to the button within one super-loop pass, not after a 1 s delay_ms()
+        co->t0 = CO_NOW();
+        while (!BUTTON_EVENT())
+        {
+            if (CO_ELAPSED(co->t0, 1000U * CO_CYCLES_PER_MS))
+            {
+                co->t0 += 1000U * CO_CYCLES_PER_MS;
+                GPIO_Pin_Toggle(LED_PA4);
+            }
+            CO_YIELD(co);
+        }
+    }
+
+    CO_END(co);
+}
+
+CO_Task_t Tasks[] =
+{
+    {Blink_Task, {0}},
+    {Pwm_Ramp_Task, {0}},
+    {Button_Task, {0}},
+    {Led_State_Task, {0}},
+};
+
+#define TASK_COUNT (sizeof(Tasks) / sizeof(Tasks[0]))
+
+/* ===================== MAIN ===================== */
+
+int main(void)
+{
+    CO_Timebase_Init();
+    GPIOA_Init();
+    TIM2_PWM_Init();
+
+    CO_Init(Tasks, TASK_COUNT);
+
+    while (1)
+    {
+        CO_Run(Tasks, TASK_COUNT);
+    }
+}
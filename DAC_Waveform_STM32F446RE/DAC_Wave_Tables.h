@@ -0,0 +1,59 @@
+// Build-time waveform tables for the DAC driver
+// Every entry is a constant expression: the compiler evaluates the sine polynomial (in double, on the
+// build machine) and stores plain 12-bit codes in flash. No floating point and no table setup at run time.
+
+#ifndef DAC_WAVE_TABLES_H
+#define DAC_WAVE_TABLES_H
+
+#include <stdint.h>
+
+/*-------------------------------------------Repetition------------------------------------------------------
+  DAC_REPEAT_N(M, 0) expands to M(0) M(1) ... M(N-1); M(i) must end with a comma.
+----------------------------------------------------------------------------------------------------------*/
+
+#define DAC_REPEAT_4(M, b) M((b) + 0) M((b) + 1) M((b) + 2) M((b) + 3)
+#define DAC_REPEAT_16(M, b) DAC_REPEAT_4(M, (b) + 0) DAC_REPEAT_4(M, (b) + 4) DAC_REPEAT_4(M, (b) + 8) DAC_REPEAT_4(M, (b) + 12)
+#define DAC_REPEAT_32(M, b) DAC_REPEAT_16(M, (b) + 0) DAC_REPEAT_16(M, (b) + 16)
+#define DAC_REPEAT_64(M, b) DAC_REPEAT_32(M, (b) + 0) DAC_REPEAT_32(M, (b) + 32)
+#define DAC_REPEAT_128(M, b) DAC_REPEAT_64(M, (b) + 0) DAC_REPEAT_64(M, (b) + 64)
+#define DAC_REPEAT_256(M, b) DAC_REPEAT_128(M, (b) + 0) DAC_REPEAT_128(M, (b) + 128)
+
+/*-------------------------------------------Sine (constant expression)--------------------------------------
+  sin(2*pi*i/N) = -sin(t) with t = pi * (2 * (i mod N) / N - 1) in [-pi, pi).
+  Taylor series to t^15: error below 1e-6 on that range, far under one 12-bit step (2.4e-4).
+----------------------------------------------------------------------------------------------------------*/
+
+#define DAC_PI 3.14159265358979323846
+
+#define DAC_T(i, N) (DAC_PI * ((2.0 * (double)((i) % (N)) / (double)(N)) - 1.0))
+#define DAC_T2(i, N) (DAC_T(i, N) * DAC_T(i, N))
+
+#define DAC_SIN_2PI(i, N)                                                                   \
+    (-DAC_T(i, N) *                                                                         \
+     (1.0 + DAC_T2(i, N) *                                                                  \
+      (-1.0 / 6.0 + DAC_T2(i, N) *                                                          \
+       (1.0 / 120.0 + DAC_T2(i, N) *                                                        \
+        (-1.0 / 5040.0 + DAC_T2(i, N) *                                                     \
+         (1.0 / 362880.0 + DAC_T2(i, N) *                                                   \
+          (-1.0 / 39916800.0 + DAC_T2(i, N) *                                               \
+           (1.0 / 6227020800.0 + DAC_T2(i, N) * (-1.0 / 1307674368000.0)))))))))
+
+// Rounded 12-bit code: Offset + Amplitude * f, f in -1..1. Offset +/- Amplitude must stay in 0..4095.
+#define DAC_CODE(f, Amplitude, Offset) ((uint16_t)((double)(Offset) + ((double)(Amplitude) * (f)) + 0.5))
+
+#define DAC_SINE(i, N, Amplitude, Offset) DAC_CODE(DAC_SIN_2PI(i, N), Amplitude, Offset)
+
+/*-------------------------------------------Arbitrary shapes------------------------------------------------
+  Any expression of the sample index works; these are examples built the same way.
+----------------------------------------------------------------------------------------------------------*/
+
+// Rising ramp 0 .. 4095 over N samples (exact integer math)
+#define DAC_SAWTOOTH(i, N) ((uint16_t)((4095UL * (uint32_t)((i) % (N))) / ((N) - 1U)))
+
+// Band-limited square: first four odd harmonics scaled by 1/n (Fourier series). Overshoot peaks at 1.18,
+// so keep Amplitude * 1.18 inside the offset (e.g. 1700 around 2048)
+#define DAC_SQUARE_4(i, N)                                                                  \
+    ((4.0 / DAC_PI) * (DAC_SIN_2PI(i, N) + (DAC_SIN_2PI(3 * (i), N) / 3.0) +                \
+                       (DAC_SIN_2PI(5 * (i), N) / 5.0) + (DAC_SIN_2PI(7 * (i), N) / 7.0)))
+
+#endif
@@ -0,0 +1,89 @@
+// Two-channel DAC waveform generator on the Nucleo-F446RE: TIM6-triggered DMA, dual mode, hardware triangle / noise
+// PA4 = DAC_OUT1, PA5 = DAC_OUT2 (LD2 on the Nucleo shares PA5 and glows with the channel 2 signal)
+// User button B1 (PC13) steps through the modes.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/DAC_Driver_STM32F446RE.h"
+#include "../Device_Driver_Devlopment/EXTI_Driver_STM32F4xx.h"
+#include "DAC_Wave_Tables.h"
+
+#define HSI_CLK 16000000U
+#define SAMPLE_RATE 128000U // TIM6 ARR = 124: 128 kS/s per channel
+#define WAVE_POINTS 128U    // 128 kS/s / 128 points = 1 kHz
+
+#define BUTTON_PC13 13
+
+typedef enum WAVE_MODE
+{
+    MODE_QUADRATURE = 0, // OUT1 sine, OUT2 cosine, one packed table in dual mode
+    MODE_TABLES = 1,     // OUT1 band-limited square, OUT2 sawtooth, two independent streams
+    MODE_GENERATORS = 2, // OUT1 hardware triangle, OUT2 hardware noise, no DMA at all
+    MODE_COUNT = 3
+} WAVE_MODE;
+
+/*-------------------------------------------Tables (computed by the compiler)--------------------------------*/
+
+#define SINE_COS_ENTRY(i) \
+    DAC_DUAL(DAC_SINE(i, WAVE_POINTS, 2000, 2048), DAC_SINE((i) + (WAVE_POINTS / 4U), WAVE_POINTS, 2000, 2048)),
+#define SQUARE_ENTRY(i) DAC_CODE(DAC_SQUARE_4(i, WAVE_POINTS), 1700, 2048),
+#define SAWTOOTH_ENTRY(i) DAC_SAWTOOTH(i, WAVE_POINTS),
+
+const uint32_t Quadrature_Table[WAVE_POINTS] = {DAC_REPEAT_128(SINE_COS_ENTRY, 0)};
+const uint16_t Square_Table[WAVE_POINTS] = {DAC_REPEAT_128(SQUARE_ENTRY, 0)};
+const uint16_t Sawtooth_Table[WAVE_POINTS] = {DAC_REPEAT_128(SAWTOOTH_ENTRY, 0)};
+
+volatile uint8_t requested_mode = MODE_QUADRATURE;
+
+void Mode_Apply(WAVE_MODE Mode)
+{
+    switch (Mode)
+    {
+    case MODE_QUADRATURE:
+        DAC_Dual_Stream_Start(Quadrature_Table, WAVE_POINTS);
+        break;
+
+    case MODE_TABLES:
+        DAC_Stream_Start(DAC_CHANNEL_1, Square_Table, WAVE_POINTS);
+        DAC_Stream_Start(DAC_CHANNEL_2, Sawtooth_Table, WAVE_POINTS);
+        break;
+
+    case MODE_GENERATORS:
+        DAC_Triangle_Start(DAC_CHANNEL_1, 0, 12); // 0..4095..0, 8190 triggers = 15.6 Hz
+        DAC_Noise_Start(DAC_CHANNEL_2, 1536, 10); // 1536 + 0..1023
+        break;
+
+    default:
+        break;
+    }
+}
+
+void Button_Pressed(uint8_t Line)
+{
+    (void)Line;
+    requested_mode = (uint8_t)((requested_mode + 1U) % MODE_COUNT);
+}
+
+int main(void)
+{
+    uint8_t mode = MODE_QUADRATURE;
+
+    NVIC_Init();
+
+    DAC_Init(DAC_CHANNEL_1);
+    DAC_Init(DAC_CHANNEL_2);
+    Mode_Apply(MODE_QUADRATURE);
+    DAC_Trigger_TIM6_Init(HSI_CLK, SAMPLE_RATE);
+
+    EXTI_Init(EXTI_PORT_C, BUTTON_PC13, EXTI_EDGE_FALLING, Button_Pressed);
+
+    while (1)
+    {
+        __asm volatile("wfi"); // the waveforms need no CPU: only the button wakes the core
+
+        if (requested_mode != mode)
+        {
+            mode = requested_mode;
+            Mode_Apply((WAVE_MODE)mode);
+        }
+    }
+}
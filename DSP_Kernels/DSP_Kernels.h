@@ -0,0 +1,472 @@
+// Fixed-point signal kernels using the Cortex-M4 DSP extension (SMLAD, SMLALD, SADD16, QADD16, QADD, SSAT, SEL, PKHBT)
+// Samples are Q15 (int16_t). Two samples travel per 32-bit load/store and per DSP instruction.
+// Without __ARM_FEATURE_DSP (host PC, Cortex-M0/M3) every instruction falls back to portable C with identical results.
+
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*-------------------------------------------Instructions--------------------------------------------------
+  Packed word = two Q15 samples, low half = the sample at the lower address (little endian).
+----------------------------------------------------------------------------------------------------------*/
+
+#if defined(__ARM_FEATURE_DSP)
+
+// acc + x.lo * y.lo + x.hi * y.hi
+static inline int32_t DSP_SMLAD(uint32_t X, uint32_t Y, int32_t Acc)
+{
+    int32_t result;
+
+    __asm("smlad %0, %1, %2, %3" : "=r"(result) : "r"(X), "r"(Y), "r"(Acc));
+    return result;
+}
+
+// Same with a 64-bit accumulator (no overflow for any realistic filter length)
+static inline int64_t DSP_SMLALD(uint32_t X, uint32_t Y, int64_t Acc)
+{
+    uint32_t lo = (uint32_t)Acc;
+    uint32_t hi = (uint32_t)((uint64_t)Acc >> 32);
+
+    __asm("smlald %0, %1, %2, %3" : "+r"(lo), "+r"(hi) : "r"(X), "r"(Y));
+    return (int64_t)(((uint64_t)hi << 32) | lo);
+}
+
+static inline uint32_t DSP_SADD16(uint32_t X, uint32_t Y)
+{
+    uint32_t result;
+
+    __asm("sadd16 %0, %1, %2" : "=r"(result) : "r"(X), "r"(Y) : "cc");
+    return result;
+}
+
+// Saturating packed add / subtract: each half clamps to -32768..32767
+static inline uint32_t DSP_QADD16(uint32_t X, uint32_t Y)
+{
+    uint32_t result;
+
+    __asm("qadd16 %0, %1, %2" : "=r"(result) : "r"(X), "r"(Y));
+    return result;
+}
+
+static inline uint32_t DSP_QSUB16(uint32_t X, uint32_t Y)
+{
+    uint32_t result;
+
+    __asm("qsub16 %0, %1, %2" : "=r"(result) : "r"(X), "r"(Y));
+    return result;
+}
+
+// Saturating 32-bit add
+static inline int32_t DSP_QADD(int32_t X, int32_t Y)
+{
+    int32_t result;
+
+    __asm("qadd %0, %1, %2" : "=r"(result) : "r"(X), "r"(Y) : "cc");
+    return result;
+}
+
+// Clamp to the Q15 range
+static inline int32_t DSP_SSAT16(int32_t X)
+{
+    int32_t result;
+
+    __asm("ssat %0, #16, %1" : "=r"(result) : "r"(X) : "cc");
+    return result;
+}
+
+// Low half from Lo, high half from Hi (PKHBT with LSL #16)
+static inline uint32_t DSP_PACK(int32_t Lo, int32_t Hi)
+{
+    uint32_t result;
+
+    __asm("pkhbt %0, %1, %2, lsl #16" : "=r"(result) : "r"(Lo), "r"(Hi));
+    return result;
+}
+
+// Per-half max / min: SSUB16 sets GE per half, SEL picks per half. Kept in one asm block (flags).
+static inline uint32_t DSP_MAX16(uint32_t X, uint32_t Y)
+{
+    uint32_t result;
+
+    __asm("ssub16 %0, %1, %2\n\tsel %0, %1, %2" : "=&r"(result) : "r"(X), "r"(Y) : "cc");
+    return result;
+}
+
+static inline uint32_t DSP_MIN16(uint32_t X, uint32_t Y)
+{
+    uint32_t result;
+
+    __asm("ssub16 %0, %1, %2\n\tsel %0, %2, %1" : "=&r"(result) : "r"(X), "r"(Y) : "cc");
+    return result;
+}
+
+#else // portable fallbacks
+
+#define DSP_LO(x) ((int32_t)(int16_t)((x) & 0xFFFFU))
+#define DSP_HI(x) ((int32_t)(int16_t)((x) >> 16))
+
+static inline int32_t DSP_SSAT16(int32_t X)
+{
+    return (X > 32767) ? 32767 : ((X < -32768) ? -32768 : X);
+}
+
+static inline uint32_t DSP_PACK(int32_t Lo, int32_t Hi)
+{
+    return ((uint32_t)Lo & 0xFFFFU) | ((uint32_t)Hi << 16);
+}
+
+static inline int32_t DSP_SMLAD(uint32_t X, uint32_t Y, int32_t Acc)
+{
+    return (int32_t)((uint32_t)Acc + (uint32_t)(DSP_LO(X) * DSP_LO(Y)) + (uint32_t)(DSP_HI(X) * DSP_HI(Y)));
+}
+
+static inline int64_t DSP_SMLALD(uint32_t X, uint32_t Y, int64_t Acc)
+{
+    return Acc + ((int64_t)DSP_LO(X) * DSP_LO(Y)) + ((int64_t)DSP_HI(X) * DSP_HI(Y));
+}
+
+static inline uint32_t DSP_SADD16(uint32_t X, uint32_t Y)
+{
+    return DSP_PACK(DSP_LO(X) + DSP_LO(Y), DSP_HI(X) + DSP_HI(Y));
+}
+
+static inline uint32_t DSP_QADD16(uint32_t X, uint32_t Y)
+{
+    return DSP_PACK(DSP_SSAT16(DSP_LO(X) + DSP_LO(Y)), DSP_SSAT16(DSP_HI(X) + DSP_HI(Y)));
+}
+
+static inline uint32_t DSP_QSUB16(uint32_t X, uint32_t Y)
+{
+    return DSP_PACK(DSP_SSAT16(DSP_LO(X) - DSP_LO(Y)), DSP_SSAT16(DSP_HI(X) - DSP_HI(Y)));
+}
+
+static inline int32_t DSP_QADD(int32_t X, int32_t Y)
+{
+    int64_t sum = (int64_t)X + Y;
+
+    return (sum > INT32_MAX) ? INT32_MAX : ((sum < INT32_MIN) ? INT32_MIN : (int32_t)sum);
+}
+
+static inline uint32_t DSP_MAX16(uint32_t X, uint32_t Y)
+{
+    return DSP_PACK((DSP_LO(X) >= DSP_LO(Y)) ? DSP_LO(X) : DSP_LO(Y), (DSP_HI(X) >= DSP_HI(Y)) ? DSP_HI(X) : DSP_HI(Y));
+}
+
+static inline uint32_t DSP_MIN16(uint32_t X, uint32_t Y)
+{
+    return DSP_PACK((DSP_LO(X) >= DSP_LO(Y)) ? DSP_LO(Y) : DSP_LO(X), (DSP_HI(X) >= DSP_HI(Y)) ? DSP_HI(Y) : DSP_HI(X));
+}
+
+#endif
+
+/*-------------------------------------------Packed access------------------------------------------------*/
+
+// Two samples from any (also odd) address: one LDR on Cortex-M4, which allows unaligned word loads
+static inline uint32_t DSP_Read_Pair(const int16_t *P)
+{
+    uint32_t word;
+
+    memcpy(&word, P, sizeof(word));
+    return word;
+}
+
+static inline void DSP_Write_Pair(int16_t *P, uint32_t Word)
+{
+    memcpy(P, &Word, sizeof(Word));
+}
+
+static inline int32_t DSP_Pair_Lo(uint32_t Word)
+{
+    return (int32_t)(int16_t)(Word & 0xFFFFU);
+}
+
+static inline int32_t DSP_Pair_Hi(uint32_t Word)
+{
+    return (int32_t)Word >> 16;
+}
+
+/*-------------------------------------------Packed block operations----------------------------------------*/
+
+// Out = saturate(A + B), two samples per QADD16. Length even.
+void DSP_Add_q15(const int16_t *A, const int16_t *B, int16_t *Out, uint16_t Length)
+{
+    for (uint16_t i = 0; i < Length; i += 2U)
+    {
+        DSP_Write_Pair(&Out[i], DSP_QADD16(DSP_Read_Pair(&A[i]), DSP_Read_Pair(&B[i])));
+    }
+}
+
+// Out = saturate(A - B). Length even.
+void DSP_Sub_q15(const int16_t *A, const int16_t *B, int16_t *Out, uint16_t Length)
+{
+    for (uint16_t i = 0; i < Length; i += 2U)
+    {
+        DSP_Write_Pair(&Out[i], DSP_QSUB16(DSP_Read_Pair(&A[i]), DSP_Read_Pair(&B[i])));
+    }
+}
+
+// Out = saturate(In * Gain), Gain in Q15 (32767 = 1.0). Length even.
+void DSP_Scale_q15(const int16_t *In, int16_t *Out, int16_t Gain, uint16_t Length)
+{
+    for (uint16_t i = 0; i < Length; i += 2U)
+    {
+        uint32_t pair = DSP_Read_Pair(&In[i]);
+        int32_t lo = DSP_SSAT16((DSP_Pair_Lo(pair) * Gain) >> 15);
+        int32_t hi = DSP_SSAT16((DSP_Pair_Hi(pair) * Gain) >> 15);
+
+        DSP_Write_Pair(&Out[i], DSP_PACK(lo, hi));
+    }
+}
+
+// 12-bit right-aligned ADC codes (0..4095) to Q15 around mid-scale: (code << 4) - 32768.
+// Shift first (no carry between halves since code << 4 < 65536), then flip both sign bits.
+void DSP_ADC12_To_q15(const uint16_t *In, int16_t *Out, uint16_t Length)
+{
+    for (uint16_t i = 0; i < Length; i += 2U)
+    {
+        uint32_t pair;
+
+        memcpy(&pair, &In[i], sizeof(pair));
+        DSP_Write_Pair(&Out[i], (pair << 4) ^ 0x80008000UL);
+    }
+}
+
+// Saturating sum of Q31 values (QADD); e.g. accumulating block energies without wrap-around
+int32_t DSP_Sum_q31(const int32_t *In, uint16_t Length)
+{
+    int32_t sum = 0;
+
+    for (uint16_t i = 0; i < Length; i++)
+    {
+        sum = DSP_QADD(sum, In[i]);
+    }
+
+    return sum;
+}
+
+/*-------------------------------------------Block statistics-----------------------------------------------*/
+
+// Min and max with two lanes per SSUB16 + SEL, lanes combined at the end. Length even, >= 2.
+void DSP_Min_Max_q15(const int16_t *In, uint16_t Length, int16_t *Min, int16_t *Max)
+{
+    uint32_t lo = DSP_Read_Pair(&In[0]);
+    uint32_t hi = lo;
+
+    for (uint16_t i = 2; i < Length; i += 2U)
+    {
+        uint32_t pair = DSP_Read_Pair(&In[i]);
+
+        lo = DSP_MIN16(lo, pair);
+        hi = DSP_MAX16(hi, pair);
+    }
+
+    *Min = (int16_t)((DSP_Pair_Lo(lo) < DSP_Pair_Hi(lo)) ? DSP_Pair_Lo(lo) : DSP_Pair_Hi(lo));
+    *Max = (int16_t)((DSP_Pair_Lo(hi) > DSP_Pair_Hi(hi)) ? DSP_Pair_Lo(hi) : DSP_Pair_Hi(hi));
+}
+
+// Integer square root (bit by bit, 16 iterations, no division)
+uint32_t DSP_Sqrt_u32(uint32_t X)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > X)
+    {
+        bit >>= 2;
+    }
+
+    while (bit)
+    {
+        if (X >= root + bit)
+        {
+            X -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+// RMS in Q15: sum of squares with one SMLALD per two samples, one division per block. Length even.
+int16_t DSP_RMS_q15(const int16_t *In, uint16_t Length)
+{
+    int64_t sum = 0;
+
+    for (uint16_t i = 0; i < Length; i += 2U)
+    {
+        uint32_t pair = DSP_Read_Pair(&In[i]);
+
+        sum = DSP_SMLALD(pair, pair, sum);
+    }
+
+    return (int16_t)DSP_SSAT16((int32_t)DSP_Sqrt_u32((uint32_t)((uint64_t)sum / Length)));
+}
+
+/*-------------------------------------------Moving average--------------------------------------------------
+  Boxcar over 2^Shift samples with a running sum: one add and one subtract per sample, any window length.
+  History holds 2^Shift samples as 2^(Shift-1) packed words (Shift >= 1).
+----------------------------------------------------------------------------------------------------------*/
+
+typedef struct DSP_MovAvg_t
+{
+    uint32_t *history;
+    uint16_t index; // word index
+    uint16_t mask;
+    uint8_t shift;
+    int32_t sum;
+} DSP_MovAvg_t;
+
+void DSP_MovAvg_Init(DSP_MovAvg_t *Avg, uint32_t *History, uint8_t Shift)
+{
+    Avg->history = History;
+    Avg->index = 0;
+    Avg->mask = (uint16_t)((1U << (Shift - 1U)) - 1U);
+    Avg->shift = Shift;
+    Avg->sum = 0;
+    memset(History, 0, sizeof(uint32_t) << (Shift - 1U));
+}
+
+// Two samples per iteration: one word load for the input, one for the leaving pair, one packed store
+void DSP_MovAvg_q15(DSP_MovAvg_t *Avg, const int16_t *In, int16_t *Out, uint16_t Length)
+{
+    int32_t sum = Avg->sum;
+    uint32_t index = Avg->index;
+
+    for (uint16_t i = 0; i < Length; i += 2U)
+    {
+        uint32_t in = DSP_Read_Pair(&In[i]);
+        uint32_t old = Avg->history[index];
+        int32_t y0;
+        int32_t y1;
+
+        Avg->history[index] = in;
+        index = (index + 1U) & Avg->mask;
+
+        sum += DSP_Pair_Lo(in) - DSP_Pair_Lo(old);
+        y0 = sum >> Avg->shift;
+        sum += DSP_Pair_Hi(in) - DSP_Pair_Hi(old);
+        y1 = sum >> Avg->shift;
+
+        DSP_Write_Pair(&Out[i], DSP_PACK(y0, y1));
+    }
+
+    Avg->sum = sum;
+    Avg->index = (uint16_t)index;
+}
+
+/*-------------------------------------------FIR--------------------------------------------------------------
+  y[n] = sum h[k] * x[n - k]. Coefficients are stored time-reversed (h[Taps-1] first) so that samples and
+  coefficients are both read upwards in pairs; symmetric (linear-phase) filters are unaffected.
+  State must hold Taps - 1 + Max_Block samples.
+----------------------------------------------------------------------------------------------------------*/
+
+typedef struct DSP_FIR_t
+{
+    const int16_t *coeffs; // Q15, time-reversed, Taps even (pad with a zero)
+    int16_t *state;
+    uint16_t taps;
+} DSP_FIR_t;
+
+void DSP_FIR_Init(DSP_FIR_t *Fir, const int16_t *Coeffs, uint16_t Taps, int16_t *State)
+{
+    Fir->coeffs = Coeffs;
+    Fir->taps = Taps;
+    Fir->state = State;
+    memset(State, 0, sizeof(int16_t) * (Taps - 1U));
+}
+
+// Two taps per SMLALD; Length <= Max_Block
+void DSP_FIR_q15(DSP_FIR_t *Fir, const int16_t *In, int16_t *Out, uint16_t Length)
+{
+    int16_t *state = Fir->state;
+    uint16_t taps = Fir->taps;
+
+    memcpy(&state[taps - 1U], In, sizeof(int16_t) * Length);
+
+    for (uint16_t n = 0; n < Length; n++)
+    {
+        const int16_t *x = &state[n];
+        int64_t acc = 0;
+
+        for (uint16_t k = 0; k < taps; k += 2U)
+        {
+            acc = DSP_SMLALD(DSP_Read_Pair(&x[k]), DSP_Read_Pair(&Fir->coeffs[k]), acc);
+        }
+
+        Out[n] = (int16_t)DSP_SSAT16((int32_t)((acc + (1 << 14)) >> 15));
+    }
+
+    memmove(state, &state[Length], sizeof(int16_t) * (taps - 1U));
+}
+
+/*-------------------------------------------Biquad IIR (direct form I, cascade)-----------------------------
+  Per stage: y = b0 x + b1 x1 + b2 x2 + a1 y1 + a2 y2, coefficients in Q14 (range -2..2) with a1 / a2
+  already negated compared with the usual 1 + a1 z^-1 + a2 z^-2 notation.
+  Coeffs per stage: {b0, b1, b2, a1, a2, 0} (six entries so every stage starts on a word).
+----------------------------------------------------------------------------------------------------------*/
+
+typedef struct DSP_Biquad_State_t
+{
+    uint32_t x; // x[n-1] low, x[n-2] high
+    uint32_t y; // y[n-1] low, y[n-2] high
+} DSP_Biquad_State_t;
+
+typedef struct DSP_Biquad_t
+{
+    const int16_t *coeffs;
+    DSP_Biquad_State_t *state;
+    uint8_t stages;
+} DSP_Biquad_t;
+
+void DSP_Biquad_Init(DSP_Biquad_t *Iir, const int16_t *Coeffs, DSP_Biquad_State_t *State, uint8_t Stages)
+{
+    Iir->coeffs = Coeffs;
+    Iir->state = State;
+    Iir->stages = Stages;
+    memset(State, 0, sizeof(DSP_Biquad_State_t) * Stages);
+}
+
+// In and Out may be the same buffer. Per sample and stage: one multiply, two SMLALD, SSAT, two PKHBT.
+void DSP_Biquad_q15(DSP_Biquad_t *Iir, const int16_t *In, int16_t *Out, uint16_t Length)
+{
+    const int16_t *src = In;
+
+    for (uint8_t s = 0; s < Iir->stages; s++)
+    {
+        const int16_t *c = &Iir->coeffs[6U * s];
+        int32_t b0 = c[0];
+        uint32_t b12 = DSP_Read_Pair(&c[1]);
+        uint32_t a12 = DSP_Read_Pair(&c[3]);
+        uint32_t x12 = Iir->state[s].x;
+        uint32_t y12 = Iir->state[s].y;
+
+        for (uint16_t n = 0; n < Length; n++)
+        {
+            int32_t x0 = src[n];
+            int64_t acc = (int64_t)b0 * x0;
+            int32_t y0;
+
+            acc = DSP_SMLALD(b12, x12, acc);
+            acc = DSP_SMLALD(a12, y12, acc);
+            y0 = DSP_SSAT16((int32_t)((acc + (1 << 13)) >> 14));
+
+            x12 = DSP_PACK(x0, (int32_t)x12); // new x[n-1] = x0, x[n-2] = old x[n-1]
+            y12 = DSP_PACK(y0, (int32_t)y12);
+            Out[n] = (int16_t)y0;
+        }
+
+        Iir->state[s].x = x12;
+        Iir->state[s].y = y12;
+        src = Out; // next stage filters the output of this one in place
+    }
+}
+
+#endif
@@ -0,0 +1,367 @@
+// DSP-instruction kernels against plain C on one 64-sample block, timed with DWT CYCCNT (STM32F411 / F446)
+// Same file on the host (gcc -O2 DSP_Kernels_Benchmark.c) runs the portable fallbacks and checks the results match.
+
+#include <stdint.h>
+#include "DSP_Kernels.h"
+
+#if defined(__arm__)
+
+#define RCC_AHB1ENR (*(volatile uint32_t *)(0x40023800UL + 0x30))
+#define GPIOA_MODER (*(volatile uint32_t *)(0x40020000UL + 0x00))
+#define GPIOA_BSRR (*(volatile uint32_t *)(0x40020000UL + 0x18))
+
+#define DEMCR (*(volatile uint32_t *)(0xE000EDFCUL))
+#define DWT_CTRL (*(volatile uint32_t *)(0xE0001000UL))
+#define DWT_CYCCNT (*(volatile uint32_t *)(0xE0001004UL))
+
+#define BENCH_NOW() (DWT_CYCCNT)
+
+#define LED_PA5 5
+
+#else
+
+#include <stdio.h>
+#define BENCH_NOW() 0U // cycle counts are only meaningful on the target
+
+#endif
+
+#define BLOCK 64U
+#define FIR_TAPS 16U
+#define AVG_SHIFT 3U // 8-sample window
+#define BIQUAD_STAGES 2U
+
+/*-------------------------------------------Test data-----------------------------------------------------*/
+
+// 16-tap Hamming-windowed low-pass, cutoff 0.1 fs, symmetric so time reversal changes nothing
+const int16_t Fir_Coeffs[FIR_TAPS] =
+{
+    -114, -159, -139, 291, 1450, 3284, 5246, 6524, 6524, 5246, 3284, 1450, 291, -139, -159, -114
+};
+
+// 4th-order Butterworth low-pass at 0.05 fs as two Q14 stages {b0, b1, b2, -a1, -a2, 0}
+const int16_t Biquad_Coeffs[6U * BIQUAD_STAGES] =
+{
+    312, 624, 312, 24243, -9107, 0,
+    359, 717, 359, 27869, -12919, 0,
+};
+
+uint16_t Adc_Block[BLOCK]; // 12-bit codes as delivered by the ADC DMA driver
+int16_t Signal[BLOCK];
+int16_t Offset[BLOCK];
+int16_t Out_Dsp[BLOCK];
+int16_t Out_C[BLOCK];
+
+uint32_t Avg_History[1U << (AVG_SHIFT - 1U)];
+int16_t Avg_History_C[1U << AVG_SHIFT];
+int16_t Fir_State[FIR_TAPS - 1U + BLOCK];
+int16_t Fir_State_C[FIR_TAPS - 1U + BLOCK];
+DSP_Biquad_State_t Biquad_State[BIQUAD_STAGES];
+int32_t Biquad_State_C[BIQUAD_STAGES][4];
+
+typedef struct Bench_Result_t
+{
+    const char *name;
+    uint32_t cycles_dsp;
+    uint32_t cycles_c;
+    uint8_t match;
+} Bench_Result_t;
+
+Bench_Result_t Bench_Results[8];
+uint8_t Bench_Count = 0;
+
+void Make_Test_Block(void)
+{
+    uint32_t seed = 12345;
+
+    for (uint16_t i = 0; i < BLOCK; i++)
+    {
+        seed = (seed * 1664525UL) + 1013904223UL;
+        Adc_Block[i] = (uint16_t)(((i * 64U) + (seed >> 26)) & 0xFFFU); // ramp + 6-bit noise
+        Offset[i] = (int16_t)((int32_t)(seed >> 16) - 32768);
+    }
+}
+
+/*-------------------------------------------Plain C references--------------------------------------------*/
+
+void Ref_ADC12_To_q15(const uint16_t *In, int16_t *Out, uint16_t Length)
+{
+    for (uint16_t i = 0; i < Length; i++)
+    {
+        Out[i] = (int16_t)(((int32_t)In[i] - 2048) * 16);
+    }
+}
+
+void Ref_Add_q15(const int16_t *A, const int16_t *B, int16_t *Out, uint16_t Length)
+{
+    for (uint16_t i = 0; i < Length; i++)
+    {
+        int32_t sum = (int32_t)A[i] + B[i];
+        Out[i] = (int16_t)((sum > 32767) ? 32767 : ((sum < -32768) ? -32768 : sum));
+    }
+}
+
+void Ref_Scale_q15(const int16_t *In, int16_t *Out, int16_t Gain, uint16_t Length)
+{
+    for (uint16_t i = 0; i < Length; i++)
+    {
+        int32_t y = ((int32_t)In[i] * Gain) >> 15;
+        Out[i] = (int16_t)((y > 32767) ? 32767 : ((y < -32768) ? -32768 : y));
+    }
+}
+
+void Ref_MovAvg_q15(const int16_t *In, int16_t *Out, uint16_t Length)
+{
+    static int32_t sum = 0;
+    static uint16_t index = 0;
+
+    for (uint16_t i = 0; i < Length; i++)
+    {
+        sum += In[i] - Avg_History_C[index];
+        Avg_History_C[index] = In[i];
+        index = (uint16_t)((index + 1U) & ((1U << AVG_SHIFT) - 1U));
+        Out[i] = (int16_t)(sum >> AVG_SHIFT);
+    }
+}
+
+void Ref_FIR_q15(const int16_t *In, int16_t *Out, uint16_t Length)
+{
+    for (uint16_t i = 0; i < Length; i++)
+    {
+        Fir_State_C[FIR_TAPS - 1U + i] = In[i];
+    }
+
+    for (uint16_t n = 0; n < Length; n++)
+    {
+        int64_t acc = 0;
+
+        for (uint16_t k = 0; k < FIR_TAPS; k++)
+        {
+            acc += (int32_t)Fir_Coeffs[FIR_TAPS - 1U - k] * Fir_State_C[n + FIR_TAPS - 1U - k];
+        }
+
+        acc = (acc + (1 << 14)) >> 15;
+        Out[n] = (int16_t)((acc > 32767) ? 32767 : ((acc < -32768) ? -32768 : acc));
+    }
+
+    for (uint16_t i = 0; i < FIR_TAPS - 1U; i++)
+    {
+        Fir_State_C[i] = Fir_State_C[Length + i];
+    }
+}
+
+void Ref_Biquad_q15(const int16_t *In, int16_t *Out, uint16_t Length)
+{
+    const int16_t *src = In;
+
+    for (uint8_t s = 0; s < BIQUAD_STAGES; s++)
+    {
+        const int16_t *c = &Biquad_Coeffs[6U * s];
+        int32_t *st = Biquad_State_C[s]; // x1, x2, y1, y2
+
+        for (uint16_t n = 0; n < Length; n++)
+        {
+            int64_t acc = (int64_t)c[0] * src[n] + (int64_t)c[1] * st[0] + (int64_t)c[2] * st[1] +
+                          (int64_t)c[3] * st[2] + (int64_t)c[4] * st[3];
+            int64_t y = (acc + (1 << 13)) >> 14;
+
+            y = (y > 32767) ? 32767 : ((y < -32768) ? -32768 : y);
+            st[1] = st[0];
+            st[0] = src[n];
+            st[3] = st[2];
+            st[2] = (int32_t)y;
+            Out[n] = (int16_t)y;
+        }
+
+        src = Out;
+    }
+}
+
+void Ref_Min_Max_q15(const int16_t *In, uint16_t Length, int16_t *Min, int16_t *Max)
+{
+    *Min = In[0];
+    *Max = In[0];
+
+    for (uint16_t i = 1; i < Length; i++)
+    {
+        if (In[i] < *Min)
+        {
+            *Min = In[i];
+        }
+
+        if (In[i] > *Max)
+        {
+            *Max = In[i];
+        }
+    }
+}
+
+int16_t Ref_RMS_q15(const int16_t *In, uint16_t Length)
+{
+    uint64_t sum = 0;
+
+    for (uint16_t i = 0; i < Length; i++)
+    {
+        sum += (uint64_t)((int32_t)In[i] * In[i]);
+    }
+
+    return (int16_t)DSP_Sqrt_u32((uint32_t)(sum / Length));
+}
+
+/*-------------------------------------------Runner---------------------------------------------------------*/
+
+uint8_t Same(const int16_t *A, const int16_t *B, uint16_t Length)
+{
+    for (uint16_t i = 0; i < Length; i++)
+    {
+        if (A[i] != B[i])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void Record(const char *Name, uint32_t Cycles_Dsp, uint32_t Cycles_C, uint8_t Match)
+{
+    Bench_Results[Bench_Count].name = Name;
+    Bench_Results[Bench_Count].cycles_dsp = Cycles_Dsp;
+    Bench_Results[Bench_Count].cycles_c = Cycles_C;
+    Bench_Results[Bench_Count].match = Match;
+    Bench_Count++;
+}
+
+// Times one call; the block is processed several times so the stateful kernels also compare their state
+#define BENCH(result, call)         \
+    do                              \
+    {                               \
+        uint32_t t0 = BENCH_NOW();  \
+        call;                       \
+        result = BENCH_NOW() - t0;  \
+    } while (0)
+
+uint8_t Run_Benchmarks(void)
+{
+    DSP_MovAvg_t avg;
+    DSP_FIR_t fir;
+    DSP_Biquad_t iir;
+    uint32_t dsp;
+    uint32_t c;
+    int16_t min_d, max_d, min_c, max_c, rms_d, rms_c;
+    uint8_t all = 1;
+
+    Make_Test_Block();
+
+    BENCH(dsp, DSP_ADC12_To_q15(Adc_Block, Out_Dsp, BLOCK));
+    BENCH(c, Ref_ADC12_To_q15(Adc_Block, Out_C, BLOCK));
+    Record("ADC12 -> Q15", dsp, c, Same(Out_Dsp, Out_C, BLOCK));
+
+    for (uint16_t i = 0; i < BLOCK; i++)
+    {
+        Signal[i] = Out_C[i];
+    }
+
+    BENCH(dsp, DSP_Add_q15(Signal, Offset, Out_Dsp, BLOCK));
+    BENCH(c, Ref_Add_q15(Signal, Offset, Out_C, BLOCK));
+    Record("add (saturating)", dsp, c, Same(Out_Dsp, Out_C, BLOCK));
+
+    BENCH(dsp, DSP_Scale_q15(Signal, Out_Dsp, 23170, BLOCK));
+    BENCH(c, Ref_Scale_q15(Signal, Out_C, 23170, BLOCK));
+    Record("scale", dsp, c, Same(Out_Dsp, Out_C, BLOCK));
+
+    DSP_MovAvg_Init(&avg, Avg_History, AVG_SHIFT);
+    DSP_FIR_Init(&fir, Fir_Coeffs, FIR_TAPS, Fir_State);
+    DSP_Biquad_Init(&iir, Biquad_Coeffs, Biquad_State, BIQUAD_STAGES);
+
+    for (uint8_t pass = 0; pass < 3U; pass++)
+    {
+        uint8_t ok;
+
+        BENCH(dsp, DSP_MovAvg_q15(&avg, Signal, Out_Dsp, BLOCK));
+        BENCH(c, Ref_MovAvg_q15(Signal, Out_C, BLOCK));
+        ok = Same(Out_Dsp, Out_C, BLOCK);
+
+        if (pass == 2U)
+        {
+            Record("moving average 8", dsp, c, ok);
+        }
+
+        all &= ok;
+
+        BENCH(dsp, DSP_FIR_q15(&fir, Signal, Out_Dsp, BLOCK));
+        BENCH(c, Ref_FIR_q15(Signal, Out_C, BLOCK));
+        ok = Same(Out_Dsp, Out_C, BLOCK);
+
+        if (pass == 2U)
+        {
+            Record("FIR 16 taps", dsp, c, ok);
+        }
+
+        all &= ok;
+
+        BENCH(dsp, DSP_Biquad_q15(&iir, Signal, Out_Dsp, BLOCK));
+        BENCH(c, Ref_Biquad_q15(Signal, Out_C, BLOCK));
+        ok = Same(Out_Dsp, Out_C, BLOCK);
+
+        if (pass == 2U)
+        {
+            Record("biquad x2", dsp, c, ok);
+        }
+
+        all &= ok;
+    }
+
+    BENCH(dsp, DSP_Min_Max_q15(Signal, BLOCK, &min_d, &max_d));
+    BENCH(c, Ref_Min_Max_q15(Signal, BLOCK, &min_c, &max_c));
+    Record("min / max", dsp, c, (uint8_t)((min_d == min_c) && (max_d == max_c)));
+
+    BENCH(dsp, rms_d = DSP_RMS_q15(Signal, BLOCK));
+    BENCH(c, rms_c = Ref_RMS_q15(Signal, BLOCK));
+    Record("RMS", dsp, c, (uint8_t)(rms_d == rms_c));
+
+    for (uint8_t i = 0; i < Bench_Count; i++)
+    {
+        all &= Bench_Results[i].match;
+    }
+
+    return all;
+}
+
+#if defined(__arm__)
+
+int main(void)
+{
+    RCC_AHB1ENR |= (1 << 0);
+    GPIOA_MODER &= ~(3U << (LED_PA5 * 2));
+    GPIOA_MODER |= (1U << (LED_PA5 * 2));
+
+    DEMCR |= (1UL << 24);
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= (1UL << 0);
+
+    // LED on = every DSP kernel matches its plain C reference; cycle counts in Bench_Results[]
+    if (Run_Benchmarks())
+    {
+        GPIOA_BSRR = 1U << LED_PA5;
+    }
+
+    while (1)
+    {
+    }
+}
+
+#else
+
+int main(void)
+{
+    uint8_t all = Run_Benchmarks();
+
+    for (uint8_t i = 0; i < Bench_Count; i++)
+    {
+        printf("%-18s %s\n", Bench_Results[i].name, Bench_Results[i].match ? "match" : "MISMATCH");
+    }
+
+    return all ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,305 @@
+// ADC1 scan driver with timer trigger and DMA double buffering for STM32F411x / STM32F446xx
+// TIM2 TRGO starts one scan of up to 16 channels; DMA2 Stream0 fills a circular buffer split in two halves,
+// each half is handed to a callback while the DMA fills the other one. Averaging / oversampling in fixed point.
+
+#ifndef ADC_DMA_DRIVER_STM32F4XX_H
+#define ADC_DMA_DRIVER_STM32F4XX_H
+
+#include <stdint.h>
+#include "DMA_Driver_STM32F4xx.h"
+
+/*-------------------------------------------GPIO (analog pins)-------------------------------------------*/
+
+#define GPIOA_BASE 0x40020000UL
+#define GPIOB_BASE 0x40020400UL
+#define GPIOC_BASE 0x40020800UL
+#define GPIOA_MODER (*(volatile uint32_t *)(GPIOA_BASE + 0x00))
+#define GPIOB_MODER (*(volatile uint32_t *)(GPIOB_BASE + 0x00))
+#define GPIOC_MODER (*(volatile uint32_t *)(GPIOC_BASE + 0x00))
+
+/*-------------------------------------------TIM2 (trigger)-----------------------------------------------*/
+
+#define TIM2_BASE 0x40000000UL
+#define TIM2_CR1 (*(volatile uint32_t *)(TIM2_BASE + 0x00))
+#define TIM2_CR2 (*(volatile uint32_t *)(TIM2_BASE + 0x04))
+#define TIM2_EGR (*(volatile uint32_t *)(TIM2_BASE + 0x14))
+#define TIM2_CNT (*(volatile uint32_t *)(TIM2_BASE + 0x24))
+#define TIM2_PSC (*(volatile uint32_t *)(TIM2_BASE + 0x28))
+#define TIM2_ARR (*(volatile uint32_t *)(TIM2_BASE + 0x2C))
+
+#define TIM_CR2_MMS_UPDATE (2U << 4) // TRGO = update event
+
+/*-------------------------------------------ADC1---------------------------------------------------------*/
+
+#define ADC1_BASE 0x40012000UL
+#define ADC1_SR (*(volatile uint32_t *)(ADC1_BASE + 0x00))
+#define ADC1_CR1 (*(volatile uint32_t *)(ADC1_BASE + 0x04))
+#define ADC1_CR2 (*(volatile uint32_t *)(ADC1_BASE + 0x08))
+#define ADC1_SMPR1 (*(volatile uint32_t *)(ADC1_BASE + 0x0C)) // channels 10..18
+#define ADC1_SMPR2 (*(volatile uint32_t *)(ADC1_BASE + 0x10)) // channels 0..9
+#define ADC1_SQR(n) (*(volatile uint32_t *)(ADC1_BASE + 0x2C + (4U * (n)))) // n = 0..2 -> SQR1..SQR3
+#define ADC1_DR (*(volatile uint32_t *)(ADC1_BASE + 0x4C))
+#define ADC_CCR (*(volatile uint32_t *)(ADC1_BASE + 0x300 + 0x04))
+
+#define ADC_SR_OVR (1U << 5)
+#define ADC_CR1_SCAN (1U << 8)
+#define ADC_CR1_OVRIE (1U << 26)
+#define ADC_CR2_ADON (1U << 0)
+#define ADC_CR2_DMA (1U << 8)
+#define ADC_CR2_DDS (1U << 9)
+#define ADC_CR2_EXTSEL_TIM2_TRGO (6UL << 24)
+#define ADC_CR2_EXTEN_RISING (1UL << 28)
+#define ADC_CCR_ADCPRE_DIV2 (0U << 16) // ADCCLK = PCLK2 / 2 (max 36 MHz)
+
+#define ADC_IRQn 18U
+#define ADC_MAX_CHANNELS 16U
+
+// DMA request mapping: ADC1 -> DMA2 Stream0 channel 0
+#define ADC_DMA DMA_2
+#define ADC_DMA_STREAM 0U
+#define ADC_DMA_CHANNEL 0U
+
+// Sample time in ADC clocks; conversion time = sample + 12 ADC clocks
+typedef enum ADC_SAMPLE_TIME
+{
+    ADC_SAMPLE_3 = 0,
+    ADC_SAMPLE_15 = 1,
+    ADC_SAMPLE_28 = 2,
+    ADC_SAMPLE_56 = 3,
+    ADC_SAMPLE_84 = 4,
+    ADC_SAMPLE_112 = 5,
+    ADC_SAMPLE_144 = 6,
+    ADC_SAMPLE_480 = 7
+} ADC_SAMPLE_TIME;
+
+// Frames = Frame_Count scans of Channels samples each, channel-interleaved: Frames[f * Channels + i]
+typedef void (*ADC_Callback_t)(const uint16_t *Frames, uint16_t Frame_Count);
+
+typedef struct ADC_Scan_t
+{
+    uint16_t *buffer;
+    uint16_t half_size; // samples per half
+    uint16_t frames;    // frames per half
+    uint8_t channels;
+    ADC_Callback_t callback;
+    volatile uint32_t overruns;
+} ADC_Scan_t;
+
+static ADC_Scan_t ADC_Scan;
+
+/*-------------------------------------------Helpers------------------------------------------------------*/
+
+// Channel 0..7 = PA0..PA7, 8..9 = PB0..PB1, 10..15 = PC0..PC5 (16..18 are internal)
+void ADC_Pin_Analog(uint8_t Channel)
+{
+    if (Channel < 8U)
+    {
+        RCC_Clock_Ensure(RCC_CLK_GPIOA);
+        GPIOA_MODER |= (3UL << (2U * Channel));
+    }
+    else if (Channel < 10U)
+    {
+        RCC_Clock_Ensure(RCC_CLK_GPIOB);
+        GPIOB_MODER |= (3UL << (2U * (Channel - 8U)));
+    }
+    else if (Channel < 16U)
+    {
+        RCC_Clock_Ensure(RCC_CLK_GPIOC);
+        GPIOC_MODER |= (3UL << (2U * (Channel - 10U)));
+    }
+}
+
+void ADC_Set_Sample_Time(uint8_t Channel, ADC_SAMPLE_TIME Sample_Time)
+{
+    if (Channel < 10U)
+    {
+        ADC1_SMPR2 &= ~(7UL << (3U * Channel));
+        ADC1_SMPR2 |= ((uint32_t)Sample_Time << (3U * Channel));
+    }
+    else
+    {
+        ADC1_SMPR1 &= ~(7UL << (3U * (Channel - 10U)));
+        ADC1_SMPR1 |= ((uint32_t)Sample_Time << (3U * (Channel - 10U)));
+    }
+}
+
+// Rank r (0..15) -> SQR3 holds ranks 0..5, SQR2 6..11, SQR1 12..15, 5 bits each
+void ADC_Set_Sequence(const uint8_t *Channels, uint8_t Count)
+{
+    uint32_t sqr[3] = {((uint32_t)Count - 1U) << 20, 0, 0};
+
+    for (uint8_t rank = 0; rank < Count; rank++)
+    {
+        sqr[2U - (rank / 6U)] |= ((uint32_t)Channels[rank] << (5U * (rank % 6U)));
+    }
+
+    ADC1_SQR(0) = sqr[0];
+    ADC1_SQR(1) = sqr[1];
+    ADC1_SQR(2) = sqr[2];
+}
+
+/*-------------------------------------------DMA half / full----------------------------------------------*/
+
+void ADC_DMA_Callback(void *Context, uint8_t Flags)
+{
+    ADC_Scan_t *scan = (ADC_Scan_t *)Context;
+
+    // Both flags at once means the callback is late by half a buffer: deliver in order anyway
+    if (Flags & DMA_FLAG_HT)
+    {
+        scan->callback(&scan->buffer[0], scan->frames);
+    }
+
+    if (Flags & DMA_FLAG_TC)
+    {
+        scan->callback(&scan->buffer[scan->half_size], scan->frames);
+    }
+
+    if (Flags & DMA_FLAG_TE)
+    {
+        scan->overruns++;
+    }
+}
+
+// Overrun: a conversion finished before the DMA took the previous one. The sequence and the DMA
+// lose step, so both are restarted from rank 0 / buffer start (RM0383 13.8.2).
+void ADC_IRQHandler(void)
+{
+    if (ADC1_SR & ADC_SR_OVR)
+    {
+        ADC_Scan.overruns++;
+
+        ADC1_CR2 &= ~ADC_CR2_DMA;
+        DMA_Stream_Stop(ADC_DMA, ADC_DMA_STREAM);
+        ADC1_SR = ~ADC_SR_OVR;
+        DMA_Stream_Start(ADC_DMA, ADC_DMA_STREAM, ADC_Scan.buffer, (uint16_t)(2U * ADC_Scan.half_size));
+        ADC1_CR2 |= ADC_CR2_DMA;
+    }
+}
+
+/*-------------------------------------------Init---------------------------------------------------------*/
+
+// Buffer holds 2 * Frames_Per_Half * Count samples. Callback runs every Frames_Per_Half scans,
+// at DMA priority (NVIC_PREEMPT_DMA), and must finish before the other half is full.
+void ADC_Scan_Init(const uint8_t *Channels, uint8_t Count, ADC_SAMPLE_TIME Sample_Time, uint16_t *Buffer,
+                   uint16_t Frames_Per_Half, ADC_Callback_t Callback)
+{
+    if ((Count == 0U) || (Count > ADC_MAX_CHANNELS))
+    {
+        return;
+    }
+
+    RCC_Clock_Ensure(RCC_CLK_ADC1);
+
+    ADC1_CR2 = 0; // ADON off while configuring
+
+    for (uint8_t rank = 0; rank < Count; rank++)
+    {
+        ADC_Pin_Analog(Channels[rank]);
+        ADC_Set_Sample_Time(Channels[rank], Sample_Time);
+    }
+
+    ADC_Set_Sequence(Channels, Count);
+
+    ADC_Scan.buffer = Buffer;
+    ADC_Scan.channels = Count;
+    ADC_Scan.frames = Frames_Per_Half;
+    ADC_Scan.half_size = (uint16_t)(Frames_Per_Half * Count);
+    ADC_Scan.callback = Callback;
+    ADC_Scan.overruns = 0;
+
+    ADC_CCR = (ADC_CCR & ~(3UL << 16)) | ADC_CCR_ADCPRE_DIV2;
+    ADC1_CR1 = ADC_CR1_SCAN | ADC_CR1_OVRIE; // 12-bit, scan all ranks per trigger
+    ADC1_CR2 = ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_EXTSEL_TIM2_TRGO | ADC_CR2_EXTEN_RISING;
+
+    DMA_Stream_Init(ADC_DMA, ADC_DMA_STREAM,
+                    DMA_CR_CHSEL(ADC_DMA_CHANNEL) | DMA_CR_DIR_P2M | DMA_CR_MINC | DMA_CR_CIRC |
+                        DMA_CR_PSIZE_16 | DMA_CR_MSIZE_16 | DMA_CR_PL(3) | DMA_CR_HTIE | DMA_CR_TCIE | DMA_CR_TEIE,
+                    0, &ADC1_DR, ADC_DMA_Callback, &ADC_Scan, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+
+    DMA_Stream_Start(ADC_DMA, ADC_DMA_STREAM, Buffer, (uint16_t)(2U * ADC_Scan.half_size));
+
+    NVIC_Setup_IRQ(ADC_IRQn, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+
+    ADC1_CR2 |= ADC_CR2_ADON; // tSTAB (3 us) passes before the first trigger from the timer
+}
+
+// Same TIM2 setup as STM32_LED_Blinking_TM2_Polling.c (PSC, UG, CEN) plus MMS: every update
+// drives TRGO, which starts one scan. The timer runs without interrupts or software involvement.
+void ADC_Trigger_TIM2_Init(uint32_t Timer_Clock, uint32_t Scan_Rate_Hz)
+{
+    RCC_Clock_Ensure(RCC_CLK_TIM2); // a managed TIM2 user releasing its reference must not stop the trigger
+
+    TIM2_CR1 &= ~(1 << 0);
+    TIM2_PSC = 0;
+    TIM2_ARR = (Timer_Clock / Scan_Rate_Hz) - 1U;
+    TIM2_CR2 = (TIM2_CR2 & ~(7U << 4)) | TIM_CR2_MMS_UPDATE;
+    TIM2_CNT = 0;
+    TIM2_EGR |= (1 << 0);
+    TIM2_CR1 |= (1 << 0);
+}
+
+uint32_t ADC_Overruns(void)
+{
+    return ADC_Scan.overruns;
+}
+
+/*-------------------------------------------Fixed-point post-processing----------------------------------*/
+
+uint32_t ADC_Channel_Sum(const uint16_t *Frames, uint16_t Frame_Count, uint8_t Channels, uint8_t Index)
+{
+    uint32_t sum = 0;
+    const uint16_t *sample = &Frames[Index];
+
+    for (uint16_t f = 0; f < Frame_Count; f++)
+    {
+        sum += *sample;
+        sample += Channels;
+    }
+
+    return sum;
+}
+
+// Average of 2^Shift frames, rounded, still 12-bit
+uint16_t ADC_Channel_Average(const uint16_t *Frames, uint8_t Shift, uint8_t Channels, uint8_t Index)
+{
+    uint32_t sum = ADC_Channel_Sum(Frames, (uint16_t)(1U << Shift), Channels, Index);
+
+    return (uint16_t)((sum + ((1UL << Shift) >> 1)) >> Shift);
+}
+
+// Oversampling: 4^Extra_Bits frames summed and shifted right by Extra_Bits gives a (12 + Extra_Bits)-bit
+// result. Needs noise of about 1 LSB on the input; uses 4^Extra_Bits <= Frame_Count frames.
+uint16_t ADC_Channel_Oversample(const uint16_t *Frames, uint8_t Extra_Bits, uint8_t Channels, uint8_t Index)
+{
+    uint32_t sum = ADC_Channel_Sum(Frames, (uint16_t)(1U << (2U * Extra_Bits)), Channels, Index);
+
+    return (uint16_t)(sum >> Extra_Bits);
+}
+
+// First-order IIR (exponential average), state in Q16: y += (x - y) / 2^Shift
+typedef struct ADC_Filter_t
+{
+    int32_t state; // 12.16 fixed point
+    uint8_t shift;
+} ADC_Filter_t;
+
+void ADC_Filter_Init(ADC_Filter_t *Filter, uint8_t Shift, uint16_t Initial)
+{
+    Filter->shift = Shift;
+    Filter->state = (int32_t)Initial << 16;
+}
+
+uint16_t ADC_Filter_Update(ADC_Filter_t *Filter, uint16_t Sample)
+{
+    Filter->state += (((int32_t)Sample << 16) - Filter->state) >> Filter->shift;
+    return (uint16_t)((Filter->state + 0x8000) >> 16);
+}
+
+// 12-bit code to millivolts without division: mV = code * Vref_mV / 4096
+uint32_t ADC_To_Millivolts(uint16_t Code, uint32_t Vref_mV)
+{
+    return ((uint32_t)Code * Vref_mV + 2048U) >> 12;
+}
+
+#endif
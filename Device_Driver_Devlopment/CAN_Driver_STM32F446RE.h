@@ -0,0 +1,665 @@
+// bxCAN driver for STM32F446RE (CAN1 / CAN2; the F411 has no CAN)
+// Bit timing from the APB1 clock, an allocator that packs ID lists and masks into the 28 shared filter banks,
+// RX FIFO interrupts feeding lock-free rings, and TX through the three mailboxes in identifier priority with
+// a sorted software queue behind them. Loopback / silent modes run without a bus.
+
+#ifndef CAN_DRIVER_STM32F446RE_H
+#define CAN_DRIVER_STM32F446RE_H
+
+#include <stdint.h>
+#include "NVIC_Driver_STM32F4xx.h"
+#include "RCC_Clock_Manager_STM32F4xx.h"
+
+/*-------------------------------Bus clock (HSI, no prescaler)-----------------------------------------------*/
+
+#ifndef APB1_CLK
+#define APB1_CLK 16000000UL
+#endif
+
+/*-------------------------------------------GPIO (any port)------------------------------------------------*/
+
+#define GPIOx_BASE(p) (0x40020000UL + (0x400UL * (p))) // p = 0 -> GPIOA, 1 -> GPIOB, ...
+#define GPIOx_MODER(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x00))
+#define GPIOx_OSPEEDR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x08))
+#define GPIOx_PUPDR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x0C))
+#define GPIOx_AFR(p, n) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x20 + (4U * ((n) >> 3)))) // AFRL / AFRH
+
+/*-------------------------------------------bxCAN----------------------------------------------------------*/
+
+#define CAN1_BASE 0x40006400UL
+#define CAN2_BASE 0x40006800UL
+
+#define CAN_MCR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x000))
+#define CAN_MSR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x004))
+#define CAN_TSR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x008))
+#define CAN_RFR(b, f) (*(volatile uint32_t *)(uintptr_t)((b) + 0x00C + (4U * (f))))
+#define CAN_IER(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x014))
+#define CAN_ESR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x018))
+#define CAN_BTR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x01C))
+
+// TX mailboxes m = 0..2, RX FIFOs f = 0..1
+#define CAN_TIR(b, m) (*(volatile uint32_t *)(uintptr_t)((b) + 0x180 + (0x10U * (m))))
+#define CAN_TDTR(b, m) (*(volatile uint32_t *)(uintptr_t)((b) + 0x184 + (0x10U * (m))))
+#define CAN_TDLR(b, m) (*(volatile uint32_t *)(uintptr_t)((b) + 0x188 + (0x10U * (m))))
+#define CAN_TDHR(b, m) (*(volatile uint32_t *)(uintptr_t)((b) + 0x18C + (0x10U * (m))))
+#define CAN_RIR(b, f) (*(volatile uint32_t *)(uintptr_t)((b) + 0x1B0 + (0x10U * (f))))
+#define CAN_RDTR(b, f) (*(volatile uint32_t *)(uintptr_t)((b) + 0x1B4 + (0x10U * (f))))
+#define CAN_RDLR(b, f) (*(volatile uint32_t *)(uintptr_t)((b) + 0x1B8 + (0x10U * (f))))
+#define CAN_RDHR(b, f) (*(volatile uint32_t *)(uintptr_t)((b) + 0x1BC + (0x10U * (f))))
+
+// Filter banks live in CAN1 only and are shared: CAN1 owns 0 .. CAN2SB - 1, CAN2 owns CAN2SB .. 27
+#define CAN_FMR (*(volatile uint32_t *)(CAN1_BASE + 0x200))
+#define CAN_FM1R (*(volatile uint32_t *)(CAN1_BASE + 0x204))  // 0 = mask, 1 = list
+#define CAN_FS1R (*(volatile uint32_t *)(CAN1_BASE + 0x20C))  // 0 = dual 16-bit, 1 = single 32-bit
+#define CAN_FFA1R (*(volatile uint32_t *)(CAN1_BASE + 0x214)) // FIFO assignment
+#define CAN_FA1R (*(volatile uint32_t *)(CAN1_BASE + 0x21C))  // active
+#define CAN_FR1(n) (*(volatile uint32_t *)(CAN1_BASE + 0x240 + (8U * (n))))
+#define CAN_FR2(n) (*(volatile uint32_t *)(CAN1_BASE + 0x244 + (8U * (n))))
+
+#define CAN_MCR_INRQ (1UL << 0)
+#define CAN_MCR_SLEEP (1UL << 1)
+#define CAN_MCR_TXFP (1UL << 2) // 0: mailbox order by identifier priority
+#define CAN_MCR_ABOM (1UL << 6) // automatic bus-off recovery
+#define CAN_MCR_RESET (1UL << 15)
+
+#define CAN_MSR_INAK (1UL << 0)
+
+#define CAN_TSR_RQCP(m) (1UL << (8U * (m)))
+#define CAN_TSR_TXOK(m) (1UL << ((8U * (m)) + 1U))
+#define CAN_TSR_ABRQ(m) (1UL << ((8U * (m)) + 7U))
+#define CAN_TSR_TME(m) (1UL << (26U + (m)))
+
+#define CAN_RFR_FMP 3UL
+#define CAN_RFR_FULL (1UL << 3)
+#define CAN_RFR_FOVR (1UL << 4)
+#define CAN_RFR_RFOM (1UL << 5)
+
+#define CAN_IER_TMEIE (1UL << 0)
+#define CAN_IER_FMPIE(f) (1UL << (1U + (3U * (f))))
+#define CAN_IER_FOVIE(f) (1UL << (3U + (3U * (f))))
+
+#define CAN_BTR_LBKM (1UL << 30)
+#define CAN_BTR_SILM (1UL << 31)
+
+#define CAN_ID_IDE (1UL << 2)
+#define CAN_ID_RTR (1UL << 1)
+#define CAN_TIR_TXRQ (1UL << 0)
+
+#define CAN_FMR_FINIT (1UL << 0)
+#define CAN_FMR_CAN2SB(n) ((uint32_t)(n) << 8)
+
+#define CAN_FILTER_BANKS 28U
+
+#ifndef CAN_FILTER_SPLIT
+#define CAN_FILTER_SPLIT 14U // first bank of CAN2
+#endif
+
+#ifndef CAN_RX_RING_SIZE
+#define CAN_RX_RING_SIZE 32U // frames per FIFO ring, power of two
+#endif
+
+#ifndef CAN_TX_QUEUE_SIZE
+#define CAN_TX_QUEUE_SIZE 16U
+#endif
+
+#define CAN_STD_MASK 0x7FFUL
+#define CAN_EXT_MASK 0x1FFFFFFFUL
+
+typedef enum CAN_CONTROLLER
+{
+    CAN_1 = 0, // PA11 RX / PA12 TX, AF9
+    CAN_2 = 1  // PB12 RX / PB13 TX, AF9 (needs the CAN1 clock for the filter banks)
+} CAN_CONTROLLER;
+
+typedef enum CAN_MODE
+{
+    CAN_MODE_NORMAL = 0,
+    CAN_MODE_LOOPBACK = 1,        // TX looped to RX internally, still driven on the pin
+    CAN_MODE_SILENT = 2,          // listen only, never drives dominant bits (bus monitor)
+    CAN_MODE_SILENT_LOOPBACK = 3  // fully internal self test, no transceiver needed
+} CAN_MODE;
+
+typedef enum CAN_STATUS
+{
+    CAN_OK = 0,
+    CAN_ERROR_TIMING = 1, // no exact prescaler / segment split for this bitrate
+    CAN_ERROR_INIT = 2,   // INAK did not follow INRQ (no clock, or RX pin held dominant)
+    CAN_FILTER_FULL = 3,  // more filters than the controller's banks can hold
+    CAN_TX_FULL = 4
+} CAN_STATUS;
+
+typedef struct CAN_Frame_t
+{
+    uint32_t id;
+    uint8_t extended;
+    uint8_t remote;
+    uint8_t dlc;
+    uint8_t filter; // RX: index into the list given to CAN_Filter_Configure()
+    uint8_t data[8];
+} CAN_Frame_t;
+
+// mask bit 1 = identifier bit must match; mask = CAN_STD_MASK / CAN_EXT_MASK accepts exactly one ID
+typedef struct CAN_Filter_t
+{
+    uint32_t id;
+    uint32_t mask;
+    uint8_t extended;
+    uint8_t fifo;
+} CAN_Filter_t;
+
+// Single producer (RX ISR) / single consumer (CAN_Receive): no lock, each side writes only its own index
+typedef struct CAN_Ring_t
+{
+    CAN_Frame_t frames[CAN_RX_RING_SIZE];
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    volatile uint32_t dropped;
+} CAN_Ring_t;
+
+typedef struct CAN_Controller_t
+{
+    uint32_t base;
+    uint8_t tx_irq;
+    uint8_t rx_irq[2];
+    uint8_t gpio_port;
+    uint8_t rx_pin;
+    uint8_t tx_pin;
+    uint8_t first_bank;
+    uint8_t bank_count;
+
+    uint8_t filter_map[2][CAN_FILTER_BANKS * 4U]; // FMI -> user filter index, per FIFO
+    CAN_Ring_t rx[2];
+
+    CAN_Frame_t tx_queue[CAN_TX_QUEUE_SIZE]; // sorted, [0] = highest priority
+    uint8_t tx_count;
+    CAN_Frame_t mailbox[3]; // copy of each pending mailbox, requeued when it is aborted
+    uint8_t abort_pending;
+    volatile uint32_t tx_sent;
+    volatile uint32_t tx_dropped;
+    volatile uint32_t rx_overruns;
+} CAN_Controller_t;
+
+static CAN_Controller_t CAN_Controllers[2] =
+{
+    {.base = CAN1_BASE, .tx_irq = 19, .rx_irq = {20, 21}, .gpio_port = 0, .rx_pin = 11, .tx_pin = 12,
+     .first_bank = 0, .bank_count = CAN_FILTER_SPLIT},
+    {.base = CAN2_BASE, .tx_irq = 63, .rx_irq = {64, 65}, .gpio_port = 1, .rx_pin = 12, .tx_pin = 13,
+     .first_bank = CAN_FILTER_SPLIT, .bank_count = CAN_FILTER_BANKS - CAN_FILTER_SPLIT},
+};
+
+/*-------------------------------------------Bit timing------------------------------------------------------*/
+
+// Bit = 1 (sync) + TS1 + TS2 time quanta, t_q = (BRP + 1) / PCLK1. The longest bit (most quanta, finest
+// sample point) with an exact prescaler wins; the sample point is placed at 87.5 % (CANopen / DeviceNet).
+uint32_t CAN_Compute_BTR(uint32_t Pclk, uint32_t Bitrate)
+{
+    for (uint32_t quanta = 25U; quanta >= 8U; quanta--)
+    {
+        uint32_t prescaler;
+        uint32_t ts1;
+        uint32_t ts2;
+
+        if ((Pclk % (Bitrate * quanta)) != 0U)
+        {
+            continue;
+        }
+
+        prescaler = Pclk / (Bitrate * quanta);
+        ts1 = (((quanta * 7U) + 4U) / 8U) - 1U;
+        ts2 = quanta - 1U - ts1;
+
+        if ((prescaler == 0U) || (prescaler > 1024U) || (ts1 > 16U) || (ts2 < 1U) || (ts2 > 8U))
+        {
+            continue;
+        }
+
+        // SJW = min(TS2, 4)
+        return ((((ts2 < 4U) ? ts2 : 4U) - 1U) << 24) | ((ts2 - 1U) << 20) | ((ts1 - 1U) << 16) | (prescaler - 1U);
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------Filter-bank allocator-------------------------------------------
+  Filters are grouped per FIFO into the densest bank format that can hold them:
+
+    standard, exact      16-bit list   4 IDs per bank
+    standard, masked     16-bit mask   2 ID/mask pairs per bank
+    extended, exact      32-bit list   2 IDs per bank
+    extended, masked     32-bit mask   1 ID/mask pair per bank
+
+  A partly used bank repeats its last entry. List entries match data frames only (RTR is compared too).
+  The filter match index (FMI) counts the filters of one FIFO bank by bank, so the allocator records which
+  user filter every FMI belongs to, and received frames carry that index.
+----------------------------------------------------------------------------------------------------------*/
+
+#define CAN_KINDS 4U
+
+uint8_t CAN_Filter_Kind(const CAN_Filter_t *Filter)
+{
+    uint32_t full = Filter->extended ? CAN_EXT_MASK : CAN_STD_MASK;
+    uint8_t exact = (uint8_t)((Filter->mask & full) == full);
+
+    return (uint8_t)((Filter->extended ? 2U : 0U) + (exact ? 0U : 1U));
+}
+
+uint32_t CAN_Filter_16(uint32_t Id)
+{
+    return (Id & CAN_STD_MASK) << 5;
+}
+
+uint32_t CAN_Filter_32(uint32_t Id, uint8_t Extended)
+{
+    return Extended ? (((Id & CAN_EXT_MASK) << 3) | CAN_ID_IDE) : ((Id & CAN_STD_MASK) << 21);
+}
+
+CAN_STATUS CAN_Filter_Configure(CAN_CONTROLLER Can, const CAN_Filter_t *Filters, uint8_t Count)
+{
+    static const uint8_t per_bank[CAN_KINDS] = {4, 2, 2, 1};
+    CAN_Controller_t *c = &CAN_Controllers[Can];
+    uint8_t bank = c->first_bank;
+    uint8_t last_bank = (uint8_t)(c->first_bank + c->bank_count);
+    uint8_t fmi[2] = {0, 0};
+    CAN_STATUS status = CAN_OK;
+
+    // At most four filters per bank (16-bit list); this also keeps the scan index below its uint8_t wrap
+    if (Count > (c->bank_count * 4U))
+    {
+        return CAN_FILTER_FULL;
+    }
+
+    CAN_FMR = CAN_FMR_FINIT | CAN_FMR_CAN2SB(CAN_FILTER_SPLIT);
+
+    for (uint8_t b = c->first_bank; b < last_bank; b++)
+    {
+        CAN_FA1R &= ~(1UL << b);
+    }
+
+    for (uint8_t fifo = 0; fifo < 2U; fifo++)
+    {
+        for (uint8_t kind = 0; kind < CAN_KINDS; kind++)
+        {
+            uint8_t slot[4];
+            uint8_t used = 0;
+
+            for (uint8_t i = 0; i <= Count; i++)
+            {
+                if ((i < Count) && ((Filters[i].fifo & 1U) == fifo) && (CAN_Filter_Kind(&Filters[i]) == kind))
+                {
+                    slot[used++] = i;
+                }
+
+                if ((used == 0U) || ((used < per_bank[kind]) && (i < Count)))
+                {
+                    continue;
+                }
+
+                // Bank full, or last partial bank: pad with the last entry and write it
+                if (bank >= last_bank)
+                {
+                    status = CAN_FILTER_FULL;
+                    break;
+                }
+
+                while (used < per_bank[kind])
+                {
+                    slot[used] = slot[used - 1U];
+                    used++;
+                }
+
+                const CAN_Filter_t *f0 = &Filters[slot[0]];
+                const CAN_Filter_t *f1 = &Filters[slot[1 % per_bank[kind]]];
+                uint32_t bit = 1UL << bank;
+
+                switch (kind)
+                {
+                case 0: // 16-bit list
+                    CAN_FR1(bank) = CAN_Filter_16(f0->id) | (CAN_Filter_16(f1->id) << 16);
+                    CAN_FR2(bank) = CAN_Filter_16(Filters[slot[2]].id) | (CAN_Filter_16(Filters[slot[3]].id) << 16);
+                    break;
+
+                case 1: // 16-bit mask; IDE must be 0, RTR is don't care
+                    CAN_FR1(bank) = CAN_Filter_16(f0->id) | ((CAN_Filter_16(f0->mask) | (1UL << 3)) << 16);
+                    CAN_FR2(bank) = CAN_Filter_16(f1->id) | ((CAN_Filter_16(f1->mask) | (1UL << 3)) << 16);
+                    break;
+
+                case 2: // 32-bit list
+                    CAN_FR1(bank) = CAN_Filter_32(f0->id, 1);
+                    CAN_FR2(bank) = CAN_Filter_32(f1->id, 1);
+                    break;
+
+                default: // 32-bit mask; IDE must be 1, RTR is don't care
+                    CAN_FR1(bank) = CAN_Filter_32(f0->id, 1);
+                    CAN_FR2(bank) = ((f0->mask & CAN_EXT_MASK) << 3) | CAN_ID_IDE;
+                    break;
+                }
+
+                CAN_FM1R = ((kind == 0U) || (kind == 2U)) ? (CAN_FM1R | bit) : (CAN_FM1R & ~bit);
+                CAN_FS1R = (kind >= 2U) ? (CAN_FS1R | bit) : (CAN_FS1R & ~bit);
+                CAN_FFA1R = fifo ? (CAN_FFA1R | bit) : (CAN_FFA1R & ~bit);
+                CAN_FA1R |= bit;
+
+                for (uint8_t s = 0; s < per_bank[kind]; s++)
+                {
+                    c->filter_map[fifo][fmi[fifo]++] = slot[s];
+                }
+
+                bank++;
+                used = 0;
+            }
+        }
+    }
+
+    CAN_FMR &= ~CAN_FMR_FINIT;
+    return status;
+}
+
+/*-------------------------------------------TX: mailboxes + sorted queue------------------------------------*/
+
+// Lower key wins arbitration: base ID, then IDE (standard before extended), then the extension, then RTR
+uint32_t CAN_Priority_Key(const CAN_Frame_t *Frame)
+{
+    if (Frame->extended)
+    {
+        return ((Frame->id >> 18) << 20) | (1UL << 19) | ((Frame->id & 0x3FFFFUL) << 1) | Frame->remote;
+    }
+
+    return (Frame->id << 20) | Frame->remote;
+}
+
+void CAN_Mailbox_Load(CAN_Controller_t *C, uint8_t Mailbox, const CAN_Frame_t *Frame)
+{
+    const uint8_t *d = Frame->data;
+
+    C->mailbox[Mailbox] = *Frame;
+
+    CAN_TDTR(C->base, Mailbox) = Frame->dlc & 0xFU;
+    CAN_TDLR(C->base, Mailbox) = (uint32_t)d[0] | ((uint32_t)d[1] << 8) | ((uint32_t)d[2] << 16) | ((uint32_t)d[3] << 24);
+    CAN_TDHR(C->base, Mailbox) = (uint32_t)d[4] | ((uint32_t)d[5] << 8) | ((uint32_t)d[6] << 16) | ((uint32_t)d[7] << 24);
+    CAN_TIR(C->base, Mailbox) = CAN_Filter_32(Frame->id, Frame->extended) | (Frame->remote ? CAN_ID_RTR : 0U) |
+                                CAN_TIR_TXRQ;
+}
+
+// Insertion keeps the queue sorted; equal keys stay in submission order. A full queue drops the
+// lowest-priority frame, which may be the new one.
+uint8_t CAN_Queue_Insert(CAN_Controller_t *C, const CAN_Frame_t *Frame)
+{
+    uint32_t key = CAN_Priority_Key(Frame);
+    uint8_t i = C->tx_count;
+
+    if (C->tx_count == CAN_TX_QUEUE_SIZE)
+    {
+        if (key >= CAN_Priority_Key(&C->tx_queue[CAN_TX_QUEUE_SIZE - 1U]))
+        {
+            C->tx_dropped++;
+            return 0;
+        }
+
+        C->tx_dropped++;
+        i = CAN_TX_QUEUE_SIZE - 1U;
+    }
+    else
+    {
+        C->tx_count++;
+    }
+
+    while ((i > 0U) && (CAN_Priority_Key(&C->tx_queue[i - 1U]) > key))
+    {
+        C->tx_queue[i] = C->tx_queue[i - 1U];
+        i--;
+    }
+
+    C->tx_queue[i] = *Frame;
+    return 1;
+}
+
+// Moves queued frames into free mailboxes. If all three are busy with frames that would lose arbitration
+// to the queue head, the worst one is aborted and requeued (no priority inversion behind the mailboxes).
+void CAN_Tx_Refill(CAN_Controller_t *C)
+{
+    uint32_t tsr = CAN_TSR(C->base);
+    uint8_t worst = 0;
+    uint32_t worst_key = 0;
+
+    for (uint8_t m = 0; m < 3U; m++)
+    {
+        if ((tsr & CAN_TSR_TME(m)) && C->tx_count)
+        {
+            CAN_Mailbox_Load(C, m, &C->tx_queue[0]);
+            C->tx_count--;
+
+            for (uint8_t i = 0; i < C->tx_count; i++)
+            {
+                C->tx_queue[i] = C->tx_queue[i + 1U];
+            }
+        }
+        else if (!(tsr & CAN_TSR_TME(m)) && (CAN_Priority_Key(&C->mailbox[m]) >= worst_key))
+        {
+            worst = m;
+            worst_key = CAN_Priority_Key(&C->mailbox[m]);
+        }
+    }
+
+    tsr = CAN_TSR(C->base);
+
+    if (C->tx_count && !C->abort_pending && !(tsr & (CAN_TSR_TME(0) | CAN_TSR_TME(1) | CAN_TSR_TME(2))) &&
+        (CAN_Priority_Key(&C->tx_queue[0]) < worst_key))
+    {
+        C->abort_pending = 1;
+        CAN_TSR(C->base) = CAN_TSR_ABRQ(worst); // a frame already on the wire still completes normally
+    }
+}
+
+// RQCP: sent (TXOK) or aborted (requeue). Automatic retransmission is on, so nothing else ends a request.
+void CAN_Tx_IRQ(CAN_Controller_t *C)
+{
+    uint32_t tsr = CAN_TSR(C->base);
+
+    for (uint8_t m = 0; m < 3U; m++)
+    {
+        if (tsr & CAN_TSR_RQCP(m))
+        {
+            CAN_TSR(C->base) = CAN_TSR_RQCP(m); // also clears TXOK / ALST / TERR
+
+            if (tsr & CAN_TSR_TXOK(m))
+            {
+                C->tx_sent++;
+            }
+            else
+            {
+                CAN_Queue_Insert(C, &C->mailbox[m]);
+            }
+
+            C->abort_pending = 0;
+        }
+    }
+
+    CAN_Tx_Refill(C);
+}
+
+/*-------------------------------------------RX: FIFO -> ring-------------------------------------------------*/
+
+void CAN_Rx_IRQ(CAN_Controller_t *C, uint8_t Fifo)
+{
+    CAN_Ring_t *ring = &C->rx[Fifo];
+
+    while (CAN_RFR(C->base, Fifo) & CAN_RFR_FMP)
+    {
+        uint32_t rir = CAN_RIR(C->base, Fifo);
+        uint32_t rdtr = CAN_RDTR(C->base, Fifo);
+        uint16_t next = (uint16_t)((ring->head + 1U) & (CAN_RX_RING_SIZE - 1U));
+
+        if (next == ring->tail)
+        {
+            ring->dropped++; // ring full: the newest frame is dropped, the FIFO is still released
+        }
+        else
+        {
+            CAN_Frame_t *f = &ring->frames[ring->head];
+            uint32_t low = CAN_RDLR(C->base, Fifo);
+            uint32_t high = CAN_RDHR(C->base, Fifo);
+
+            f->extended = (uint8_t)((rir & CAN_ID_IDE) != 0U);
+            f->id = f->extended ? (rir >> 3) : (rir >> 21);
+            f->remote = (uint8_t)((rir & CAN_ID_RTR) != 0U);
+            f->dlc = (uint8_t)(rdtr & 0xFU);
+            f->filter = C->filter_map[Fifo][(rdtr >> 8) & 0xFFU];
+
+            for (uint8_t i = 0; i < 4U; i++)
+            {
+                f->data[i] = (uint8_t)(low >> (8U * i));
+                f->data[i + 4U] = (uint8_t)(high >> (8U * i));
+            }
+
+            __asm volatile("dmb" ::: "memory"); // frame complete before the consumer can see the new head
+            ring->head = next;
+        }
+
+        CAN_RFR(C->base, Fifo) = CAN_RFR_RFOM;
+    }
+
+    if (CAN_RFR(C->base, Fifo) & CAN_RFR_FOVR)
+    {
+        C->rx_overruns++; // hardware FIFO (3 deep) overflowed before this ISR ran
+        CAN_RFR(C->base, Fifo) = CAN_RFR_FOVR | CAN_RFR_FULL;
+    }
+}
+
+void CAN1_TX_IRQHandler(void)
+{
+    CAN_Tx_IRQ(&CAN_Controllers[CAN_1]);
+}
+
+void CAN1_RX0_IRQHandler(void)
+{
+    CAN_Rx_IRQ(&CAN_Controllers[CAN_1], 0);
+}
+
+void CAN1_RX1_IRQHandler(void)
+{
+    CAN_Rx_IRQ(&CAN_Controllers[CAN_1], 1);
+}
+
+void CAN2_TX_IRQHandler(void)
+{
+    CAN_Tx_IRQ(&CAN_Controllers[CAN_2]);
+}
+
+void CAN2_RX0_IRQHandler(void)
+{
+    CAN_Rx_IRQ(&CAN_Controllers[CAN_2], 0);
+}
+
+void CAN2_RX1_IRQHandler(void)
+{
+    CAN_Rx_IRQ(&CAN_Controllers[CAN_2], 1);
+}
+
+/*-------------------------------------------API------------------------------------------------------------*/
+
+// Filters are configured separately (CAN_Filter_Configure); until then nothing is received.
+CAN_STATUS CAN_Init(CAN_CONTROLLER Can, uint32_t Bitrate, CAN_MODE Mode)
+{
+    CAN_Controller_t *c = &CAN_Controllers[Can];
+    uint32_t btr = CAN_Compute_BTR(APB1_CLK, Bitrate);
+    uint32_t timeout;
+
+    if (btr == 0U)
+    {
+        return CAN_ERROR_TIMING;
+    }
+
+    RCC_Clock_Ensure(RCC_CLK_CAN1); // CAN2 is a slave of CAN1: its filters and SRAM live in CAN1
+
+    if (Can == CAN_2)
+    {
+        RCC_Clock_Ensure(RCC_CLK_CAN2);
+    }
+
+    RCC_Clock_Ensure(RCC_CLK_GPIO(c->gpio_port));
+
+    for (uint8_t pin = c->rx_pin; pin <= c->tx_pin; pin++)
+    {
+        GPIOx_AFR(c->gpio_port, pin) &= ~(0xFUL << (4U * (pin & 7U)));
+        GPIOx_AFR(c->gpio_port, pin) |= (9UL << (4U * (pin & 7U)));
+        GPIOx_MODER(c->gpio_port) &= ~(3UL << (2U * pin));
+        GPIOx_MODER(c->gpio_port) |= (2UL << (2U * pin));
+        GPIOx_OSPEEDR(c->gpio_port) |= (2UL << (2U * pin));
+    }
+
+    GPIOx_PUPDR(c->gpio_port) |= (1UL << (2U * c->rx_pin)); // recessive when no transceiver is fitted
+
+    // Sleep -> initialization
+    CAN_MCR(c->base) = CAN_MCR_INRQ;
+
+    for (timeout = 100000U; !(CAN_MSR(c->base) & CAN_MSR_INAK) && timeout; timeout--)
+    {
+    }
+
+    if (timeout == 0U)
+    {
+        return CAN_ERROR_INIT;
+    }
+
+    c->rx[0].head = c->rx[0].tail = 0;
+    c->rx[1].head = c->rx[1].tail = 0;
+    c->tx_count = 0;
+    c->abort_pending = 0;
+
+    CAN_MCR(c->base) = CAN_MCR_INRQ | CAN_MCR_ABOM;
+    CAN_BTR(c->base) = btr | (((uint32_t)Mode & 1U) ? CAN_BTR_LBKM : 0U) | (((uint32_t)Mode & 2U) ? CAN_BTR_SILM : 0U);
+    CAN_IER(c->base) = CAN_IER_TMEIE | CAN_IER_FMPIE(0) | CAN_IER_FMPIE(1) | CAN_IER_FOVIE(0) | CAN_IER_FOVIE(1);
+
+    NVIC_Setup_IRQ(c->rx_irq[0], NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+    NVIC_Setup_IRQ(c->rx_irq[1], NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+    NVIC_Setup_IRQ(c->tx_irq, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_TX);
+
+    // Normal mode after 11 recessive bits (immediately in silent loopback)
+    CAN_MCR(c->base) &= ~CAN_MCR_INRQ;
+
+    for (timeout = 100000U; (CAN_MSR(c->base) & CAN_MSR_INAK) && timeout; timeout--)
+    {
+    }
+
+    return timeout ? CAN_OK : CAN_ERROR_INIT;
+}
+
+// Queues the frame (copied) and fills any free mailbox. Safe from main and lower-priority ISRs.
+CAN_STATUS CAN_Transmit(CAN_CONTROLLER Can, const CAN_Frame_t *Frame)
+{
+    CAN_Controller_t *c = &CAN_Controllers[Can];
+    uint32_t state = NVIC_Enter_Critical(NVIC_PREEMPT_DMA);
+    uint8_t queued = CAN_Queue_Insert(c, Frame);
+
+    CAN_Tx_Refill(c);
+    NVIC_Exit_Critical(state);
+
+    return queued ? CAN_OK : CAN_TX_FULL;
+}
+
+uint8_t CAN_Receive(CAN_CONTROLLER Can, uint8_t Fifo, CAN_Frame_t *Frame)
+{
+    CAN_Ring_t *ring = &CAN_Controllers[Can].rx[Fifo & 1U];
+    uint16_t tail = ring->tail;
+
+    if (tail == ring->head)
+    {
+        return 0;
+    }
+
+    __asm volatile("dmb" ::: "memory"); // head read before the frame contents
+    *Frame = ring->frames[tail];
+    __asm volatile("dmb" ::: "memory"); // copy done before the slot is handed back
+    ring->tail = (uint16_t)((tail + 1U) & (CAN_RX_RING_SIZE - 1U));
+    return 1;
+}
+
+// TEC in bits 7:0, REC in bits 15:8, bus-off in bit 16
+uint32_t CAN_Get_Error_Counters(CAN_CONTROLLER Can)
+{
+    uint32_t esr = CAN_ESR(CAN_Controllers[Can].base);
+
+    return ((esr >> 16) & 0xFFFFUL) | (((esr >> 2) & 1U) << 16);
+}
+
+#endif
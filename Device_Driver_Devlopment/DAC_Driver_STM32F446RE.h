@@ -0,0 +1,212 @@
+// 12-bit DAC driver for STM32F446RE (the F411 has no DAC)
+// TIM6 TRGO paces the conversions, DMA1 streams sample tables in circular mode (no CPU per sample),
+// both channels can be fed from one packed table in dual mode, and the built-in triangle / noise
+// generators run from the same trigger.
+
+#ifndef DAC_DRIVER_STM32F446RE_H
+#define DAC_DRIVER_STM32F446RE_H
+
+#include <stdint.h>
+#include "DMA_Driver_STM32F4xx.h"
+
+/*-------------------------------------------GPIOA (PA4 = OUT1, PA5 = OUT2)---------------------------------*/
+
+#define GPIOA_BASE 0x40020000UL
+#define GPIOA_MODER (*(volatile uint32_t *)(GPIOA_BASE + 0x00))
+
+/*-------------------------------------------TIM6 (basic timer, trigger only)-------------------------------*/
+
+#define TIM6_BASE 0x40001000UL
+#define TIM6_CR1 (*(volatile uint32_t *)(TIM6_BASE + 0x00))
+#define TIM6_CR2 (*(volatile uint32_t *)(TIM6_BASE + 0x04))
+#define TIM6_EGR (*(volatile uint32_t *)(TIM6_BASE + 0x14))
+#define TIM6_CNT (*(volatile uint32_t *)(TIM6_BASE + 0x24))
+#define TIM6_PSC (*(volatile uint32_t *)(TIM6_BASE + 0x28))
+#define TIM6_ARR (*(volatile uint32_t *)(TIM6_BASE + 0x2C))
+
+#define TIM_CR2_MMS_UPDATE (2U << 4) // TRGO = update event
+
+/*-------------------------------------------DAC------------------------------------------------------------*/
+
+#define DAC_BASE 0x40007400UL
+#define DAC_CR (*(volatile uint32_t *)(DAC_BASE + 0x00))
+#define DAC_SWTRIGR (*(volatile uint32_t *)(DAC_BASE + 0x04))
+#define DAC_DHR12R(ch) (*(volatile uint32_t *)(DAC_BASE + 0x08 + (0x0CU * (ch)))) // ch = 0 -> DAC1, 1 -> DAC2
+#define DAC_DHR12RD (*(volatile uint32_t *)(DAC_BASE + 0x20))                     // both channels, one word
+#define DAC_DOR(ch) (*(volatile uint32_t *)(DAC_BASE + 0x2C + (4U * (ch))))
+#define DAC_SR (*(volatile uint32_t *)(DAC_BASE + 0x34))
+
+// Channel 2 fields are the channel 1 fields shifted by 16
+#define DAC_CR_SHIFT(ch) (16U * (ch))
+#define DAC_CR_EN (1UL << 0)
+#define DAC_CR_BOFF (1UL << 1)
+#define DAC_CR_TEN (1UL << 2)
+#define DAC_CR_TSEL_TIM6 (0UL << 3)
+#define DAC_CR_TSEL_MASK (7UL << 3)
+#define DAC_CR_WAVE_NOISE (1UL << 6)
+#define DAC_CR_WAVE_TRIANGLE (2UL << 6)
+#define DAC_CR_WAVE_MASK (3UL << 6)
+#define DAC_CR_MAMP(n) ((uint32_t)(n) << 8)
+#define DAC_CR_DMAEN (1UL << 12)
+#define DAC_CR_DMAUDRIE (1UL << 13)
+#define DAC_CR_CHANNEL_MASK 0xFFFFUL
+
+#define DAC_SR_DMAUDR(ch) (1UL << (13U + (16U * (ch))))
+
+#define TIM6_DAC_IRQn 54U
+
+// Two 12-bit samples for DHR12RD: channel 1 in bits 11:0, channel 2 in bits 27:16
+#define DAC_DUAL(ch1, ch2) ((uint32_t)(ch1) | ((uint32_t)(ch2) << 16))
+
+typedef enum DAC_CHANNEL
+{
+    DAC_CHANNEL_1 = 0, // PA4, DMA1 Stream5 channel 7
+    DAC_CHANNEL_2 = 1  // PA5, DMA1 Stream6 channel 7
+} DAC_CHANNEL;
+
+#define DAC_DMA DMA_1
+#define DAC_DMA_STREAM(ch) (5U + (ch))
+#define DAC_DMA_CHANNEL 7U
+
+// Triangle amplitude / noise mask: 2^(Bits) - 1, Bits = 1..12
+#define DAC_BITS(n) ((uint8_t)((n) - 1U))
+
+static uint16_t DAC_Table_Length[2];
+static volatile uint32_t DAC_Underruns;
+
+/*-------------------------------------------Trigger--------------------------------------------------------*/
+
+// TRGO on every update: one DAC conversion (and one DMA request) per period, jitter-free
+void DAC_Trigger_TIM6_Init(uint32_t Timer_Clock, uint32_t Sample_Rate_Hz)
+{
+    RCC_Clock_Ensure(RCC_CLK_TIM6);
+
+    TIM6_CR1 = 0;
+    TIM6_PSC = 0;
+    TIM6_ARR = (Timer_Clock / Sample_Rate_Hz) - 1U;
+    TIM6_CR2 = TIM_CR2_MMS_UPDATE;
+    TIM6_CNT = 0;
+    TIM6_EGR = (1 << 0);
+    TIM6_CR1 = (1 << 0);
+}
+
+/*-------------------------------------------Channel control------------------------------------------------*/
+
+void DAC_Init(DAC_CHANNEL Channel)
+{
+    RCC_Clock_Ensure(RCC_CLK_GPIOA);
+    RCC_Clock_Ensure(RCC_CLK_DAC);
+
+    GPIOA_MODER |= (3UL << (2U * (4U + Channel))); // analog: keeps the digital input stage off the output
+
+    NVIC_Setup_IRQ(TIM6_DAC_IRQn, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_TX);
+}
+
+// Channel off, its DMA stream stopped; output buffer enabled (BOFF = 0) for a low-impedance output.
+// The stream is only touched if this channel owns it (DMA1 Stream5/6 are shared with USART2).
+void DAC_Stop(DAC_CHANNEL Channel)
+{
+    uint32_t owned = DAC_CR & (DAC_CR_DMAEN << DAC_CR_SHIFT(Channel));
+
+    DAC_CR &= ~(DAC_CR_CHANNEL_MASK << DAC_CR_SHIFT(Channel));
+
+    if (owned)
+    {
+        DMA_Stream_Stop(DAC_DMA, DAC_DMA_STREAM(Channel));
+    }
+}
+
+void DAC_Write(DAC_CHANNEL Channel, uint16_t Value)
+{
+    DAC_Stop(Channel);
+    DAC_DHR12R(Channel) = Value & 0xFFFU;
+    DAC_CR |= (DAC_CR_EN << DAC_CR_SHIFT(Channel));
+}
+
+// Table of 12-bit samples, replayed forever at the TIM6 rate: f_out = Sample_Rate / Length
+void DAC_Stream_Start(DAC_CHANNEL Channel, const uint16_t *Table, uint16_t Length)
+{
+    uint8_t stream = DAC_DMA_STREAM(Channel);
+
+    DAC_Stop(Channel);
+
+    DMA_Stream_Init(DAC_DMA, stream,
+                    DMA_CR_CHSEL(DAC_DMA_CHANNEL) | DMA_CR_DIR_M2P | DMA_CR_MINC | DMA_CR_CIRC |
+                        DMA_CR_PSIZE_16 | DMA_CR_MSIZE_16 | DMA_CR_PL(2),
+                    0, &DAC_DHR12R(Channel), 0, 0, 0, 0);
+    DMA_Stream_Start(DAC_DMA, stream, Table, Length);
+    DAC_Table_Length[Channel] = Length;
+
+    DAC_CR |= (DAC_CR_EN | DAC_CR_TEN | DAC_CR_TSEL_TIM6 | DAC_CR_DMAEN | DAC_CR_DMAUDRIE)
+              << DAC_CR_SHIFT(Channel);
+}
+
+// Dual mode: one 32-bit DMA transfer per trigger writes DHR12RD, both channels convert on the same
+// trigger. Only channel 1 issues DMA requests; the two outputs stay sample-aligned.
+void DAC_Dual_Stream_Start(const uint32_t *Table, uint16_t Length)
+{
+    uint8_t stream = DAC_DMA_STREAM(DAC_CHANNEL_1);
+
+    DAC_Stop(DAC_CHANNEL_1);
+    DAC_Stop(DAC_CHANNEL_2);
+
+    DMA_Stream_Init(DAC_DMA, stream,
+                    DMA_CR_CHSEL(DAC_DMA_CHANNEL) | DMA_CR_DIR_M2P | DMA_CR_MINC | DMA_CR_CIRC |
+                        DMA_CR_PSIZE_32 | DMA_CR_MSIZE_32 | DMA_CR_PL(2),
+                    0, &DAC_DHR12RD, 0, 0, 0, 0);
+    DMA_Stream_Start(DAC_DMA, stream, Table, Length);
+    DAC_Table_Length[DAC_CHANNEL_1] = Length;
+
+    DAC_CR = ((DAC_CR_EN | DAC_CR_TEN | DAC_CR_TSEL_TIM6 | DAC_CR_DMAEN | DAC_CR_DMAUDRIE) << DAC_CR_SHIFT(0)) |
+             ((DAC_CR_EN | DAC_CR_TEN | DAC_CR_TSEL_TIM6) << DAC_CR_SHIFT(1));
+}
+
+// Hardware triangle: every trigger steps a counter 0 .. 2^Bits - 1 .. 0, added to Offset.
+// Period = 2 * (2^Bits - 1) triggers. Offset + amplitude must stay <= 4095.
+void DAC_Triangle_Start(DAC_CHANNEL Channel, uint16_t Offset, uint8_t Amplitude_Bits)
+{
+    DAC_Stop(Channel);
+    DAC_DHR12R(Channel) = Offset & 0xFFFU;
+    DAC_CR |= (DAC_CR_EN | DAC_CR_TEN | DAC_CR_TSEL_TIM6 | DAC_CR_WAVE_TRIANGLE | DAC_CR_MAMP(DAC_BITS(Amplitude_Bits)))
+              << DAC_CR_SHIFT(Channel);
+}
+
+// Hardware noise: 12-bit LFSR, Bits low bits unmasked, added to Offset on every trigger
+void DAC_Noise_Start(DAC_CHANNEL Channel, uint16_t Offset, uint8_t Bits)
+{
+    DAC_Stop(Channel);
+    DAC_DHR12R(Channel) = Offset & 0xFFFU;
+    DAC_CR |= (DAC_CR_EN | DAC_CR_TEN | DAC_CR_TSEL_TIM6 | DAC_CR_WAVE_NOISE | DAC_CR_MAMP(DAC_BITS(Bits)))
+              << DAC_CR_SHIFT(Channel);
+}
+
+uint32_t DAC_Get_Underruns(void)
+{
+    return DAC_Underruns;
+}
+
+/*-------------------------------------------Underrun recovery----------------------------------------------*/
+
+// DMAUDR: a trigger came while the previous DMA request was still pending (bus overloaded, or the
+// trigger is faster than the DMA). The DAC stops requesting; the stream is restarted from the table start.
+void TIM6_DAC_IRQHandler(void)
+{
+    for (uint8_t ch = 0; ch < 2U; ch++)
+    {
+        if (DAC_SR & DAC_SR_DMAUDR(ch))
+        {
+            uint8_t stream = DAC_DMA_STREAM(ch);
+            uint32_t memory = DMA_SxM0AR(DAC_DMA, stream);
+
+            DAC_Underruns++;
+            DAC_SR = DAC_SR_DMAUDR(ch); // rc_w1
+
+            DAC_CR &= ~(DAC_CR_DMAEN << DAC_CR_SHIFT(ch));
+            DMA_Stream_Stop(DAC_DMA, stream);
+            DMA_Stream_Start(DAC_DMA, stream, (const volatile void *)(uintptr_t)memory, DAC_Table_Length[ch]);
+            DAC_CR |= (DAC_CR_DMAEN << DAC_CR_SHIFT(ch));
+        }
+    }
+}
+
+#endif
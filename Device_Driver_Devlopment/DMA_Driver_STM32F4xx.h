@@ -0,0 +1,274 @@
+// DMA1 / DMA2 stream driver for STM32F411x / STM32F446xx
+// Stream registers are computed from (controller, stream); the driver owns all 16 stream vectors
+// and forwards the stream's flags to a registered callback.
+
+#ifndef DMA_DRIVER_STM32F4XX_H
+#define DMA_DRIVER_STM32F4XX_H
+
+#include <stdint.h>
+#include "NVIC_Driver_STM32F4xx.h"
+#include "RCC_Clock_Manager_STM32F4xx.h"
+
+/*-------------------------------------------DMA----------------------------------------------------------*/
+
+#define DMA_BASE(d) (0x40026000UL + (0x400UL * (d))) // d = 0 -> DMA1, 1 -> DMA2
+#define DMA_LISR(d) (*(volatile uint32_t *)(DMA_BASE(d) + 0x00))
+#define DMA_HISR(d) (*(volatile uint32_t *)(DMA_BASE(d) + 0x04))
+#define DMA_LIFCR(d) (*(volatile uint32_t *)(DMA_BASE(d) + 0x08))
+#define DMA_HIFCR(d) (*(volatile uint32_t *)(DMA_BASE(d) + 0x0C))
+
+#define DMA_SxCR(d, s) (*(volatile uint32_t *)(DMA_BASE(d) + 0x10 + (0x18UL * (s))))
+#define DMA_SxNDTR(d, s) (*(volatile uint32_t *)(DMA_BASE(d) + 0x14 + (0x18UL * (s))))
+#define DMA_SxPAR(d, s) (*(volatile uint32_t *)(DMA_BASE(d) + 0x18 + (0x18UL * (s))))
+#define DMA_SxM0AR(d, s) (*(volatile uint32_t *)(DMA_BASE(d) + 0x1C + (0x18UL * (s))))
+#define DMA_SxM1AR(d, s) (*(volatile uint32_t *)(DMA_BASE(d) + 0x20 + (0x18UL * (s))))
+#define DMA_SxFCR(d, s) (*(volatile uint32_t *)(DMA_BASE(d) + 0x24 + (0x18UL * (s))))
+
+// Streams 0-3 report in LISR/LIFCR, 4-7 in HISR/HIFCR, at bit 0 / 6 / 16 / 22
+#define DMA_ISR(d, s) (((s) < 4U) ? DMA_LISR(d) : DMA_HISR(d))
+#define DMA_FLAG_SHIFT(s) ((uint32_t)((0x16100600UL >> (8U * ((s) & 3U))) & 0xFFU))
+
+/*-------------------------------------------SxCR bits----------------------------------------------------*/
+
+#define DMA_CR_EN (1UL << 0)
+#define DMA_CR_DMEIE (1UL << 1)
+#define DMA_CR_TEIE (1UL << 2)
+#define DMA_CR_HTIE (1UL << 3)
+#define DMA_CR_TCIE (1UL << 4)
+#define DMA_CR_PFCTRL (1UL << 5)
+#define DMA_CR_DIR_P2M (0UL << 6)
+#define DMA_CR_DIR_M2P (1UL << 6)
+#define DMA_CR_DIR_M2M (2UL << 6)
+#define DMA_CR_CIRC (1UL << 8)
+#define DMA_CR_PINC (1UL << 9)
+#define DMA_CR_MINC (1UL << 10)
+#define DMA_CR_PSIZE_8 (0UL << 11)
+#define DMA_CR_PSIZE_16 (1UL << 11)
+#define DMA_CR_PSIZE_32 (2UL << 11)
+#define DMA_CR_MSIZE_8 (0UL << 13)
+#define DMA_CR_MSIZE_16 (1UL << 13)
+#define DMA_CR_MSIZE_32 (2UL << 13)
+#define DMA_CR_PL(n) ((uint32_t)(n) << 16) // 0 low .. 3 very high
+#define DMA_CR_DBM (1UL << 18)
+#define DMA_CR_CT (1UL << 19)
+#define DMA_CR_MBURST_INC4 (1UL << 23)
+#define DMA_CR_CHSEL(n) ((uint32_t)(n) << 25)
+
+#define DMA_FCR_DMDIS (1UL << 2) // FIFO on (direct mode off)
+#define DMA_FCR_FTH_FULL (3UL << 0)
+
+/*-------------------------------------------Flags passed to callbacks-------------------------------------*/
+
+#define DMA_FLAG_FE (1U << 0)
+#define DMA_FLAG_DME (1U << 2)
+#define DMA_FLAG_TE (1U << 3)
+#define DMA_FLAG_HT (1U << 4)
+#define DMA_FLAG_TC (1U << 5)
+#define DMA_FLAG_ALL 0x3DU
+
+typedef enum DMA_CONTROLLER
+{
+    DMA_1 = 0,
+    DMA_2 = 1
+} DMA_CONTROLLER;
+
+typedef void (*DMA_Callback_t)(void *Context, uint8_t Flags);
+
+typedef struct DMA_Handler_t
+{
+    DMA_Callback_t callback;
+    void *context;
+} DMA_Handler_t;
+
+static DMA_Handler_t DMA_Handlers[2][8];
+
+// IRQ numbers: DMA1 streams 0-6 = 11-17, stream 7 = 47; DMA2 streams 0-4 = 56-60, 5-7 = 68-70
+static const uint8_t DMA_IRQn_Table[2][8] =
+{
+    {11, 12, 13, 14, 15, 16, 17, 47},
+    {56, 57, 58, 59, 60, 68, 69, 70},
+};
+
+/*-------------------------------------------API----------------------------------------------------------*/
+
+void DMA_Stream_Clear_Flags(DMA_CONTROLLER Dma, uint8_t Stream, uint8_t Flags)
+{
+    uint32_t bits = (uint32_t)Flags << DMA_FLAG_SHIFT(Stream);
+
+    if (Stream < 4U)
+    {
+        DMA_LIFCR(Dma) = bits;
+    }
+    else
+    {
+        DMA_HIFCR(Dma) = bits;
+    }
+}
+
+uint8_t DMA_Stream_Get_Flags(DMA_CONTROLLER Dma, uint8_t Stream)
+{
+    return (uint8_t)((DMA_ISR(Dma, Stream) >> DMA_FLAG_SHIFT(Stream)) & DMA_FLAG_ALL);
+}
+
+// EN reads back 1 until the stream has really stopped (end of the current burst)
+void DMA_Stream_Stop(DMA_CONTROLLER Dma, uint8_t Stream)
+{
+    DMA_SxCR(Dma, Stream) &= ~DMA_CR_EN;
+
+    while (DMA_SxCR(Dma, Stream) & DMA_CR_EN)
+    {
+    }
+
+    DMA_Stream_Clear_Flags(Dma, Stream, DMA_FLAG_ALL);
+}
+
+// Cr = DMA_CR_CHSEL(n) | direction | sizes | increments | interrupt enables (EN is set by Start)
+void DMA_Stream_Init(DMA_CONTROLLER Dma, uint8_t Stream, uint32_t Cr, uint32_t Fcr, volatile void *Peripheral,
+                     DMA_Callback_t Callback, void *Context, uint8_t Preempt, uint8_t Sub)
+{
+    RCC_Clock_Ensure((Dma == DMA_1) ? RCC_CLK_DMA1 : RCC_CLK_DMA2); // shared by every stream of the controller
+
+    DMA_Stream_Stop(Dma, Stream);
+
+    DMA_SxCR(Dma, Stream) = Cr & ~DMA_CR_EN;
+    DMA_SxFCR(Dma, Stream) = Fcr;
+    DMA_SxPAR(Dma, Stream) = (uint32_t)(uintptr_t)Peripheral;
+
+    DMA_Handlers[Dma][Stream].callback = Callback;
+    DMA_Handlers[Dma][Stream].context = Context;
+
+    if (Callback)
+    {
+        NVIC_Setup_IRQ(DMA_IRQn_Table[Dma][Stream], Preempt, Sub);
+    }
+}
+
+void DMA_Stream_Start(DMA_CONTROLLER Dma, uint8_t Stream, const volatile void *Memory, uint16_t Count)
+{
+    DMA_SxM0AR(Dma, Stream) = (uint32_t)(uintptr_t)Memory;
+    DMA_SxNDTR(Dma, Stream) = Count;
+    DMA_Stream_Clear_Flags(Dma, Stream, DMA_FLAG_ALL);
+    DMA_SxCR(Dma, Stream) |= DMA_CR_EN;
+}
+
+// Double-buffer mode: hardware swaps M0AR / M1AR at every transfer complete, CT tells which one is live
+void DMA_Stream_Start_Double(DMA_CONTROLLER Dma, uint8_t Stream, const volatile void *Memory0,
+                             const volatile void *Memory1, uint16_t Count)
+{
+    DMA_SxCR(Dma, Stream) = (DMA_SxCR(Dma, Stream) & ~DMA_CR_CT) | DMA_CR_DBM | DMA_CR_CIRC;
+    DMA_SxM1AR(Dma, Stream) = (uint32_t)(uintptr_t)Memory1;
+    DMA_Stream_Start(Dma, Stream, Memory0, Count);
+}
+
+uint16_t DMA_Stream_Remaining(DMA_CONTROLLER Dma, uint8_t Stream)
+{
+    return (uint16_t)DMA_SxNDTR(Dma, Stream);
+}
+
+uint8_t DMA_Stream_Current_Target(DMA_CONTROLLER Dma, uint8_t Stream)
+{
+    return (uint8_t)((DMA_SxCR(Dma, Stream) & DMA_CR_CT) ? 1U : 0U);
+}
+
+uint8_t DMA_Stream_Busy(DMA_CONTROLLER Dma, uint8_t Stream)
+{
+    return (uint8_t)((DMA_SxCR(Dma, Stream) & DMA_CR_EN) ? 1U : 0U);
+}
+
+/*-------------------------------------------Dispatch-----------------------------------------------------*/
+
+// Flags are acknowledged with one write-one store before the callback runs
+void DMA_IRQ_Dispatch(DMA_CONTROLLER Dma, uint8_t Stream)
+{
+    uint8_t flags = DMA_Stream_Get_Flags(Dma, Stream);
+    DMA_Handler_t *handler = &DMA_Handlers[Dma][Stream];
+
+    DMA_Stream_Clear_Flags(Dma, Stream, flags);
+
+    if (handler->callback)
+    {
+        handler->callback(handler->context, flags);
+    }
+}
+
+void DMA1_Stream0_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_1, 0);
+}
+
+void DMA1_Stream1_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_1, 1);
+}
+
+void DMA1_Stream2_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_1, 2);
+}
+
+void DMA1_Stream3_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_1, 3);
+}
+
+void DMA1_Stream4_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_1, 4);
+}
+
+void DMA1_Stream5_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_1, 5);
+}
+
+void DMA1_Stream6_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_1, 6);
+}
+
+void DMA1_Stream7_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_1, 7);
+}
+
+void DMA2_Stream0_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_2, 0);
+}
+
+void DMA2_Stream1_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_2, 1);
+}
+
+void DMA2_Stream2_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_2, 2);
+}
+
+void DMA2_Stream3_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_2, 3);
+}
+
+void DMA2_Stream4_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_2, 4);
+}
+
+void DMA2_Stream5_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_2, 5);
+}
+
+void DMA2_Stream6_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_2, 6);
+}
+
+void DMA2_Stream7_IRQHandler(void)
+{
+    DMA_IRQ_Dispatch(DMA_2, 7);
+}
+
+#endif
@@ -0,0 +1,405 @@
+// Multiplexed display scanner for STM32F411x / STM32F446xx: 7-segment digits or an LED matrix, no CPU per row
+// Row (digit) select pins and column (segment) pins share one GPIO port. A circular table of BSRR words is
+// streamed to that port by DMA2, paced by the TIM1 update event: every row owns DISPLAY_SLOTS slots, slot 0
+// switches the previous row off and this row on in one store, a later slot blanks it again. The position of
+// that blank slot is the row's on-time, i.e. its brightness. All other slots hold 0 (BSRR ignores 0).
+// Glyph tables (7-segment ASCII font, 5x7 matrix digits) are built at compile time from X-macro lists.
+
+#ifndef DISPLAY_SCAN_STM32F4XX_H
+#define DISPLAY_SCAN_STM32F4XX_H
+
+#include <stdint.h>
+#include "RCC_Clock_Manager_STM32F4xx.h"
+#include "DMA_Driver_STM32F4xx.h"
+
+#ifndef DISPLAY_MAX_ROWS
+#define DISPLAY_MAX_ROWS 8U
+#endif
+
+#define DISPLAY_MAX_COLUMNS 8U
+
+// Brightness levels per row (0 = off .. DISPLAY_SLOTS = full row time)
+#ifndef DISPLAY_SLOTS
+#define DISPLAY_SLOTS 16U
+#endif
+
+/*-------------------------------------------TIM1 (APB2): scan clock----------------------------------------*/
+
+// TIM1 and TIM8 are the timers whose update requests go to DMA2. TIM8 is missing on the F411, so TIM1 paces the scan.
+
+#define TIM1_BASE 0x40010000UL
+#define TIM1_CR1 (*(volatile uint32_t *)(TIM1_BASE + 0x00))
+#define TIM1_DIER (*(volatile uint32_t *)(TIM1_BASE + 0x0C))
+#define TIM1_SR (*(volatile uint32_t *)(TIM1_BASE + 0x10))
+#define TIM1_EGR (*(volatile uint32_t *)(TIM1_BASE + 0x14))
+#define TIM1_PSC (*(volatile uint32_t *)(TIM1_BASE + 0x28))
+#define TIM1_ARR (*(volatile uint32_t *)(TIM1_BASE + 0x2C))
+
+#define TIM_CR1_CEN (1U << 0)
+#define TIM_DIER_UDE (1U << 8)
+
+// DMA1's peripheral port only reaches APB1, so GPIO writes need DMA2: TIM1_UP = DMA2 stream 5, channel 6
+// (TIM8_UP would be DMA2 stream 1, channel 7, on the F446 only)
+#define DISPLAY_DMA_STREAM 5U
+#define DISPLAY_DMA_CHANNEL 6U
+
+#define GPIOx_BASE(p) (0x40020000UL + (0x400UL * (p))) // p = 0 -> GPIOA, 1 -> GPIOB, ...
+#define GPIOx_MODER(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x00))
+#define GPIOx_BSRR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x18))
+
+/*-------------------------------------------Glyphs (built at compile time)---------------------------------*/
+
+// 7-segment bit order: a = bit 0 .. g = bit 6, dp = bit 7 (column 0..7 of the display)
+#define SEG_A (1U << 0)
+#define SEG_B (1U << 1)
+#define SEG_C (1U << 2)
+#define SEG_D (1U << 3)
+#define SEG_E (1U << 4)
+#define SEG_F (1U << 5)
+#define SEG_G (1U << 6)
+#define SEG_DP (1U << 7)
+
+#define SEG7_FONT(X)                                              \
+    X(' ', 0)                                                     \
+    X('-', SEG_G)                                                 \
+    X('_', SEG_D)                                                 \
+    X('0', SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F)         \
+    X('1', SEG_B | SEG_C)                                         \
+    X('2', SEG_A | SEG_B | SEG_D | SEG_E | SEG_G)                 \
+    X('3', SEG_A | SEG_B | SEG_C | SEG_D | SEG_G)                 \
+    X('4', SEG_B | SEG_C | SEG_F | SEG_G)                         \
+    X('5', SEG_A | SEG_C | SEG_D | SEG_F | SEG_G)                 \
+    X('6', SEG_A | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G)         \
+    X('7', SEG_A | SEG_B | SEG_C)                                 \
+    X('8', SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G) \
+    X('9', SEG_A | SEG_B | SEG_C | SEG_D | SEG_F | SEG_G)         \
+    X('A', SEG_A | SEG_B | SEG_C | SEG_E | SEG_F | SEG_G)         \
+    X('b', SEG_C | SEG_D | SEG_E | SEG_F | SEG_G)                 \
+    X('C', SEG_A | SEG_D | SEG_E | SEG_F)                         \
+    X('d', SEG_B | SEG_C | SEG_D | SEG_E | SEG_G)                 \
+    X('E', SEG_A | SEG_D | SEG_E | SEG_F | SEG_G)                 \
+    X('F', SEG_A | SEG_E | SEG_F | SEG_G)                         \
+    X('H', SEG_B | SEG_C | SEG_E | SEG_F | SEG_G)                 \
+    X('L', SEG_D | SEG_E | SEG_F)                                 \
+    X('n', SEG_C | SEG_E | SEG_G)                                 \
+    X('O', SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F)         \
+    X('o', SEG_C | SEG_D | SEG_E | SEG_G)                         \
+    X('P', SEG_A | SEG_B | SEG_E | SEG_F | SEG_G)                 \
+    X('r', SEG_E | SEG_G)                                         \
+    X('t', SEG_D | SEG_E | SEG_F | SEG_G)                         \
+    X('U', SEG_B | SEG_C | SEG_D | SEG_E | SEG_F)
+
+#define SEG7_ENTRY(ch, segments) [(uint8_t)(ch)] = (uint8_t)(segments),
+
+// Indexed by ASCII; characters not in the list are blank
+static const uint8_t Seg7_Font[128] = {SEG7_FONT(SEG7_ENTRY)};
+
+// 5x7 matrix digits: 7 row bytes, bit 4 = leftmost column
+#define MATRIX_FONT(X)                                \
+    X('0', 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E)  \
+    X('1', 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E)  \
+    X('2', 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F)  \
+    X('3', 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E)  \
+    X('4', 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02)  \
+    X('5', 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E)  \
+    X('6', 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E)  \
+    X('7', 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08)  \
+    X('8', 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E)  \
+    X('9', 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C)
+
+#define MATRIX_ENTRY(ch, r0, r1, r2, r3, r4, r5, r6) [(ch) - '0'] = {r0, r1, r2, r3, r4, r5, r6},
+
+static const uint8_t Matrix_Digits[10][7] = {MATRIX_FONT(MATRIX_ENTRY)};
+
+/*-------------------------------------------Driver state---------------------------------------------------*/
+
+typedef enum DISPLAY_STATUS
+{
+    DISPLAY_OK = 0,
+    DISPLAY_ERROR_CONFIG = 1 // rows / columns out of range, pin >= 16, or no TIM1 reload for the refresh rate
+} DISPLAY_STATUS;
+
+typedef struct Display_Config_t
+{
+    uint8_t port;                             // every row and column pin on this port (0 = GPIOA, ...)
+    uint8_t rows;                             // digits / matrix rows, 1..DISPLAY_MAX_ROWS
+    uint8_t columns;                          // segments / matrix columns, 1..8
+    uint8_t row_pin[DISPLAY_MAX_ROWS];        // digit common / matrix row select
+    uint8_t column_pin[DISPLAY_MAX_COLUMNS];  // segment a..dp / matrix column 0..7
+    uint8_t row_active_low;                   // common anode digits or PNP row drivers
+    uint8_t column_active_low;                // common anode segments
+    uint32_t timer_clock;                     // TIM1 clock (APB2 timer clock, 16 MHz on HSI)
+    uint32_t refresh_hz;                      // full frames per second
+} Display_Config_t;
+
+typedef struct Display_t
+{
+    Display_Config_t config;
+    uint32_t managed;     // all row and column pins
+    uint32_t active_low;  // pins whose "on" level is low
+    uint8_t frame[DISPLAY_MAX_ROWS];      // column bits per row: the framebuffer
+    uint8_t brightness[DISPLAY_MAX_ROWS]; // on-time in slots
+    uint32_t scan[DISPLAY_MAX_ROWS * DISPLAY_SLOTS]; // DMA source, one word per TIM1 update
+} Display_t;
+
+static Display_t Display;
+
+/*-------------------------------------------Word encoding--------------------------------------------------*/
+
+// Logical "on" pins -> one BSRR word that drives every managed pin: set the ones that must be high,
+// reset the rest (the set half wins for a pin named in both halves, so nothing is ever left floating)
+static uint32_t Display_Word(uint32_t On)
+{
+    uint32_t high = (On ^ Display.active_low) & Display.managed;
+
+    return high | ((Display.managed & ~high) << 16);
+}
+
+static uint32_t Display_Row_Word(uint8_t Row)
+{
+    uint32_t on = 1UL << Display.config.row_pin[Row];
+
+    for (uint8_t c = 0; c < Display.config.columns; c++)
+    {
+        if (Display.frame[Row] & (1U << c))
+        {
+            on |= 1UL << Display.config.column_pin[c];
+        }
+    }
+
+    return Display_Word(on);
+}
+
+/*-------------------------------------------Init----------------------------------------------------------*/
+
+// Nothing is touched when the configuration is rejected
+DISPLAY_STATUS Display_Init(const Display_Config_t *Config)
+{
+    uint8_t port = Config->port;
+    uint32_t updates;
+
+    if ((Config->rows == 0U) || (Config->rows > DISPLAY_MAX_ROWS) || (Config->columns == 0U) ||
+        (Config->columns > DISPLAY_MAX_COLUMNS) || (Config->refresh_hz == 0U))
+    {
+        return DISPLAY_ERROR_CONFIG;
+    }
+
+    for (uint8_t r = 0; r < Config->rows; r++)
+    {
+        if (Config->row_pin[r] >= 16U)
+        {
+            return DISPLAY_ERROR_CONFIG;
+        }
+    }
+
+    for (uint8_t c = 0; c < Config->columns; c++)
+    {
+        if (Config->column_pin[c] >= 16U)
+        {
+            return DISPLAY_ERROR_CONFIG;
+        }
+    }
+
+    // One update per slot: rows x slots x refresh; TIM1 is 16-bit and runs unprescaled
+    updates = Config->timer_clock / (Config->refresh_hz * Config->rows * DISPLAY_SLOTS);
+
+    if ((updates < 2U) || (updates > 0x10000UL))
+    {
+        return DISPLAY_ERROR_CONFIG;
+    }
+
+    Display.config = *Config;
+    Display.managed = 0;
+    Display.active_low = 0;
+
+    for (uint8_t r = 0; r < Config->rows; r++)
+    {
+        Display.managed |= 1UL << Config->row_pin[r];
+        Display.active_low |= Config->row_active_low ? (1UL << Config->row_pin[r]) : 0U;
+    }
+
+    for (uint8_t c = 0; c < Config->columns; c++)
+    {
+        Display.managed |= 1UL << Config->column_pin[c];
+        Display.active_low |= Config->column_active_low ? (1UL << Config->column_pin[c]) : 0U;
+    }
+
+    RCC_Clock_Ensure(RCC_CLK_GPIO(port));
+    GPIOx_BSRR(port) = Display_Word(0); // everything off before the pins become outputs
+
+    for (uint8_t pin = 0; pin < 16U; pin++)
+    {
+        if (Display.managed & (1UL << pin))
+        {
+            GPIOx_MODER(port) = (GPIOx_MODER(port) & ~(3UL << (2U * pin))) | (1UL << (2U * pin));
+        }
+    }
+
+    for (uint8_t r = 0; r < Config->rows; r++)
+    {
+        Display.frame[r] = 0;
+        Display.brightness[r] = DISPLAY_SLOTS;
+
+        for (uint8_t s = 0; s < DISPLAY_SLOTS; s++)
+        {
+            Display.scan[(r * DISPLAY_SLOTS) + s] = 0;
+        }
+
+        Display.scan[r * DISPLAY_SLOTS] = Display_Row_Word(r);
+    }
+
+    RCC_Clock_Enable(RCC_CLK_TIM1);
+    TIM1_CR1 = 0;
+    TIM1_PSC = 0;
+    TIM1_ARR = updates - 1U;
+    TIM1_EGR = 1U; // load PSC
+    TIM1_SR = 0;
+
+    DMA_Stream_Init(DMA_2, DISPLAY_DMA_STREAM,
+                    DMA_CR_CHSEL(DISPLAY_DMA_CHANNEL) | DMA_CR_DIR_M2P | DMA_CR_MINC | DMA_CR_CIRC |
+                        DMA_CR_PSIZE_32 | DMA_CR_MSIZE_32 | DMA_CR_PL(2),
+                    0, &GPIOx_BSRR(port), 0, 0, 0, 0);
+
+    return DISPLAY_OK;
+}
+
+void Display_Start(void)
+{
+    if (Display.config.rows == 0U)
+    {
+        return; // Display_Init() not run or rejected
+    }
+
+    DMA_Stream_Start(DMA_2, DISPLAY_DMA_STREAM, Display.scan,
+                     (uint16_t)(Display.config.rows * DISPLAY_SLOTS));
+    TIM1_DIER = TIM_DIER_UDE;
+    TIM1_CR1 = TIM_CR1_CEN;
+}
+
+void Display_Stop(void)
+{
+    TIM1_CR1 = 0;
+    TIM1_DIER = 0;
+    DMA_Stream_Stop(DMA_2, DISPLAY_DMA_STREAM);
+    GPIOx_BSRR(Display.config.port) = Display_Word(0);
+    RCC_Clock_Release(RCC_CLK_TIM1);
+}
+
+/*-------------------------------------------Framebuffer----------------------------------------------------*/
+
+// Column bits of one row. The row's scan entry is one aligned word: DMA sees the old or the new row, never a mix.
+void Display_Set_Row(uint8_t Row, uint8_t Columns)
+{
+    if (Row >= Display.config.rows)
+    {
+        return;
+    }
+
+    Display.frame[Row] = Columns;
+
+    if (Display.brightness[Row] != 0U)
+    {
+        Display.scan[Row * DISPLAY_SLOTS] = Display_Row_Word(Row);
+    }
+}
+
+// On-time of one row in slots (0 = off .. DISPLAY_SLOTS = whole row period). The new blank slot is written
+// before the old one is cleared, so the worst case is one frame at the lower of the two levels.
+void Display_Set_Brightness(uint8_t Row, uint8_t Level)
+{
+    uint32_t *row;
+    uint8_t old;
+
+    if (Row >= Display.config.rows)
+    {
+        return;
+    }
+
+    row = &Display.scan[Row * DISPLAY_SLOTS];
+    old = Display.brightness[Row];
+
+    if (Level > DISPLAY_SLOTS)
+    {
+        Level = DISPLAY_SLOTS;
+    }
+
+    Display.brightness[Row] = Level;
+
+    if (Level == 0U)
+    {
+        row[0] = Display_Word(0); // the row start itself blanks the display
+    }
+    else
+    {
+        if (Level < DISPLAY_SLOTS)
+        {
+            row[Level] = Display_Word(0);
+        }
+
+        row[0] = Display_Row_Word(Row);
+    }
+
+    if ((old != Level) && (old != 0U) && (old < DISPLAY_SLOTS))
+    {
+        row[old] = 0;
+    }
+}
+
+void Display_Set_All_Brightness(uint8_t Level)
+{
+    for (uint8_t r = 0; r < Display.config.rows; r++)
+    {
+        Display_Set_Brightness(r, Level);
+    }
+}
+
+// 7-segment text, left-aligned from digit 0; '.' lights the previous digit's dp, missing digits are blank
+void Display_Print(const char *Text)
+{
+    uint8_t row = 0;
+    uint8_t segments[DISPLAY_MAX_ROWS] = {0};
+
+    while (*Text != '\0')
+    {
+        if ((*Text == '.') && (row > 0U))
+        {
+            segments[row - 1U] |= SEG_DP;
+        }
+        else if (row < Display.config.rows)
+        {
+            segments[row++] = Seg7_Font[(uint8_t)*Text & 0x7FU];
+        }
+        else
+        {
+            break;
+        }
+
+        Text++;
+    }
+
+    for (uint8_t r = 0; r < Display.config.rows; r++)
+    {
+        Display_Set_Row(r, segments[r]);
+    }
+}
+
+// Matrix: one 5x7 digit, left-aligned from column 0 (column 0 = bit 0 of the frame)
+void Display_Matrix_Digit(uint8_t Digit)
+{
+    for (uint8_t r = 0; r < Display.config.rows; r++)
+    {
+        uint8_t bits = 0;
+
+        if ((r < 7U) && (Digit < 10U))
+        {
+            for (uint8_t c = 0; c < 5U; c++)
+            {
+                bits |= (uint8_t)(((Matrix_Digits[Digit][r] >> (4U - c)) & 1U) << c);
+            }
+        }
+
+        Display_Set_Row(r, bits);
+    }
+}
+
+#endif
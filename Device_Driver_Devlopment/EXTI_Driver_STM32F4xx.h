@@ -0,0 +1,216 @@
+// Generic EXTI driver for STM32F411x / STM32F446xx
+// Any port/pin/edge -> SYSCFG_EXTICRx and NVIC values are computed, callbacks are registered per line
+
+#ifndef EXTI_DRIVER_STM32F4XX_H
+#define EXTI_DRIVER_STM32F4XX_H
+
+#include <stdint.h>
+#include "NVIC_Driver_STM32F4xx.h"
+#include "RCC_Clock_Manager_STM32F4xx.h"
+
+/*-------------------------------------------SYSCFG-------------------------------------------------------*/
+
+#define SYSCFG_BASE 0x40013800UL
+#define SYSCFG_EXTICR(n) (*(volatile uint32_t *)(SYSCFG_BASE + 0x08 + (4U * (n)))) // n = 0..3 -> EXTICR1..4
+
+/*-------------------------------------------EXTI---------------------------------------------------------*/
+
+#define EXTI_BASE 0x40013C00UL
+#define EXTI_IMR (*(volatile uint32_t *)(EXTI_BASE + 0x00))
+#define EXTI_EMR (*(volatile uint32_t *)(EXTI_BASE + 0x04))
+#define EXTI_RTSR (*(volatile uint32_t *)(EXTI_BASE + 0x08))
+#define EXTI_FTSR (*(volatile uint32_t *)(EXTI_BASE + 0x0C))
+#define EXTI_SWIER (*(volatile uint32_t *)(EXTI_BASE + 0x10))
+#define EXTI_PR (*(volatile uint32_t *)(EXTI_BASE + 0x14))
+
+#define EXTI_LINES 16U
+#define EXTI_MASK_9_5 0x000003E0UL   // lines 5..9
+#define EXTI_MASK_15_10 0x0000FC00UL // lines 10..15
+
+/*-------------------------------------------IRQ numbers--------------------------------------------------*/
+
+// IRQ numbers (position in vector table after the 16 system exceptions)
+#define EXTI0_IRQn 6U
+#define EXTI1_IRQn 7U
+#define EXTI2_IRQn 8U
+#define EXTI3_IRQn 9U
+#define EXTI4_IRQn 10U
+#define EXTI9_5_IRQn 23U
+#define EXTI15_10_IRQn 40U
+
+typedef enum EXTI_PORTS
+{
+    EXTI_PORT_A = 0,
+    EXTI_PORT_B = 1,
+    EXTI_PORT_C = 2,
+    EXTI_PORT_D = 3,
+    EXTI_PORT_E = 4,
+    EXTI_PORT_H = 7
+} EXTI_PORTS;
+
+typedef enum EXTI_EDGE
+{
+    EXTI_EDGE_RISING = 1,
+    EXTI_EDGE_FALLING = 2,
+    EXTI_EDGE_BOTH = 3
+} EXTI_EDGE;
+
+typedef void (*EXTI_Callback_t)(uint8_t Line);
+
+static EXTI_Callback_t EXTI_Callbacks[EXTI_LINES];
+
+/*-------------------------------------------Helpers------------------------------------------------------*/
+
+// Highest set bit of a non-zero mask, compiled to a single CLZ instruction on Cortex-M4
+#define EXTI_HIGHEST_LINE(mask) (31U - (uint32_t)__builtin_clz(mask))
+
+uint8_t EXTI_Get_IRQn(uint8_t Line)
+{
+    if (Line <= 4U)
+    {
+        return (uint8_t)(EXTI0_IRQn + Line);
+    }
+
+    if (Line <= 9U)
+    {
+        return EXTI9_5_IRQn;
+    }
+
+    return EXTI15_10_IRQn;
+}
+
+/*-------------------------------------------API----------------------------------------------------------*/
+
+void EXTI_Init(EXTI_PORTS Port, uint8_t Pin, EXTI_EDGE Edge, EXTI_Callback_t Callback)
+{
+    if (Pin >= EXTI_LINES)
+    {
+        return; // GPIO lines are 0..15; higher EXTI lines (PVD, RTC, OTG) are not pin routed
+    }
+
+    uint32_t line_bit = 1UL << Pin;
+    uint8_t irq = EXTI_Get_IRQn(Pin);
+
+    RCC_Clock_Ensure(RCC_CLK_SYSCFG); // one shared reference for all lines
+
+    // Pin n -> EXTICR(n / 4), field (n % 4) * 4
+    SYSCFG_EXTICR(Pin >> 2) &= ~(0xFUL << (4U * (Pin & 3U)));
+    SYSCFG_EXTICR(Pin >> 2) |= ((uint32_t)Port << (4U * (Pin & 3U)));
+
+    if (Edge & EXTI_EDGE_RISING)
+    {
+        EXTI_RTSR |= line_bit;
+    }
+    else
+    {
+        EXTI_RTSR &= ~line_bit;
+    }
+
+    if (Edge & EXTI_EDGE_FALLING)
+    {
+        EXTI_FTSR |= line_bit;
+    }
+    else
+    {
+        EXTI_FTSR &= ~line_bit;
+    }
+
+    EXTI_Callbacks[Pin] = Callback;
+
+    EXTI_PR = line_bit; // rc_w1: drop any edge latched before the line was configured
+    EXTI_IMR |= line_bit;
+
+    NVIC_Setup_IRQ(irq, NVIC_PREEMPT_EXTI, 0); // below the TIM2 timebase, see NVIC priority plan
+}
+
+void EXTI_Disable(uint8_t Pin)
+{
+    if (Pin >= EXTI_LINES)
+    {
+        return;
+    }
+
+    uint32_t line_bit = 1UL << Pin;
+
+    EXTI_IMR &= ~line_bit;
+    EXTI_PR = line_bit;
+
+    // Shared vectors stay enabled while any other line of the group is still unmasked
+    if ((Pin <= 4U) ||
+        ((Pin <= 9U) && ((EXTI_IMR & EXTI_MASK_9_5) == 0U)) ||
+        ((Pin >= 10U) && ((EXTI_IMR & EXTI_MASK_15_10) == 0U)))
+    {
+        NVIC_Disable_IRQ(EXTI_Get_IRQn(Pin));
+    }
+
+    EXTI_Callbacks[Pin] = 0;
+}
+
+void EXTI_Software_Trigger(uint8_t Pin)
+{
+    if (Pin >= EXTI_LINES)
+    {
+        return;
+    }
+
+    EXTI_SWIER = 1UL << Pin;
+}
+
+/*-------------------------------------------Dispatch-----------------------------------------------------*/
+
+// Pending bits are acknowledged with a single write-one store before the callbacks run,
+// so an edge arriving while a callback executes is latched again instead of being lost.
+void EXTI_Dispatch(uint32_t Group_Mask)
+{
+    uint32_t pending = EXTI_PR & EXTI_IMR & Group_Mask;
+
+    EXTI_PR = pending;
+
+    while (pending)
+    {
+        uint8_t line = (uint8_t)EXTI_HIGHEST_LINE(pending);
+        pending &= ~(1UL << line);
+
+        if (EXTI_Callbacks[line])
+        {
+            EXTI_Callbacks[line](line);
+        }
+    }
+}
+
+void EXTI0_IRQHandler(void)
+{
+    EXTI_Dispatch(1UL << 0);
+}
+
+void EXTI1_IRQHandler(void)
+{
+    EXTI_Dispatch(1UL << 1);
+}
+
+void EXTI2_IRQHandler(void)
+{
+    EXTI_Dispatch(1UL << 2);
+}
+
+void EXTI3_IRQHandler(void)
+{
+    EXTI_Dispatch(1UL << 3);
+}
+
+void EXTI4_IRQHandler(void)
+{
+    EXTI_Dispatch(1UL << 4);
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+    EXTI_Dispatch(EXTI_MASK_9_5);
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+    EXTI_Dispatch(EXTI_MASK_15_10);
+}
+
+#endif
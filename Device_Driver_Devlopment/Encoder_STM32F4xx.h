@@ -0,0 +1,152 @@
+// Quadrature encoder interface for STM32F411x / STM32F446xx on TIM2..TIM5 (timer encoder mode)
+// A and B go to TI1 / TI2 through the digital input filters; the timer decodes every edge in hardware
+// (x2 on one input or x4 on both) and counts up or down, so no CPU time is spent per count at any rate.
+// Encoder_Sample() is called from a periodic timebase tick: it extends the 16 / 32-bit CNT to a 64-bit
+// position from the signed difference to the previous sample and derives the velocity from that difference.
+
+#ifndef ENCODER_STM32F4XX_H
+#define ENCODER_STM32F4XX_H
+
+#include <stdint.h>
+#include "GP_Timer_STM32F4xx.h"
+#include "NVIC_Driver_STM32F4xx.h"
+
+#define TIM_CR1_DIR (1U << 4) // read-only in encoder mode: 1 = last count was down
+
+// Counts per quadrature cycle (4 edges): SMS value from GP_Timer_STM32F4xx.h
+typedef enum ENCODER_MODE
+{
+    ENCODER_X2_TI1 = TIM_SMS_ENCODER2, // count on A edges only
+    ENCODER_X2_TI2 = TIM_SMS_ENCODER1, // count on B edges only
+    ENCODER_X4 = TIM_SMS_ENCODER3      // count on every edge of A and B
+} ENCODER_MODE;
+
+typedef struct Encoder_Config_t
+{
+    GP_TIMER timer;
+    ENCODER_MODE mode;
+    uint8_t filter;     // IC1F / IC2F 0..15: 0 = none, 3 = 8 samples at f_CK_INT, 15 = 8 at f_DTS / 32
+    uint8_t reverse;    // swap the counting direction (TI1 inverted)
+    uint32_t sample_hz; // rate at which Encoder_Sample() is called, for the velocity
+} Encoder_Config_t;
+
+typedef struct Encoder_t
+{
+    volatile uint32_t last;    // CNT at the previous sample
+    volatile int64_t position; // extended position at the previous sample
+    volatile int32_t delta;    // counts between the last two samples
+    uint32_t sample_hz;
+    volatile uint32_t samples; // changes after every sample: readers retry on a change
+} Encoder_t;
+
+static Encoder_t Encoder[GP_TIMER_COUNT];
+
+/*-------------------------------------------Init----------------------------------------------------------*/
+
+// A / B pins must already be routed with GP_Timer_Pin() (CH1 = A, CH2 = B)
+void Encoder_Init(const Encoder_Config_t *Config)
+{
+    GP_TIMER t = Config->timer;
+    uint32_t input = (TIM_CCMR_CCS_INPUT | TIM_CCMR_ICF(Config->filter));
+
+    RCC_Clock_Enable(GP_Timer_Clock(t));
+    GP_Timer_Reset(t);
+
+    TIMx_ARR(t) = GP_Timer_Max(t); // full range: the signed difference between samples needs it
+    GP_Timer_Load_Prescaler(t, 0);
+
+    TIMx_CCMR(t, 1) = (input << TIMx_CCMR_SHIFT(1)) | (input << TIMx_CCMR_SHIFT(2));
+    TIMx_CCER(t) = Config->reverse ? TIM_CCER_CCP(1) : 0U; // polarity only, captures stay disabled
+    TIMx_SMCR(t) = TIM_SMCR_SMS(Config->mode);
+
+    Encoder[t].last = 0;
+    Encoder[t].position = 0;
+    Encoder[t].delta = 0;
+    Encoder[t].sample_hz = Config->sample_hz;
+    Encoder[t].samples = 0;
+
+    TIMx_CR1(t) = TIM_CR1_CEN;
+}
+
+void Encoder_Deinit(GP_TIMER Timer)
+{
+    TIMx_CR1(Timer) = 0;
+    TIMx_SMCR(Timer) = 0;
+    RCC_Clock_Release(GP_Timer_Clock(Timer));
+}
+
+/*-------------------------------------------Sampling------------------------------------------------------*/
+
+// Raw CNT difference sign-extended from the counter width. Valid while the shaft moves less than half the
+// counter range between samples: 32767 counts on TIM3 / TIM4, i.e. 3.2 M counts/s at a 100 Hz tick.
+static inline int32_t Encoder_Diff(GP_TIMER Timer, uint32_t Now, uint32_t Before)
+{
+    uint32_t diff = Now - Before;
+
+    return GP_Timer_Is_32bit(Timer) ? (int32_t)diff : (int32_t)(int16_t)(uint16_t)diff;
+}
+
+// Call at a fixed rate (sample_hz) from the timebase interrupt
+void Encoder_Sample(GP_TIMER Timer)
+{
+    Encoder_t *enc = &Encoder[Timer];
+    uint32_t now = TIMx_CNT(Timer);
+
+    enc->delta = Encoder_Diff(Timer, now, enc->last);
+    enc->position += enc->delta;
+    enc->last = now;
+    enc->samples++;
+}
+
+/*-------------------------------------------Reading-------------------------------------------------------*/
+
+// Up to date to the last count, not just the last sample: the counts since the sample are added from CNT.
+// Call from the timebase priority or below; a sample in between only costs a retry.
+int64_t Encoder_Position(GP_TIMER Timer)
+{
+    Encoder_t *enc = &Encoder[Timer];
+    uint32_t samples;
+    int64_t position;
+
+    do
+    {
+        samples = enc->samples;
+        position = enc->position + Encoder_Diff(Timer, TIMx_CNT(Timer), enc->last);
+    } while (samples != enc->samples);
+
+    return position;
+}
+
+// Low 32 bits: wraps after 2^31 counts in either direction, one word for most panel / motor uses
+int32_t Encoder_Position32(GP_TIMER Timer)
+{
+    return (int32_t)Encoder_Position(Timer);
+}
+
+// Counts per second over the last sample interval; resolution is sample_hz counts/s
+int32_t Encoder_Velocity(GP_TIMER Timer)
+{
+    return Encoder[Timer].delta * (int32_t)Encoder[Timer].sample_hz;
+}
+
+// Direction of the most recent count, straight from the decoder: +1 forward, -1 reverse
+int8_t Encoder_Direction(GP_TIMER Timer)
+{
+    return (TIMx_CR1(Timer) & TIM_CR1_DIR) ? -1 : 1;
+}
+
+// Re-reference (index pulse, homing switch, mode reset): the extended position becomes Position now.
+// Masks up to the timebase priority so a sample cannot land between the two writes.
+void Encoder_Set_Position(GP_TIMER Timer, int64_t Position)
+{
+    Encoder_t *enc = &Encoder[Timer];
+    uint32_t state = NVIC_Enter_Critical(NVIC_PREEMPT_TIMEBASE);
+
+    enc->last = TIMx_CNT(Timer);
+    enc->position = Position;
+    enc->samples++;
+
+    NVIC_Exit_Critical(state);
+}
+
+#endif
@@ -0,0 +1,98 @@
+// Flash interface configuration for STM32F411x / STM32F446xx: wait states, prefetch and the ART accelerator
+// (128-bit instruction cache lines x 64 and data cache lines x 8 in front of the flash)
+// Latency must be raised before HCLK goes up and may only be lowered after HCLK has come down.
+
+#ifndef FLASH_ACR_STM32F4XX_H
+#define FLASH_ACR_STM32F4XX_H
+
+#include <stdint.h>
+
+#define FLASH_BASE_REG 0x40023C00UL
+#define FLASH_ACR (*(volatile uint32_t *)(FLASH_BASE_REG + 0x00))
+
+#define FLASH_ACR_LATENCY_MASK 0xFUL
+#define FLASH_ACR_PRFTEN (1UL << 8)
+#define FLASH_ACR_ICEN (1UL << 9)
+#define FLASH_ACR_DCEN (1UL << 10)
+#define FLASH_ACR_ICRST (1UL << 11) // only while ICEN = 0
+#define FLASH_ACR_DCRST (1UL << 12) // only while DCEN = 0
+
+// Supply 2.7 .. 3.6 V: one wait state per 30 MHz of HCLK (F446: 30/60/90/120/150/180 MHz;
+// the F411 allows 64 MHz at 1 WS and 100 MHz at 3 WS, the 30 MHz steps are never too fast for it).
+// Below 2.7 V the step shrinks (24 MHz at 2.4 V, 22 MHz at 2.1 V, 20 MHz at 1.8 V).
+#ifndef FLASH_WS_STEP_HZ
+#define FLASH_WS_STEP_HZ 30000000UL
+#endif
+
+// Accelerator features, OR-ed
+#define FLASH_PREFETCH 0x1U
+#define FLASH_ICACHE 0x2U
+#define FLASH_DCACHE 0x4U
+#define FLASH_ART_ALL (FLASH_PREFETCH | FLASH_ICACHE | FLASH_DCACHE)
+
+/*-------------------------------------------Wait states-----------------------------------------------------*/
+
+uint8_t FLASH_Latency_For(uint32_t Hclk)
+{
+    return (uint8_t)((Hclk == 0U) ? 0U : ((Hclk - 1U) / FLASH_WS_STEP_HZ));
+}
+
+// The new value is only in effect once it reads back; returns the latency actually set
+uint8_t FLASH_Set_Latency(uint8_t Wait_States)
+{
+    FLASH_ACR = (FLASH_ACR & ~FLASH_ACR_LATENCY_MASK) | (Wait_States & FLASH_ACR_LATENCY_MASK);
+
+    while ((FLASH_ACR & FLASH_ACR_LATENCY_MASK) != (Wait_States & FLASH_ACR_LATENCY_MASK))
+    {
+    }
+
+    return (uint8_t)(FLASH_ACR & FLASH_ACR_LATENCY_MASK);
+}
+
+// Call before switching HCLK up: raises the latency for the new clock, never lowers it
+void FLASH_Prepare_Clock_Change(uint32_t New_Hclk)
+{
+    uint8_t needed = FLASH_Latency_For(New_Hclk);
+
+    if (needed > (uint8_t)(FLASH_ACR & FLASH_ACR_LATENCY_MASK))
+    {
+        FLASH_Set_Latency(needed);
+    }
+}
+
+// Call after HCLK has settled (either direction): trims the latency to the minimum for that clock
+void FLASH_Finish_Clock_Change(uint32_t Hclk)
+{
+    FLASH_Set_Latency(FLASH_Latency_For(Hclk));
+}
+
+/*-------------------------------------------Accelerator-----------------------------------------------------*/
+
+// Caches are disabled, flushed and re-enabled as requested; stale lines cannot survive a reconfiguration
+// (or a flash erase / program, which should be followed by this call).
+void FLASH_Set_Accelerator(uint8_t Features)
+{
+    uint32_t acr = FLASH_ACR & ~(FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+
+    FLASH_ACR = acr;
+    FLASH_ACR = acr | FLASH_ACR_ICRST | FLASH_ACR_DCRST;
+    FLASH_ACR = acr;
+
+    FLASH_ACR = acr | ((Features & FLASH_PREFETCH) ? FLASH_ACR_PRFTEN : 0U) |
+                ((Features & FLASH_ICACHE) ? FLASH_ACR_ICEN : 0U) | ((Features & FLASH_DCACHE) ? FLASH_ACR_DCEN : 0U);
+}
+
+// Everything the active clock needs in one call; with HCLK <= 30 MHz there are no wait states to hide
+// and the accelerator changes little, above that it decides most of the throughput.
+void FLASH_Configure(uint32_t Hclk, uint8_t Features)
+{
+    FLASH_Set_Latency(FLASH_Latency_For(Hclk));
+    FLASH_Set_Accelerator(Features);
+}
+
+uint8_t FLASH_Get_Latency(void)
+{
+    return (uint8_t)(FLASH_ACR & FLASH_ACR_LATENCY_MASK);
+}
+
+#endif
@@ -0,0 +1,183 @@
+// General-purpose timers TIM2..TIM5 for STM32F411x / STM32F446xx: registers computed from the timer index,
+// counter widths, internal trigger (ITRx) routing between them and the slave-mode / master-mode fields.
+// Shared by the timer drivers that link timers in hardware (chained counter, triggered pulses, counters).
+
+#ifndef GP_TIMER_STM32F4XX_H
+#define GP_TIMER_STM32F4XX_H
+
+#include <stdint.h>
+#include "RCC_Clock_Manager_STM32F4xx.h"
+
+/*-------------------------------------------TIM2..TIM5 (APB1)---------------------------------------------*/
+
+#define TIMx_BASE(t) (0x40000000UL + (0x400UL * (t))) // t = 0 -> TIM2, 1 -> TIM3, 2 -> TIM4, 3 -> TIM5
+#define TIMx_CR1(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x00))
+#define TIMx_CR2(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x04))
+#define TIMx_SMCR(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x08))
+#define TIMx_DIER(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x0C))
+#define TIMx_SR(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x10))
+#define TIMx_EGR(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x14))
+#define TIMx_CCMR(t, ch) (*(volatile uint32_t *)(TIMx_BASE(t) + (((ch) <= 2U) ? 0x18 : 0x1C))) // ch = 1..4
+#define TIMx_CCER(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x20))
+#define TIMx_CNT(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x24))
+#define TIMx_PSC(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x28))
+#define TIMx_ARR(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x2C))
+#define TIMx_CCR(t, ch) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x34 + (4U * ((ch) - 1U))))
+#define TIMx_DCR(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x48))
+#define TIMx_DMAR(t) (*(volatile uint32_t *)(TIMx_BASE(t) + 0x4C))
+
+// CCMRx holds two channels: odd channels in bits 7:0, even channels in bits 15:8
+#define TIMx_CCMR_SHIFT(ch) ((((ch) - 1U) & 1U) ? 8U : 0U)
+
+/*-------------------------------------------GPIO (timer pins)---------------------------------------------*/
+
+#define GPIOx_BASE(p) (0x40020000UL + (0x400UL * (p))) // p = 0 -> GPIOA, 1 -> GPIOB, ...
+#define GPIOx_MODER(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x00))
+#define GPIOx_PUPDR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x0C))
+#define GPIOx_AFR(p, n) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x20 + (4U * ((n) >> 3)))) // AFRL / AFRH
+
+#define GP_TIMER_PULL_NONE 0U
+#define GP_TIMER_PULL_UP 1U
+#define GP_TIMER_PULL_DOWN 2U
+
+/*-------------------------------------------Register fields-----------------------------------------------*/
+
+#define TIM_CR1_CEN (1U << 0)
+#define TIM_CR1_UDIS (1U << 1)
+#define TIM_CR1_URS (1U << 2) // only counter over/underflow raises UIF / DMA, not UG
+#define TIM_CR1_OPM (1U << 3)
+#define TIM_CR1_ARPE (1U << 7)
+
+#define TIM_CR2_MMS(n) ((uint32_t)(n) << 4)
+#define TIM_CR2_MMS_UPDATE (2U << 4) // TRGO = update event
+#define TIM_CR2_MMS_OC1REF (4U << 4) // TRGO = OC1REF
+
+#define TIM_SMCR_SMS(n) ((uint32_t)(n) << 0)
+#define TIM_SMCR_TS(n) ((uint32_t)(n) << 4)
+#define TIM_SMCR_MSM (1U << 7)
+#define TIM_SMCR_ETF(n) ((uint32_t)(n) << 8)
+#define TIM_SMCR_ETPS(n) ((uint32_t)(n) << 12)
+#define TIM_SMCR_ECE (1U << 14) // external clock mode 2 (ETR)
+#define TIM_SMCR_ETP (1U << 15) // ETR inverted: falling edge
+
+// SMS: slave mode
+#define TIM_SMS_DISABLED 0U
+#define TIM_SMS_ENCODER1 1U // counts on TI2 edges
+#define TIM_SMS_ENCODER2 2U // counts on TI1 edges
+#define TIM_SMS_ENCODER3 3U // counts on both: x4
+#define TIM_SMS_RESET 4U
+#define TIM_SMS_GATED 5U
+#define TIM_SMS_TRIGGER 6U  // trigger edge sets CEN
+#define TIM_SMS_EXT_CLOCK 7U // external clock mode 1: every TRGI edge is a count
+
+// TS: trigger selection
+#define TIM_TS_ITR0 0U
+#define TIM_TS_ITR1 1U
+#define TIM_TS_ITR2 2U
+#define TIM_TS_ITR3 3U
+#define TIM_TS_TI1F_ED 4U
+#define TIM_TS_TI1FP1 5U
+#define TIM_TS_TI2FP2 6U
+#define TIM_TS_ETRF 7U
+
+#define TIM_DIER_UIE (1U << 0)
+#define TIM_DIER_CCIE(ch) (1U << (ch))
+#define TIM_DIER_UDE (1U << 8) // DMA request on update
+#define TIM_DIER_CCDE(ch) (1U << (8U + (ch)))
+#define TIM_DIER_TDE (1U << 14)
+
+#define TIM_SR_UIF (1U << 0)
+#define TIM_SR_CCIF(ch) (1U << (ch))
+#define TIM_SR_TIF (1U << 6)
+
+#define TIM_EGR_UG (1U << 0)
+
+// CCMR input fields, per channel byte (shift by TIMx_CCMR_SHIFT(ch))
+#define TIM_CCMR_CCS_INPUT 1U // CCxS = 01: ICx mapped on TIx
+#define TIM_CCMR_ICF(n) ((uint32_t)(n) << 4)
+
+#define TIM_CCER_CCP(ch) (1UL << ((4U * ((ch) - 1U)) + 1U)) // input inverted / falling edge
+
+typedef enum GP_TIMER
+{
+    TIM_2 = 0, // 32-bit, IRQ 28
+    TIM_3 = 1, // 16-bit, IRQ 29
+    TIM_4 = 2, // 16-bit, IRQ 30
+    TIM_5 = 3  // 32-bit, IRQ 50
+} GP_TIMER;
+
+#define GP_TIMER_COUNT 4U
+#define GP_TIMER_NO_ITR 0xFFU
+
+static const uint8_t GP_Timer_IRQn[GP_TIMER_COUNT] = {28, 29, 30, 50};
+
+// Internal trigger routing (RM0383 / RM0390 "TIMx internal trigger connection"): ITR number a slave
+// uses to see the master's TRGO, [slave][master]. TIM5's TRGO only reaches TIM3; TIM5 hears all three others.
+static const uint8_t GP_Timer_Itr[GP_TIMER_COUNT][GP_TIMER_COUNT] =
+{
+    /* slave TIM2 */ {GP_TIMER_NO_ITR, TIM_TS_ITR2, TIM_TS_ITR3, GP_TIMER_NO_ITR},
+    /* slave TIM3 */ {TIM_TS_ITR1, GP_TIMER_NO_ITR, TIM_TS_ITR3, TIM_TS_ITR2},
+    /* slave TIM4 */ {TIM_TS_ITR1, TIM_TS_ITR2, GP_TIMER_NO_ITR, GP_TIMER_NO_ITR},
+    /* slave TIM5 */ {TIM_TS_ITR0, TIM_TS_ITR1, TIM_TS_ITR2, GP_TIMER_NO_ITR}
+};
+
+/*-------------------------------------------Helpers-------------------------------------------------------*/
+
+static inline uint8_t GP_Timer_Is_32bit(GP_TIMER Timer)
+{
+    return (Timer == TIM_2) || (Timer == TIM_5);
+}
+
+static inline uint32_t GP_Timer_Max(GP_TIMER Timer)
+{
+    return GP_Timer_Is_32bit(Timer) ? 0xFFFFFFFFUL : 0xFFFFUL;
+}
+
+// TIM2..TIM5 sit at APB1ENR bits 0..3
+static inline RCC_CLOCK GP_Timer_Clock(GP_TIMER Timer)
+{
+    return (RCC_CLOCK)(RCC_CLK_TIM2 + Timer);
+}
+
+// Counter stopped, slave / master modes and interrupts off, all channels disconnected: a known state to build on
+void GP_Timer_Reset(GP_TIMER Timer)
+{
+    TIMx_CR1(Timer) = 0;
+    TIMx_CR2(Timer) = 0;
+    TIMx_SMCR(Timer) = 0;
+    TIMx_DIER(Timer) = 0;
+    TIMx_CCER(Timer) = 0;
+    TIMx_CCMR(Timer, 1) = 0;
+    TIMx_CCMR(Timer, 3) = 0;
+    TIMx_CNT(Timer) = 0;
+    TIMx_SR(Timer) = 0;
+}
+
+// PSC is preloaded: UG makes it effective now (and clears CNT). URS keeps that UG from raising UIF /
+// update DMA; call this before selecting MMS = update, or the UG also reaches a slave as one TRGO.
+void GP_Timer_Load_Prescaler(GP_TIMER Timer, uint32_t Prescaler)
+{
+    uint32_t cr1 = TIMx_CR1(Timer);
+
+    TIMx_PSC(Timer) = Prescaler;
+    TIMx_CR1(Timer) = cr1 | TIM_CR1_URS;
+    TIMx_EGR(Timer) = TIM_EGR_UG;
+    TIMx_CR1(Timer) = cr1;
+    TIMx_SR(Timer) = 0;
+}
+
+// Channel / ETR pin in alternate function mode: AF1 for TIM2, AF2 for TIM3..TIM5
+// (TIM2: CH1/ETR PA0 PA5 PA15, CH2 PA1 PB3, CH3 PA2 PB10, CH4 PA3; TIM3: PA6 PA7 PB0 PB1 / PB4 PB5 / PC6..PC9;
+//  TIM4: PB6..PB9; TIM5: PA0..PA3)
+void GP_Timer_Pin(GP_TIMER Timer, uint8_t Port, uint8_t Pin, uint8_t Pull)
+{
+    uint32_t af = (Timer == TIM_2) ? 1U : 2U;
+
+    RCC_Clock_Ensure(RCC_CLK_GPIO(Port));
+
+    GPIOx_AFR(Port, Pin) = (GPIOx_AFR(Port, Pin) & ~(0xFUL << (4U * (Pin & 7U)))) | (af << (4U * (Pin & 7U)));
+    GPIOx_PUPDR(Port) = (GPIOx_PUPDR(Port) & ~(3UL << (2U * Pin))) | ((uint32_t)Pull << (2U * Pin));
+    GPIOx_MODER(Port) = (GPIOx_MODER(Port) & ~(3UL << (2U * Pin))) | (2UL << (2U * Pin));
+}
+
+#endif
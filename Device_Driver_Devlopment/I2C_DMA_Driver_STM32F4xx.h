@@ -0,0 +1,567 @@
+// I2C1 / I2C2 / I2C3 master driver for STM32F411x / STM32F446xx
+// Interrupt-driven state machine with DMA payloads: transactions (write, read, or write + repeated start + read)
+// are queued per port and run back to back from the event / DMA interrupts; the caller gets a callback.
+// Bus errors, NACKs and timeouts abort the transaction, free the bus (9 clocks + STOP) and continue the queue.
+
+#ifndef I2C_DMA_DRIVER_STM32F4XX_H
+#define I2C_DMA_DRIVER_STM32F4XX_H
+
+#include <stdint.h>
+#include "DMA_Driver_STM32F4xx.h"
+
+/*-------------------------------Bus clock (HSI, no prescaler)-----------------------------------------------*/
+
+#ifndef APB1_CLK
+#define APB1_CLK 16000000UL
+#endif
+
+/*-------------------------------------------GPIO (any port)------------------------------------------------*/
+
+#define GPIOx_BASE(p) (0x40020000UL + (0x400UL * (p))) // p = 0 -> GPIOA, 1 -> GPIOB, ...
+#define GPIOx_MODER(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x00))
+#define GPIOx_OTYPER(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x04))
+#define GPIOx_OSPEEDR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x08))
+#define GPIOx_PUPDR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x0C))
+#define GPIOx_IDR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x10))
+#define GPIOx_BSRR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x18))
+#define GPIOx_AFR(p, n) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x20 + (4U * ((n) >> 3)))) // AFRL / AFRH
+
+/*-------------------------------------------I2C------------------------------------------------------------*/
+
+#define I2C1_BASE 0x40005400UL
+#define I2C2_BASE 0x40005800UL
+#define I2C3_BASE 0x40005C00UL
+
+#define I2C_CR1(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x00))
+#define I2C_CR2(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x04))
+#define I2C_DR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x10))
+#define I2C_SR1(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x14))
+#define I2C_SR2(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x18))
+#define I2C_CCR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x1C))
+#define I2C_TRISE(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x20))
+
+#define I2C_CR1_PE (1UL << 0)
+#define I2C_CR1_START (1UL << 8)
+#define I2C_CR1_STOP (1UL << 9)
+#define I2C_CR1_ACK (1UL << 10)
+#define I2C_CR1_SWRST (1UL << 15)
+
+#define I2C_CR2_ITERREN (1UL << 8)
+#define I2C_CR2_ITEVTEN (1UL << 9)
+#define I2C_CR2_ITBUFEN (1UL << 10)
+#define I2C_CR2_DMAEN (1UL << 11)
+#define I2C_CR2_LAST (1UL << 12) // DMA RX: NACK the last byte by hardware
+
+#define I2C_SR1_SB (1UL << 0)
+#define I2C_SR1_ADDR (1UL << 1)
+#define I2C_SR1_BTF (1UL << 2)
+#define I2C_SR1_RXNE (1UL << 6)
+#define I2C_SR1_BERR (1UL << 8)
+#define I2C_SR1_ARLO (1UL << 9)
+#define I2C_SR1_AF (1UL << 10)
+#define I2C_SR1_OVR (1UL << 11)
+#define I2C_SR1_TIMEOUT (1UL << 14)
+#define I2C_SR1_ERRORS (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR | I2C_SR1_TIMEOUT)
+
+#define I2C_CCR_FS (1UL << 15)
+
+// The I2C v1 peripheral of the F4 stops at Fast-mode; Fast-mode Plus (1 MHz) needs the F446 FMPI2C1
+#define I2C_SPEED_STANDARD 100000UL
+#define I2C_SPEED_FAST 400000UL
+
+// Transaction watchdog in I2C_Timeout_Tick() calls (1 ms each in the example)
+#ifndef I2C_TIMEOUT_TICKS
+#define I2C_TIMEOUT_TICKS 10U
+#endif
+
+// Half SCL period of the recovery clock (~5 us at 16 MHz)
+#define I2C_RECOVERY_DELAY 20U
+
+// I2C2_SDA on PB3 is AF9 on the F411 and AF4 on the F446 (build with -DSTM32F446xx)
+#if defined(STM32F446xx)
+#define I2C2_SDA_AF 4U
+#else
+#define I2C2_SDA_AF 9U
+#endif
+
+typedef enum I2C_PORTS
+{
+    I2C_1 = 0, // PB8 SCL / PB9 SDA, AF4
+    I2C_2 = 1, // PB10 SCL AF4 / PB3 SDA I2C2_SDA_AF
+    I2C_3 = 2  // PA8 SCL / PC9 SDA, AF4
+} I2C_PORTS;
+
+typedef enum I2C_STATUS
+{
+    I2C_OK = 0,
+    I2C_PENDING = 1,
+    I2C_NACK = 2,             // address or data byte not acknowledged
+    I2C_ARBITRATION_LOST = 3, // another master won the bus
+    I2C_BUS_ERROR = 4,        // misplaced START/STOP, DMA error or overrun; the bus was recovered
+    I2C_TIMEOUT = 5           // no progress within I2C_TIMEOUT_TICKS; the bus was recovered
+} I2C_STATUS;
+
+typedef enum I2C_STATE
+{
+    I2C_STATE_IDLE = 0,
+    I2C_STATE_WRITE = 1,     // START / address+W / TX DMA
+    I2C_STATE_READ = 2,      // (repeated) START / address+R / RX DMA or single byte
+    I2C_STATE_COMPLETING = 3 // inside the done callback
+} I2C_STATE;
+
+typedef struct I2C_Transaction_t I2C_Transaction_t;
+typedef void (*I2C_Callback_t)(I2C_Transaction_t *Transaction);
+
+// Caller-owned; must stay valid until Done is called. tx_length = 0 and rx_length = 0 probes the address.
+struct I2C_Transaction_t
+{
+    uint8_t address; // 7-bit
+    const uint8_t *tx;
+    uint16_t tx_length;
+    uint8_t *rx;
+    uint16_t rx_length;
+    I2C_Callback_t done;
+    void *context;
+    volatile I2C_STATUS status;
+    I2C_Transaction_t *next;
+};
+
+typedef struct I2C_Port_t
+{
+    uint32_t base;
+    uint8_t ev_irq;
+    uint8_t er_irq;
+    uint8_t rx_stream;
+    uint8_t rx_channel;
+    uint8_t tx_stream;
+    uint8_t tx_channel;
+    uint8_t scl_port;
+    uint8_t scl_pin;
+    uint8_t scl_af;
+    uint8_t sda_port;
+    uint8_t sda_pin;
+    uint8_t sda_af;
+
+    uint32_t speed;
+    I2C_Transaction_t *head;
+    I2C_Transaction_t *tail;
+    volatile uint8_t state;
+    volatile uint16_t timeout;
+    volatile uint32_t recoveries;
+} I2C_Port_t;
+
+// All on DMA1 (RM0383 / RM0390): I2C1 RX S0 ch1 / TX S6 ch1, I2C2 RX S2 ch7 / TX S7 ch7, I2C3 RX S1 ch1 / TX S4 ch3
+#define I2C_DMA DMA_1
+
+static I2C_Port_t I2C_Ports[3] =
+{
+    {I2C1_BASE, 31, 32, 0, 1, 6, 1, 1, 8, 4, 1, 9, 4, 0, 0, 0, 0, 0, 0},
+    {I2C2_BASE, 33, 34, 2, 7, 7, 7, 1, 10, 4, 1, 3, I2C2_SDA_AF, 0, 0, 0, 0, 0, 0},
+    {I2C3_BASE, 72, 73, 1, 1, 4, 3, 0, 8, 4, 2, 9, 4, 0, 0, 0, 0, 0, 0},
+};
+
+/*-------------------------------------------Configuration---------------------------------------------------*/
+
+void I2C_Delay(void)
+{
+    for (volatile uint32_t i = 0; i < I2C_RECOVERY_DELAY; i++)
+    {
+    }
+}
+
+void I2C_Pin_Mode(uint8_t Port, uint8_t Pin, uint32_t Mode)
+{
+    GPIOx_MODER(Port) &= ~(3UL << (2U * Pin));
+    GPIOx_MODER(Port) |= (Mode << (2U * Pin));
+}
+
+void I2C_Pin_Init(uint8_t Port, uint8_t Pin, uint8_t Af)
+{
+    RCC_Clock_Ensure(RCC_CLK_GPIO(Port));
+
+    GPIOx_OTYPER(Port) |= (1UL << Pin); // open drain
+    GPIOx_PUPDR(Port) &= ~(3UL << (2U * Pin));
+    GPIOx_PUPDR(Port) |= (1UL << (2U * Pin)); // weak pull-up; 400 kHz still needs external 2.2k .. 4.7k
+    GPIOx_OSPEEDR(Port) |= (2UL << (2U * Pin));
+    GPIOx_AFR(Port, Pin) &= ~(0xFUL << (4U * (Pin & 7U)));
+    GPIOx_AFR(Port, Pin) |= ((uint32_t)Af << (4U * (Pin & 7U)));
+    I2C_Pin_Mode(Port, Pin, 2);
+}
+
+// FREQ = PCLK1 in MHz. Standard: T_high = T_low = CCR * T_pclk. Fast (DUTY = 0): T_low = 2 * T_high,
+// CCR = PCLK1 / (3 * f) rounded up so the bus never runs above the request.
+void I2C_Configure(I2C_Port_t *I2c)
+{
+    uint32_t base = I2c->base;
+    uint32_t mhz = APB1_CLK / 1000000UL;
+    uint32_t ccr;
+
+    I2C_CR1(base) = I2C_CR1_SWRST;
+    I2C_CR1(base) = 0;
+    I2C_CR2(base) = mhz;
+
+    if (I2c->speed <= I2C_SPEED_STANDARD)
+    {
+        ccr = (APB1_CLK + (2U * I2c->speed) - 1U) / (2U * I2c->speed);
+        I2C_CCR(base) = (ccr < 4U) ? 4U : ccr;
+        I2C_TRISE(base) = mhz + 1U; // 1000 ns max rise time
+    }
+    else
+    {
+        ccr = (APB1_CLK + (3U * I2c->speed) - 1U) / (3U * I2c->speed);
+        I2C_CCR(base) = I2C_CCR_FS | ((ccr < 1U) ? 1U : ccr);
+        I2C_TRISE(base) = ((mhz * 300U) / 1000U) + 1U; // 300 ns max rise time
+    }
+
+    I2C_CR1(base) = I2C_CR1_PE;
+}
+
+/*-------------------------------------------Bus recovery----------------------------------------------------*/
+
+// A slave reset in the middle of a read can hold SDA low forever. Up to nine SCL pulses let it finish the
+// byte, then a STOP (SDA rising while SCL is high) returns every device to idle. Runs for ~100 us.
+void I2C_Recover(I2C_Port_t *I2c)
+{
+    I2C_CR1(I2c->base) = 0;
+
+    GPIOx_BSRR(I2c->scl_port) = (1UL << I2c->scl_pin);
+    GPIOx_BSRR(I2c->sda_port) = (1UL << I2c->sda_pin);
+    I2C_Pin_Mode(I2c->scl_port, I2c->scl_pin, 1);
+    I2C_Pin_Mode(I2c->sda_port, I2c->sda_pin, 1);
+    I2C_Delay();
+
+    for (uint8_t i = 0; (i < 9U) && !(GPIOx_IDR(I2c->sda_port) & (1UL << I2c->sda_pin)); i++)
+    {
+        GPIOx_BSRR(I2c->scl_port) = (1UL << (I2c->scl_pin + 16U));
+        I2C_Delay();
+        GPIOx_BSRR(I2c->scl_port) = (1UL << I2c->scl_pin);
+        I2C_Delay();
+    }
+
+    GPIOx_BSRR(I2c->scl_port) = (1UL << (I2c->scl_pin + 16U));
+    I2C_Delay();
+    GPIOx_BSRR(I2c->sda_port) = (1UL << (I2c->sda_pin + 16U));
+    I2C_Delay();
+    GPIOx_BSRR(I2c->scl_port) = (1UL << I2c->scl_pin);
+    I2C_Delay();
+    GPIOx_BSRR(I2c->sda_port) = (1UL << I2c->sda_pin);
+    I2C_Delay();
+
+    I2C_Pin_Mode(I2c->scl_port, I2c->scl_pin, 2);
+    I2C_Pin_Mode(I2c->sda_port, I2c->sda_pin, 2);
+
+    I2C_Configure(I2c);
+    I2C_CR2(I2c->base) |= I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+    I2c->recoveries++;
+}
+
+/*-------------------------------------------State machine---------------------------------------------------*/
+
+void I2C_Start(I2C_Port_t *I2c)
+{
+    I2C_Transaction_t *t = I2c->head;
+
+    t->status = I2C_PENDING;
+    I2c->timeout = I2C_TIMEOUT_TICKS;
+    I2c->state = ((t->tx_length != 0U) || (t->rx_length == 0U)) ? I2C_STATE_WRITE : I2C_STATE_READ;
+
+    I2C_CR1(I2c->base) |= I2C_CR1_START;
+}
+
+// Unlinks the head, reports it and starts the next one. The STOP requested just before finishes within
+// one SCL period; START must not be set while STOP is still pending, hence the bounded wait.
+void I2C_Finish(I2C_Port_t *I2c, I2C_STATUS Status)
+{
+    I2C_Transaction_t *t = I2c->head;
+
+    I2C_CR2(I2c->base) &= ~(I2C_CR2_ITBUFEN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+
+    for (uint32_t i = 0; (i < 1000U) && (I2C_CR1(I2c->base) & I2C_CR1_STOP); i++)
+    {
+    }
+
+    I2c->head = t->next;
+
+    if (I2c->head == 0)
+    {
+        I2c->tail = 0;
+    }
+
+    t->next = 0;
+    t->status = Status;
+    I2c->state = I2C_STATE_COMPLETING; // a resubmit from the callback only links
+
+    if (t->done)
+    {
+        t->done(t);
+    }
+
+    if (I2c->head)
+    {
+        I2C_Start(I2c);
+    }
+    else
+    {
+        I2c->state = I2C_STATE_IDLE;
+    }
+}
+
+// Stops both streams and the current transfer; Recover also resets the peripheral
+void I2C_Abort(I2C_Port_t *I2c, I2C_STATUS Status)
+{
+    I2C_CR2(I2c->base) &= ~(I2C_CR2_ITBUFEN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+    DMA_Stream_Stop(I2C_DMA, I2c->rx_stream);
+    DMA_Stream_Stop(I2C_DMA, I2c->tx_stream);
+
+    if (Status == I2C_NACK)
+    {
+        I2C_CR1(I2c->base) |= I2C_CR1_STOP;
+    }
+    else if (Status != I2C_ARBITRATION_LOST) // after ARLO the hardware has already released the bus
+    {
+        I2C_Recover(I2c);
+    }
+
+    I2C_Finish(I2c, Status);
+}
+
+void I2C_Event(I2C_Port_t *I2c)
+{
+    uint32_t base = I2c->base;
+    uint32_t sr1 = I2C_SR1(base);
+    I2C_Transaction_t *t = I2c->head;
+
+    if ((t == 0) || (I2c->state == I2C_STATE_IDLE))
+    {
+        (void)I2C_SR2(base); // stray event: clear ADDR and leave
+        return;
+    }
+
+    I2c->timeout = I2C_TIMEOUT_TICKS; // progress
+
+    if (sr1 & I2C_SR1_SB)
+    {
+        I2C_DR(base) = ((uint32_t)t->address << 1) | ((I2c->state == I2C_STATE_READ) ? 1U : 0U);
+    }
+    else if (sr1 & I2C_SR1_ADDR)
+    {
+        if (I2c->state == I2C_STATE_WRITE)
+        {
+            if (t->tx_length)
+            {
+                DMA_Stream_Start(I2C_DMA, I2c->tx_stream, t->tx, t->tx_length);
+                I2C_CR2(base) |= I2C_CR2_DMAEN;
+                (void)I2C_SR2(base); // SR1 then SR2 read clears ADDR and releases SCL
+            }
+            else
+            {
+                (void)I2C_SR2(base);
+                I2C_CR1(base) |= I2C_CR1_STOP; // address probe acknowledged
+                I2C_Finish(I2c, I2C_OK);
+            }
+        }
+        else if (t->rx_length == 1U)
+        {
+            // One byte: NACK and STOP must be programmed before ADDR is cleared; DMA cannot do this
+            I2C_CR1(base) &= ~I2C_CR1_ACK;
+            (void)I2C_SR2(base);
+            I2C_CR1(base) |= I2C_CR1_STOP;
+            I2C_CR2(base) |= I2C_CR2_ITBUFEN;
+        }
+        else
+        {
+            I2C_CR1(base) |= I2C_CR1_ACK;
+            DMA_Stream_Start(I2C_DMA, I2c->rx_stream, t->rx, t->rx_length);
+            I2C_CR2(base) |= I2C_CR2_DMAEN | I2C_CR2_LAST;
+            (void)I2C_SR2(base);
+        }
+    }
+    else if ((sr1 & I2C_SR1_BTF) && (I2c->state == I2C_STATE_WRITE) &&
+             (DMA_Stream_Remaining(I2C_DMA, I2c->tx_stream) == 0U))
+    {
+        // Last TX byte on the wire (TX DMA complete only means it reached DR)
+        I2C_CR2(base) &= ~I2C_CR2_DMAEN;
+
+        if (t->rx_length)
+        {
+            I2c->state = I2C_STATE_READ;
+            I2C_CR1(base) |= I2C_CR1_START; // repeated start, also clears BTF
+        }
+        else
+        {
+            I2C_CR1(base) |= I2C_CR1_STOP;
+            I2C_Finish(I2c, I2C_OK);
+        }
+    }
+    else if ((sr1 & I2C_SR1_RXNE) && (I2c->state == I2C_STATE_READ) && (t->rx_length == 1U))
+    {
+        t->rx[0] = (uint8_t)I2C_DR(base);
+        I2C_Finish(I2c, I2C_OK);
+    }
+}
+
+void I2C_Error(I2C_Port_t *I2c)
+{
+    uint32_t sr1 = I2C_SR1(I2c->base);
+    I2C_STATUS status = I2C_BUS_ERROR;
+
+    I2C_SR1(I2c->base) = ~(sr1 & I2C_SR1_ERRORS) & 0xFFFFUL; // rc_w0
+
+    if (sr1 & I2C_SR1_AF)
+    {
+        status = I2C_NACK;
+    }
+    else if (sr1 & I2C_SR1_ARLO)
+    {
+        status = I2C_ARBITRATION_LOST;
+    }
+
+    if (I2c->head && (I2c->state != I2C_STATE_IDLE))
+    {
+        I2C_Abort(I2c, status);
+    }
+}
+
+// RX DMA complete: the last byte was NACKed by LAST, STOP ends the transfer
+void I2C_Rx_DMA_Callback(void *Context, uint8_t Flags)
+{
+    I2C_Port_t *i2c = (I2C_Port_t *)Context;
+
+    if ((i2c->head == 0) || (i2c->state != I2C_STATE_READ))
+    {
+        return;
+    }
+
+    if (Flags & DMA_FLAG_TE)
+    {
+        I2C_Abort(i2c, I2C_BUS_ERROR);
+    }
+    else if (Flags & DMA_FLAG_TC)
+    {
+        I2C_CR1(i2c->base) |= I2C_CR1_STOP;
+        I2C_Finish(i2c, I2C_OK);
+    }
+}
+
+void I2C1_EV_IRQHandler(void)
+{
+    I2C_Event(&I2C_Ports[I2C_1]);
+}
+
+void I2C1_ER_IRQHandler(void)
+{
+    I2C_Error(&I2C_Ports[I2C_1]);
+}
+
+void I2C2_EV_IRQHandler(void)
+{
+    I2C_Event(&I2C_Ports[I2C_2]);
+}
+
+void I2C2_ER_IRQHandler(void)
+{
+    I2C_Error(&I2C_Ports[I2C_2]);
+}
+
+void I2C3_EV_IRQHandler(void)
+{
+    I2C_Event(&I2C_Ports[I2C_3]);
+}
+
+void I2C3_ER_IRQHandler(void)
+{
+    I2C_Error(&I2C_Ports[I2C_3]);
+}
+
+/*-------------------------------------------API------------------------------------------------------------*/
+
+// Speed_Hz is clamped to 400 kHz. Event, error and DMA interrupts share NVIC_PREEMPT_DMA, so they never
+// preempt each other and one BASEPRI level protects the queue.
+void I2C_Init(I2C_PORTS Port, uint32_t Speed_Hz)
+{
+    I2C_Port_t *i2c = &I2C_Ports[Port];
+
+    RCC_Clock_Ensure((RCC_CLOCK)(RCC_CLK_I2C1 + Port));
+
+    I2C_Pin_Init(i2c->scl_port, i2c->scl_pin, i2c->scl_af);
+    I2C_Pin_Init(i2c->sda_port, i2c->sda_pin, i2c->sda_af);
+
+    i2c->speed = (Speed_Hz > I2C_SPEED_FAST) ? I2C_SPEED_FAST : Speed_Hz;
+    i2c->head = 0;
+    i2c->tail = 0;
+    i2c->state = I2C_STATE_IDLE;
+    i2c->recoveries = 0;
+
+    DMA_Stream_Init(I2C_DMA, i2c->rx_stream,
+                    DMA_CR_CHSEL(i2c->rx_channel) | DMA_CR_DIR_P2M | DMA_CR_MINC | DMA_CR_PL(2) | DMA_CR_TCIE |
+                        DMA_CR_TEIE,
+                    0, &I2C_DR(i2c->base), I2C_Rx_DMA_Callback, i2c, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+    DMA_Stream_Init(I2C_DMA, i2c->tx_stream,
+                    DMA_CR_CHSEL(i2c->tx_channel) | DMA_CR_DIR_M2P | DMA_CR_MINC | DMA_CR_PL(2), 0,
+                    &I2C_DR(i2c->base), 0, 0, 0, 0);
+
+    // A bus left busy by a reset during a transfer is freed before the first transaction
+    I2C_Recover(i2c);
+    i2c->recoveries = 0;
+
+    NVIC_Setup_IRQ(i2c->ev_irq, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+    NVIC_Setup_IRQ(i2c->er_irq, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+}
+
+// Appends to the port's queue and starts it if idle. Safe from main, callbacks and lower-priority ISRs.
+void I2C_Submit(I2C_PORTS Port, I2C_Transaction_t *Transaction)
+{
+    I2C_Port_t *i2c = &I2C_Ports[Port];
+    uint32_t state = NVIC_Enter_Critical(NVIC_PREEMPT_DMA);
+
+    Transaction->next = 0;
+    Transaction->status = I2C_PENDING;
+
+    if (i2c->tail)
+    {
+        i2c->tail->next = Transaction;
+    }
+    else
+    {
+        i2c->head = Transaction;
+    }
+
+    i2c->tail = Transaction;
+
+    if (i2c->state == I2C_STATE_IDLE)
+    {
+        I2C_Start(i2c);
+    }
+
+    NVIC_Exit_Critical(state);
+}
+
+// Call periodically (e.g. 1 ms SysTick). A transaction that shows no bus progress for I2C_TIMEOUT_TICKS
+// calls is aborted with I2C_TIMEOUT after a bus recovery; the queue then continues.
+void I2C_Timeout_Tick(I2C_PORTS Port)
+{
+    I2C_Port_t *i2c = &I2C_Ports[Port];
+    uint32_t state = NVIC_Enter_Critical(NVIC_PREEMPT_DMA);
+
+    if ((i2c->state == I2C_STATE_WRITE) || (i2c->state == I2C_STATE_READ))
+    {
+        if (--i2c->timeout == 0U)
+        {
+            I2C_Abort(i2c, I2C_TIMEOUT);
+        }
+    }
+
+    NVIC_Exit_Critical(state);
+}
+
+uint8_t I2C_Idle(I2C_PORTS Port)
+{
+    return (uint8_t)(I2C_Ports[Port].state == I2C_STATE_IDLE);
+}
+
+uint32_t I2C_Get_Recoveries(I2C_PORTS Port)
+{
+    return I2C_Ports[Port].recoveries;
+}
+
+#endif
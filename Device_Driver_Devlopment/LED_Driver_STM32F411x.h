@@ -2,10 +2,7 @@
 #define LED_DRIVER_STM32_H
 
 #include <stdint.h>
-
-/*-------------------------------RCC ENABLE & AHB1 ENABL------------------------------------------------*/
-#define RCC_BASE 0x40023800UL
-#define RCC_AHB1ENR (*(volatile uint32_t *)(RCC_BASE + 0x30))
+#include "RCC_Clock_Manager_STM32F4xx.h" // GPIO clocks: one shared reference per port, no RCC write after the first call
 
 /*-------------------------------------------GPIOA--------------------------------------------------------*/
 
@@ -61,22 +58,21 @@ static const GPIO_t GPIOC_PC15 = {GPIOC, 15};
 
 void GPIO_Init(GPIO_t GPIOx)
 {
+    RCC_Clock_Ensure(RCC_CLK_GPIO(GPIOx.Port));
+
     switch (GPIOx.Port)
     {
     case GPIOA:
-        RCC_AHB1ENR |= (1 << GPIOx.Port);
         GPIOA_MODER &= ~(3U << (2U * GPIOx.Pin));
         GPIOA_MODER |= (1U << (2U * GPIOx.Pin));
         break;
 
     case GPIOB:
-        RCC_AHB1ENR |= (1 << GPIOx.Port);
         GPIOB_MODER &= ~(3U << (2U * GPIOx.Pin));
         GPIOB_MODER |= (1U << (2U * GPIOx.Pin));
         break;
 
     case GPIOC:
-        RCC_AHB1ENR |= (1 << GPIOx.Port);
         GPIOC_MODER &= ~(3U << (2U * GPIOx.Pin));
         GPIOC_MODER |= (1U << (2U * GPIOx.Pin));
         break;
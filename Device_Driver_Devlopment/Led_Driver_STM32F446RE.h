@@ -2,11 +2,7 @@
 #define LED_DRIVER_STM32_H
 
 #include <stdint.h>
-
-/*------------------------------RCC BASE ADDRESS ---------------------------------*/
-
-#define RCC_BASE 0x40023800UL
-#define RCC_AHB1ENR (*(volatile uint32_t *)(RCC_BASE + 0x30U))
+#include "RCC_Clock_Manager_STM32F4xx.h" // GPIO clocks: one shared reference per port, no RCC write after the first call
 
 /*-------------------------------GPIOA CONFIGRATION----------------------------------*/
 
@@ -92,22 +88,21 @@ static const GPIO_t GPIOC_PC15 = {GPIOC, 15};
 
 void GPIO_Init(GPIO_t GPIO_Port_Pin)
 {
+    RCC_Clock_Ensure(RCC_CLK_GPIO(GPIO_Port_Pin.Port));
+
     switch (GPIO_Port_Pin.Port)
     {
     case GPIOA:
-        RCC_AHB1ENR |= (1 << GPIO_Port_Pin.Port);
         GPIOA_MODER &= ~(3 << (2 * GPIO_Port_Pin.Pin));
         GPIOA_MODER |= (1 << (2 * GPIO_Port_Pin.Pin));
         break;
 
     case GPIOB:
-        RCC_AHB1ENR |= (1 << GPIO_Port_Pin.Port);
         GPIOB_MODER &= ~(3 << (2 * GPIO_Port_Pin.Pin));
         GPIOB_MODER |= (1 << (2 * GPIO_Port_Pin.Pin));
         break;
 
     case GPIOC:
-        RCC_AHB1ENR |= (1 << GPIO_Port_Pin.Port);
         GPIOC_MODER &= ~(3 << (2 * GPIO_Port_Pin.Pin));
         GPIOC_MODER |= (1 << (2 * GPIO_Port_Pin.Pin));
         break;
@@ -0,0 +1,186 @@
+// NVIC priority, grouping and nesting management for STM32F411x / STM32F446xx (Cortex-M4, 4 priority bits)
+
+#ifndef NVIC_DRIVER_STM32F4XX_H
+#define NVIC_DRIVER_STM32F4XX_H
+
+#include <stdint.h>
+
+/*-------------------------------------------NVIC---------------------------------------------------------*/
+
+#define NVIC_ISER(n) (*(volatile uint32_t *)(0xE000E100UL + (4U * (n)))) // set-enable    (write 1)
+#define NVIC_ICER(n) (*(volatile uint32_t *)(0xE000E180UL + (4U * (n)))) // clear-enable  (write 1)
+#define NVIC_ISPR(n) (*(volatile uint32_t *)(0xE000E200UL + (4U * (n)))) // set-pending   (write 1)
+#define NVIC_ICPR(n) (*(volatile uint32_t *)(0xE000E280UL + (4U * (n)))) // clear-pending (write 1)
+#define NVIC_IABR(n) (*(volatile uint32_t *)(0xE000E300UL + (4U * (n)))) // active bits   (read only)
+#define NVIC_IPR(n) (*(volatile uint8_t *)(0xE000E400UL + (n)))          // one priority byte per IRQ
+
+/*-------------------------------------------SCB----------------------------------------------------------*/
+
+#define SCB_AIRCR (*(volatile uint32_t *)(0xE000ED0CUL))
+#define SCB_SHPR(n) (*(volatile uint8_t *)(0xE000ED18UL + (n))) // n = exception number - 4
+
+#define SCB_AIRCR_VECTKEY (0x05FAUL << 16)
+#define SCB_AIRCR_PRIGROUP_POS 8U
+
+#define NVIC_PRIO_BITS 4U // STM32F4 implements bits [7:4] of each priority byte
+
+/*-------------------------------------------System exceptions--------------------------------------------*/
+
+#define SVCALL_EXCn 11U
+#define PENDSV_EXCn 14U
+#define SYSTICK_EXCn 15U
+
+/*-------------------------------------------Priority grouping--------------------------------------------*/
+
+// Name = <preempt bits>_<sub bits>, value = AIRCR.PRIGROUP
+typedef enum NVIC_PRIORITY_GROUP
+{
+    NVIC_GROUP_4_0 = 3, // 16 preempt levels, no sub-priority
+    NVIC_GROUP_3_1 = 4, // 8 preempt levels, 2 sub-priorities
+    NVIC_GROUP_2_2 = 5, // 4 preempt levels, 4 sub-priorities
+    NVIC_GROUP_1_3 = 6, // 2 preempt levels, 8 sub-priorities
+    NVIC_GROUP_0_4 = 7  // no preemption, 16 sub-priorities
+} NVIC_PRIORITY_GROUP;
+
+/*-------------------------------------------Priority plan------------------------------------------------
+  Grouping NVIC_GROUP_3_1: preempt 0 (most urgent) .. 7, sub-priority 0..1 breaks ties between pending IRQs.
+
+  Preempt  Sub  Owner                        Why
+  -------  ---  ---------------------------  ---------------------------------------------------------------
+  0        -    reserved, never masked       NVIC_Enter_Critical() can never block it (BASEPRI cannot mask 0)
+  1        0    TIM2 timebase (TIM2_IRQn)    ticks must preempt any slow handler so none are lost
+  2        0    DMA streams (RX / ADC)       a half/full buffer must be serviced within one buffer period
+  2        1    DMA streams (TX)             completion callbacks can wait behind RX
+  3        0    EXTI lines                   human / slow external events, handler may take longer
+  4..6     -    application / protocol IRQs
+  7        0    SysTick, PendSV              kernel housekeeping always runs last
+
+  A handler can only be preempted by an IRQ with a numerically lower preempt value.
+  Worst-case latency of a level = longest handler of every more-urgent level + its own entry (12 cycles).
+----------------------------------------------------------------------------------------------------------*/
+
+#define NVIC_PRIORITY_GROUPING NVIC_GROUP_3_1
+
+#define NVIC_PREEMPT_RESERVED 0U
+#define NVIC_PREEMPT_TIMEBASE 1U
+#define NVIC_PREEMPT_DMA 2U
+#define NVIC_PREEMPT_EXTI 3U
+#define NVIC_PREEMPT_APP 4U
+#define NVIC_PREEMPT_KERNEL 7U
+
+#define NVIC_SUB_DMA_RX 0U
+#define NVIC_SUB_DMA_TX 1U
+
+/*-------------------------------------------Grouping-----------------------------------------------------*/
+
+void NVIC_Set_Priority_Grouping(NVIC_PRIORITY_GROUP Group)
+{
+    uint32_t aircr = SCB_AIRCR;
+
+    aircr &= ~((0xFFFFUL << 16) | (7UL << SCB_AIRCR_PRIGROUP_POS));
+    aircr |= SCB_AIRCR_VECTKEY | ((uint32_t)Group << SCB_AIRCR_PRIGROUP_POS); // write ignored without VECTKEY
+    SCB_AIRCR = aircr;
+}
+
+uint32_t NVIC_Get_Priority_Grouping(void)
+{
+    return (SCB_AIRCR >> SCB_AIRCR_PRIGROUP_POS) & 7UL;
+}
+
+// Returns the 4-bit priority value (0..15) for the current grouping
+uint8_t NVIC_Encode_Priority(uint8_t Preempt, uint8_t Sub)
+{
+    uint32_t group = NVIC_Get_Priority_Grouping();
+    uint32_t preempt_bits = ((7U - group) > NVIC_PRIO_BITS) ? NVIC_PRIO_BITS : (7U - group);
+    uint32_t sub_bits = NVIC_PRIO_BITS - preempt_bits;
+
+    return (uint8_t)(((Preempt & ((1UL << preempt_bits) - 1U)) << sub_bits) |
+                     (Sub & ((1UL << sub_bits) - 1U)));
+}
+
+/*-------------------------------------------Per-IRQ control-----------------------------------------------*/
+
+void NVIC_Set_Priority(uint8_t IRQn, uint8_t Preempt, uint8_t Sub)
+{
+    NVIC_IPR(IRQn) = (uint8_t)(NVIC_Encode_Priority(Preempt, Sub) << (8U - NVIC_PRIO_BITS));
+}
+
+uint8_t NVIC_Get_Priority(uint8_t IRQn)
+{
+    return (uint8_t)(NVIC_IPR(IRQn) >> (8U - NVIC_PRIO_BITS));
+}
+
+// System exceptions (SVCall, PendSV, SysTick) live in SCB_SHPR, not in the NVIC
+void NVIC_Set_System_Priority(uint8_t Exception, uint8_t Preempt, uint8_t Sub)
+{
+    SCB_SHPR(Exception - 4U) = (uint8_t)(NVIC_Encode_Priority(Preempt, Sub) << (8U - NVIC_PRIO_BITS));
+}
+
+void NVIC_Enable_IRQ(uint8_t IRQn)
+{
+    NVIC_ISER(IRQn >> 5) = 1UL << (IRQn & 31U);
+}
+
+void NVIC_Disable_IRQ(uint8_t IRQn)
+{
+    NVIC_ICER(IRQn >> 5) = 1UL << (IRQn & 31U);
+    __asm volatile("dsb\n\tisb" ::: "memory"); // IRQ is really off before the caller continues
+}
+
+void NVIC_Set_Pending(uint8_t IRQn)
+{
+    NVIC_ISPR(IRQn >> 5) = 1UL << (IRQn & 31U);
+}
+
+void NVIC_Clear_Pending(uint8_t IRQn)
+{
+    NVIC_ICPR(IRQn >> 5) = 1UL << (IRQn & 31U);
+}
+
+uint8_t NVIC_Is_Pending(uint8_t IRQn)
+{
+    return (uint8_t)((NVIC_ISPR(IRQn >> 5) >> (IRQn & 31U)) & 1U);
+}
+
+uint8_t NVIC_Is_Active(uint8_t IRQn)
+{
+    return (uint8_t)((NVIC_IABR(IRQn >> 5) >> (IRQn & 31U)) & 1U);
+}
+
+// Priority, then enable: the IRQ never runs at the default (most urgent) level
+void NVIC_Setup_IRQ(uint8_t IRQn, uint8_t Preempt, uint8_t Sub)
+{
+    NVIC_Set_Priority(IRQn, Preempt, Sub);
+    NVIC_Clear_Pending(IRQn);
+    NVIC_Enable_IRQ(IRQn);
+}
+
+/*-------------------------------------------BASEPRI critical sections-------------------------------------*/
+
+// Masks every IRQ whose preempt level is Ceiling or less urgent; more urgent IRQs keep running.
+// BASEPRI_MAX only ever raises the mask, so nested sections cannot accidentally lower it.
+uint32_t NVIC_Enter_Critical(uint8_t Ceiling)
+{
+    uint32_t previous;
+    uint32_t basepri = (uint32_t)NVIC_Encode_Priority(Ceiling, 0) << (8U - NVIC_PRIO_BITS);
+
+    __asm volatile("mrs %0, basepri" : "=r"(previous));
+    __asm volatile("msr basepri_max, %0" ::"r"(basepri) : "memory");
+    return previous;
+}
+
+void NVIC_Exit_Critical(uint32_t Previous)
+{
+    __asm volatile("msr basepri, %0" ::"r"(Previous) : "memory");
+}
+
+/*-------------------------------------------Startup-------------------------------------------------------*/
+
+void NVIC_Init(void)
+{
+    NVIC_Set_Priority_Grouping(NVIC_PRIORITY_GROUPING);
+    NVIC_Set_System_Priority(SYSTICK_EXCn, NVIC_PREEMPT_KERNEL, 0);
+    NVIC_Set_System_Priority(PENDSV_EXCn, NVIC_PREEMPT_KERNEL, 1);
+}
+
+#endif
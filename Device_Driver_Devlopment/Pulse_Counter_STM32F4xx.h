@@ -0,0 +1,208 @@
+// Hardware pulse counter for STM32F411x / STM32F446xx: a general-purpose timer clocked by the input signal
+// ETR in external clock mode 2 (digital filter, polarity, /1../8 prescaler) or TI1 / TI2 in external clock
+// mode 1 (filter, polarity, or both edges of TI1). Every edge is a CNT increment in hardware; the CPU
+// reads CNT when it wants the count. ARR sets the wrap modulus, CCR1..4 raise callbacks at thresholds,
+// and optional wrap counting extends the count to 64 bits at one interrupt per modulus.
+// The timer is chosen at build time (PULSE_COUNTER_TIM 2..5) because the driver owns its interrupt vector.
+
+#ifndef PULSE_COUNTER_STM32F4XX_H
+#define PULSE_COUNTER_STM32F4XX_H
+
+#include <stdint.h>
+#include "GP_Timer_STM32F4xx.h"
+#include "NVIC_Driver_STM32F4xx.h"
+
+// ETR pins: TIM2 PA0 / PA5 / PA15 (AF1), TIM3 PD2 (AF2, F446RE only), TIM4 PE0 (not on these packages),
+// TIM5 none. TI1 / TI2 pins: see GP_Timer_Pin().
+#ifndef PULSE_COUNTER_TIM
+#define PULSE_COUNTER_TIM 2
+#endif
+
+#define PULSE_COUNTER_TIMER ((GP_TIMER)(PULSE_COUNTER_TIM - 2))
+#define PULSE_COUNTER_HANDLER_NAME(n) TIM##n##_IRQHandler
+#define PULSE_COUNTER_HANDLER(n) PULSE_COUNTER_HANDLER_NAME(n)
+
+typedef enum PULSE_INPUT
+{
+    PULSE_INPUT_ETR = 0,     // external clock mode 2, all 4 channels free for thresholds
+    PULSE_INPUT_TI1 = 1,     // external clock mode 1 on TI1FP1, channel 1 taken
+    PULSE_INPUT_TI2 = 2,     // external clock mode 1 on TI2FP2, channel 2 taken
+    PULSE_INPUT_TI1_BOTH = 3 // TI1F_ED: both edges of TI1, no filter on polarity
+} PULSE_INPUT;
+
+typedef void (*Pulse_Threshold_Callback_t)(uint8_t Channel, uint32_t Count);
+
+typedef struct Pulse_Counter_Config_t
+{
+    PULSE_INPUT input;
+    uint8_t falling;       // count falling edges (ETR / TI1 / TI2)
+    uint8_t filter;        // ETF / ICxF 0..15 (3 = 8 samples at f_CK_INT)
+    uint8_t etr_prescaler; // ETR only: 0 = /1, 1 = /2, 2 = /4, 3 = /8 (ETRP must stay below f_CK_INT / 4)
+    uint32_t modulus;      // counts per wrap: CNT runs 0 .. modulus - 1; 0 = full counter range
+    uint8_t extend;        // count wraps in the update interrupt for Pulse_Counter_Total()
+} Pulse_Counter_Config_t;
+
+typedef struct Pulse_Counter_t
+{
+    uint32_t modulus;
+    volatile uint32_t wraps;
+    Pulse_Threshold_Callback_t threshold[4];
+} Pulse_Counter_t;
+
+static Pulse_Counter_t Pulse_Counter;
+
+/*-------------------------------------------Init----------------------------------------------------------*/
+
+// Input pin must already be routed with GP_Timer_Pin()
+void Pulse_Counter_Init(const Pulse_Counter_Config_t *Config)
+{
+    GP_TIMER t = PULSE_COUNTER_TIMER;
+    uint32_t full = GP_Timer_Max(t);
+
+    Pulse_Counter.modulus = ((Config->modulus == 0U) || ((Config->modulus - 1U) > full)) ? 0U : Config->modulus;
+    Pulse_Counter.wraps = 0;
+
+    for (uint8_t ch = 0; ch < 4U; ch++)
+    {
+        Pulse_Counter.threshold[ch] = 0;
+    }
+
+    RCC_Clock_Enable(GP_Timer_Clock(t));
+    GP_Timer_Reset(t);
+
+    TIMx_ARR(t) = Pulse_Counter.modulus ? (Pulse_Counter.modulus - 1U) : full;
+    GP_Timer_Load_Prescaler(t, 0);
+
+    if (Config->input == PULSE_INPUT_ETR)
+    {
+        TIMx_SMCR(t) = TIM_SMCR_ECE | TIM_SMCR_ETF(Config->filter) | TIM_SMCR_ETPS(Config->etr_prescaler & 3U) |
+                       (Config->falling ? TIM_SMCR_ETP : 0U);
+    }
+    else
+    {
+        uint8_t in = (Config->input == PULSE_INPUT_TI2) ? 2U : 1U;
+        uint8_t ts = (Config->input == PULSE_INPUT_TI2)    ? TIM_TS_TI2FP2
+                     : (Config->input == PULSE_INPUT_TI1) ? TIM_TS_TI1FP1
+                                                           : TIM_TS_TI1F_ED;
+
+        TIMx_CCMR(t, in) = (TIMx_CCMR(t, in) & ~(0xFFUL << TIMx_CCMR_SHIFT(in))) |
+                           ((TIM_CCMR_CCS_INPUT | TIM_CCMR_ICF(Config->filter)) << TIMx_CCMR_SHIFT(in));
+
+        if (Config->falling)
+        {
+            TIMx_CCER(t) |= TIM_CCER_CCP(in);
+        }
+
+        TIMx_SMCR(t) = TIM_SMCR_TS(ts) | TIM_SMCR_SMS(TIM_SMS_EXT_CLOCK);
+    }
+
+    if (Config->extend)
+    {
+        TIMx_DIER(t) |= TIM_DIER_UIE;
+    }
+
+    NVIC_Setup_IRQ(GP_Timer_IRQn[t], NVIC_PREEMPT_EXTI, 0);
+    TIMx_CR1(t) = TIM_CR1_CEN;
+}
+
+void Pulse_Counter_Deinit(void)
+{
+    GP_TIMER t = PULSE_COUNTER_TIMER;
+
+    TIMx_CR1(t) = 0;
+    TIMx_DIER(t) = 0;
+    NVIC_Disable_IRQ(GP_Timer_IRQn[t]);
+    RCC_Clock_Release(GP_Timer_Clock(t));
+}
+
+/*-------------------------------------------Reading-------------------------------------------------------*/
+
+// Count since the last wrap: one register load, no CPU work ever happened for the edges
+uint32_t Pulse_Counter_Read(void)
+{
+    return TIMx_CNT(PULSE_COUNTER_TIMER);
+}
+
+// wraps * modulus + CNT without masking interrupts: if the update flag is still pending the wrap has not
+// been counted yet, and a small CNT says it happened before the read (needs extend = 1)
+uint64_t Pulse_Counter_Total(void)
+{
+    GP_TIMER t = PULSE_COUNTER_TIMER;
+    uint64_t span = Pulse_Counter.modulus ? Pulse_Counter.modulus : ((uint64_t)GP_Timer_Max(t) + 1U);
+    uint32_t wraps;
+    uint32_t count;
+    uint32_t pending;
+
+    do
+    {
+        wraps = Pulse_Counter.wraps;
+        count = TIMx_CNT(t);
+        pending = TIMx_SR(t) & TIMx_DIER(t) & TIM_SR_UIF;
+    } while (wraps != Pulse_Counter.wraps);
+
+    if (pending && (count < (span / 2U)))
+    {
+        wraps++;
+    }
+
+    return ((uint64_t)wraps * span) + count;
+}
+
+void Pulse_Counter_Reset(void)
+{
+    TIMx_CNT(PULSE_COUNTER_TIMER) = 0;
+    Pulse_Counter.wraps = 0;
+}
+
+/*-------------------------------------------Thresholds----------------------------------------------------*/
+
+// CCRx compare in frozen mode (no pin): CCxIF is set when CNT reaches Count, once per wrap.
+// Channel 1..4, not the TI input's own channel.
+void Pulse_Counter_Set_Threshold(uint8_t Channel, uint32_t Count, Pulse_Threshold_Callback_t Callback)
+{
+    GP_TIMER t = PULSE_COUNTER_TIMER;
+
+    TIMx_DIER(t) &= ~TIM_DIER_CCIE(Channel);
+    TIMx_CCMR(t, Channel) &= ~(0xFFUL << TIMx_CCMR_SHIFT(Channel)); // output, OCxM = 000 frozen
+    TIMx_CCR(t, Channel) = Count;
+    Pulse_Counter.threshold[Channel - 1U] = Callback;
+
+    TIMx_SR(t) = ~TIM_SR_CCIF(Channel);
+    TIMx_DIER(t) |= TIM_DIER_CCIE(Channel);
+}
+
+void Pulse_Counter_Clear_Threshold(uint8_t Channel)
+{
+    TIMx_DIER(PULSE_COUNTER_TIMER) &= ~TIM_DIER_CCIE(Channel);
+    Pulse_Counter.threshold[Channel - 1U] = 0;
+}
+
+/*-------------------------------------------Interrupt-----------------------------------------------------*/
+
+// Only wraps (extend) and thresholds come here; SR bits are rc_w0, so only the handled flags are cleared
+void PULSE_COUNTER_HANDLER(PULSE_COUNTER_TIM)(void)
+{
+    GP_TIMER t = PULSE_COUNTER_TIMER;
+    uint32_t sr = TIMx_SR(t) & TIMx_DIER(t);
+
+    if (sr & TIM_SR_UIF)
+    {
+        TIMx_SR(t) = ~TIM_SR_UIF;
+        Pulse_Counter.wraps++;
+    }
+
+    for (uint8_t ch = 1; ch <= 4U; ch++)
+    {
+        if (sr & TIM_SR_CCIF(ch))
+        {
+            TIMx_SR(t) = ~TIM_SR_CCIF(ch);
+
+            if (Pulse_Counter.threshold[ch - 1U])
+            {
+                Pulse_Counter.threshold[ch - 1U](ch, TIMx_CCR(t, ch));
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,263 @@
+// Reference-counted peripheral clock gating for STM32F411x / STM32F446xx
+// Every driver takes a reference on the clocks it needs and gives it back when done; the enable bit is
+// written only on the 0 -> 1 and 1 -> 0 transitions, so a clock is on exactly while someone uses it.
+// Run-mode current of a gated peripheral is its leakage only, an ungated idle timer / USART still toggles
+// its registers every bus clock.
+
+#ifndef RCC_CLOCK_MANAGER_STM32F4XX_H
+#define RCC_CLOCK_MANAGER_STM32F4XX_H
+
+#include <stdint.h>
+
+#define RCC_BASE 0x40023800UL
+#define RCC_REG(off) (*(volatile uint32_t *)(RCC_BASE + (off)))
+
+// ENR offsets per bus; the matching RSTR is 0x20 lower, LPENR 0x20 higher
+#define RCC_BUS_AHB1 0U // 0x30
+#define RCC_BUS_AHB2 1U // 0x34
+#define RCC_BUS_AHB3 2U // 0x38 (F446: FMC, QUADSPI)
+#define RCC_BUS_APB1 3U // 0x40
+#define RCC_BUS_APB2 4U // 0x44
+#define RCC_BUS_COUNT 5U
+
+#define RCC_CLK(bus, bit) (((bus) << 5) | (bit))
+#define RCC_CLK_BUS(clk) ((uint8_t)((clk) >> 5))
+#define RCC_CLK_MASK(clk) (1UL << ((clk) & 31U))
+
+typedef enum RCC_CLOCK
+{
+    RCC_CLK_GPIOA = RCC_CLK(RCC_BUS_AHB1, 0),
+    RCC_CLK_GPIOB = RCC_CLK(RCC_BUS_AHB1, 1),
+    RCC_CLK_GPIOC = RCC_CLK(RCC_BUS_AHB1, 2),
+    RCC_CLK_GPIOD = RCC_CLK(RCC_BUS_AHB1, 3),
+    RCC_CLK_GPIOE = RCC_CLK(RCC_BUS_AHB1, 4),
+    RCC_CLK_GPIOH = RCC_CLK(RCC_BUS_AHB1, 7),
+    RCC_CLK_CRC = RCC_CLK(RCC_BUS_AHB1, 12),
+    RCC_CLK_DMA1 = RCC_CLK(RCC_BUS_AHB1, 21),
+    RCC_CLK_DMA2 = RCC_CLK(RCC_BUS_AHB1, 22),
+
+    RCC_CLK_OTGFS = RCC_CLK(RCC_BUS_AHB2, 7),
+
+    RCC_CLK_TIM2 = RCC_CLK(RCC_BUS_APB1, 0),
+    RCC_CLK_TIM3 = RCC_CLK(RCC_BUS_APB1, 1),
+    RCC_CLK_TIM4 = RCC_CLK(RCC_BUS_APB1, 2),
+    RCC_CLK_TIM5 = RCC_CLK(RCC_BUS_APB1, 3),
+    RCC_CLK_TIM6 = RCC_CLK(RCC_BUS_APB1, 4), // F446
+    RCC_CLK_TIM7 = RCC_CLK(RCC_BUS_APB1, 5), // F446
+    RCC_CLK_WWDG = RCC_CLK(RCC_BUS_APB1, 11),
+    RCC_CLK_SPI2 = RCC_CLK(RCC_BUS_APB1, 14),
+    RCC_CLK_SPI3 = RCC_CLK(RCC_BUS_APB1, 15),
+    RCC_CLK_USART2 = RCC_CLK(RCC_BUS_APB1, 17),
+    RCC_CLK_I2C1 = RCC_CLK(RCC_BUS_APB1, 21),
+    RCC_CLK_I2C2 = RCC_CLK(RCC_BUS_APB1, 22),
+    RCC_CLK_I2C3 = RCC_CLK(RCC_BUS_APB1, 23),
+    RCC_CLK_CAN1 = RCC_CLK(RCC_BUS_APB1, 25), // F446
+    RCC_CLK_CAN2 = RCC_CLK(RCC_BUS_APB1, 26), // F446
+    RCC_CLK_PWR = RCC_CLK(RCC_BUS_APB1, 28),
+    RCC_CLK_DAC = RCC_CLK(RCC_BUS_APB1, 29), // F446
+
+    RCC_CLK_TIM1 = RCC_CLK(RCC_BUS_APB2, 0),
+    RCC_CLK_USART1 = RCC_CLK(RCC_BUS_APB2, 4),
+    RCC_CLK_USART6 = RCC_CLK(RCC_BUS_APB2, 5),
+    RCC_CLK_ADC1 = RCC_CLK(RCC_BUS_APB2, 8),
+    RCC_CLK_SDIO = RCC_CLK(RCC_BUS_APB2, 11),
+    RCC_CLK_SPI1 = RCC_CLK(RCC_BUS_APB2, 12),
+    RCC_CLK_SPI4 = RCC_CLK(RCC_BUS_APB2, 13),
+    RCC_CLK_SYSCFG = RCC_CLK(RCC_BUS_APB2, 14),
+    RCC_CLK_TIM9 = RCC_CLK(RCC_BUS_APB2, 16),
+    RCC_CLK_TIM10 = RCC_CLK(RCC_BUS_APB2, 17),
+    RCC_CLK_TIM11 = RCC_CLK(RCC_BUS_APB2, 18)
+} RCC_CLOCK;
+
+#define RCC_CLK_GPIO(port) ((RCC_CLOCK)RCC_CLK(RCC_BUS_AHB1, (port))) // port 0 = A .. 7 = H
+
+typedef struct RCC_Clock_Report_t
+{
+    uint32_t enabled[RCC_BUS_COUNT];   // ENR as read back from the hardware
+    uint32_t managed[RCC_BUS_COUNT];   // clocks with at least one reference
+    uint32_t unmanaged[RCC_BUS_COUNT]; // on in hardware without a reference: enabled behind the manager's back
+    uint32_t pre_enabled[RCC_BUS_COUNT]; // already on at their first Enable: never gated by the manager
+    uint8_t active;                    // number of clocks on
+    uint32_t rcc_writes;               // ENR read-modify-writes since reset
+    uint32_t fast_path;                // requests served without touching RCC
+    uint32_t unbalanced;               // releases without a reference (ignored)
+    uint32_t overflows;                // enables refused because the clock already had 255 users
+} RCC_Clock_Report_t;
+
+static const uint8_t RCC_Enr_Offset[RCC_BUS_COUNT] = {0x30, 0x34, 0x38, 0x40, 0x44};
+
+static uint8_t RCC_Users[RCC_BUS_COUNT][32];
+static uint32_t RCC_Managed[RCC_BUS_COUNT];
+static uint32_t RCC_Ensured[RCC_BUS_COUNT];
+static uint32_t RCC_Pre_Enabled[RCC_BUS_COUNT];
+static uint32_t RCC_Writes;
+static uint32_t RCC_Fast_Path;
+static uint32_t RCC_Unbalanced;
+static uint32_t RCC_Overflows;
+
+// Counts may change from any priority (a driver started from an ISR); the sections are a handful of cycles
+static inline uint32_t RCC_Lock(void)
+{
+    uint32_t primask;
+
+    __asm volatile("mrs %0, primask\n cpsid i" : "=r"(primask)::"memory");
+    return primask;
+}
+
+static inline void RCC_Unlock(uint32_t Primask)
+{
+    __asm volatile("msr primask, %0" ::"r"(Primask) : "memory");
+}
+
+/*-------------------------------------------Reference counting-------------------------------------------*/
+
+// Returns the number of users after the call, 0 if the count is full (the reference is not taken).
+// Only the first user writes ENR; the read-back is the 2-cycle delay the reference manual requires before
+// the first access. A bit that is already set then was turned on outside the manager (startup code, an
+// unconverted example): it is marked pre-enabled and left on for good, its owner never asked us to gate it.
+uint8_t RCC_Clock_Enable(RCC_CLOCK Clock)
+{
+    uint8_t bus = RCC_CLK_BUS(Clock);
+    uint32_t mask = RCC_CLK_MASK(Clock);
+    uint8_t *users = &RCC_Users[bus][Clock & 31U];
+    uint32_t primask = RCC_Lock();
+
+    if (*users == 255U)
+    {
+        RCC_Overflows++;
+        RCC_Unlock(primask);
+        return 0;
+    }
+
+    if (*users == 0U)
+    {
+        volatile uint32_t *enr = &RCC_REG(RCC_Enr_Offset[bus]);
+
+        if (*enr & mask)
+        {
+            RCC_Pre_Enabled[bus] |= mask;
+        }
+        else
+        {
+            *enr |= mask;
+            (void)*enr;
+            RCC_Writes++;
+        }
+
+        RCC_Managed[bus] |= mask;
+    }
+    else
+    {
+        RCC_Fast_Path++;
+    }
+
+    (*users)++;
+
+    uint8_t count = *users;
+    RCC_Unlock(primask);
+    return count;
+}
+
+// Last user out gates the clock, unless it was pre-enabled; register contents survive gating, so a later
+// Enable finds the peripheral as it was left (stop / disable it before releasing if it must not run on re-enable).
+uint8_t RCC_Clock_Release(RCC_CLOCK Clock)
+{
+    uint8_t bus = RCC_CLK_BUS(Clock);
+    uint32_t mask = RCC_CLK_MASK(Clock);
+    uint8_t *users = &RCC_Users[bus][Clock & 31U];
+    uint32_t primask = RCC_Lock();
+
+    if (*users == 0U)
+    {
+        RCC_Unbalanced++;
+    }
+    else if (--(*users) == 0U)
+    {
+        RCC_Managed[bus] &= ~mask;
+
+        if (!(RCC_Pre_Enabled[bus] & mask))
+        {
+            RCC_REG(RCC_Enr_Offset[bus]) &= ~mask;
+            RCC_Writes++;
+        }
+    }
+
+    uint8_t count = *users;
+    RCC_Unlock(primask);
+    return count;
+}
+
+/*-------------------------------------------Idempotent fast path----------------------------------------*/
+
+// For init functions that run more than once (GPIO_Init from every LED_Toggle): the first call takes one
+// shared reference, every further call costs a RAM load and a branch, no RCC access and no lock.
+void RCC_Clock_Ensure(RCC_CLOCK Clock)
+{
+    uint8_t bus = RCC_CLK_BUS(Clock);
+    uint32_t mask = RCC_CLK_MASK(Clock);
+
+    if (RCC_Ensured[bus] & mask)
+    {
+        return;
+    }
+
+    uint32_t primask = RCC_Lock();
+
+    if (!(RCC_Ensured[bus] & mask))
+    {
+        RCC_Ensured[bus] |= mask;
+        RCC_Clock_Enable(Clock);
+    }
+
+    RCC_Unlock(primask);
+}
+
+// Gives back the shared reference taken by RCC_Clock_Ensure()
+void RCC_Clock_Drop_Ensured(RCC_CLOCK Clock)
+{
+    uint8_t bus = RCC_CLK_BUS(Clock);
+    uint32_t mask = RCC_CLK_MASK(Clock);
+    uint32_t primask = RCC_Lock();
+
+    if (RCC_Ensured[bus] & mask)
+    {
+        RCC_Ensured[bus] &= ~mask;
+        RCC_Clock_Release(Clock);
+    }
+
+    RCC_Unlock(primask);
+}
+
+/*-------------------------------------------Queries------------------------------------------------------*/
+
+uint8_t RCC_Clock_Users(RCC_CLOCK Clock)
+{
+    return RCC_Users[RCC_CLK_BUS(Clock)][Clock & 31U];
+}
+
+uint8_t RCC_Clock_Is_On(RCC_CLOCK Clock)
+{
+    return (RCC_REG(RCC_Enr_Offset[RCC_CLK_BUS(Clock)]) & RCC_CLK_MASK(Clock)) ? 1U : 0U;
+}
+
+// Snapshot of the active clock set; unmanaged != 0 points at code that still writes ENR directly
+void RCC_Clock_Get_Report(RCC_Clock_Report_t *Report)
+{
+    Report->active = 0;
+
+    for (uint8_t bus = 0; bus < RCC_BUS_COUNT; bus++)
+    {
+        Report->enabled[bus] = RCC_REG(RCC_Enr_Offset[bus]);
+        Report->managed[bus] = RCC_Managed[bus];
+        Report->unmanaged[bus] = Report->enabled[bus] & ~RCC_Managed[bus];
+        Report->pre_enabled[bus] = RCC_Pre_Enabled[bus];
+        Report->active = (uint8_t)(Report->active + __builtin_popcount(Report->enabled[bus]));
+    }
+
+    Report->rcc_writes = RCC_Writes;
+    Report->fast_path = RCC_Fast_Path;
+    Report->unbalanced = RCC_Unbalanced;
+    Report->overflows = RCC_Overflows;
+}
+
+#endif
@@ -0,0 +1,441 @@
+// SPI1 / SPI2 / SPI3 master driver with DMA for STM32F411x / STM32F446xx
+// Work is queued as transactions made of steps (GPIO write, DMA data transfer, GPIO write, ...).
+// Steps run back to back from the RX DMA complete interrupt; the caller only submits and gets a callback.
+
+#ifndef SPI_DMA_DRIVER_STM32F4XX_H
+#define SPI_DMA_DRIVER_STM32F4XX_H
+
+#include <stdint.h>
+#include "DMA_Driver_STM32F4xx.h"
+
+/*-------------------------------Bus clocks (HSI, no prescaler)----------------------------------------------*/
+
+#ifndef APB1_CLK
+#define APB1_CLK 16000000UL
+#endif
+
+#ifndef APB2_CLK
+#define APB2_CLK 16000000UL
+#endif
+
+/*-------------------------------------------GPIO (any port)------------------------------------------------*/
+
+#define GPIOx_BASE(p) (0x40020000UL + (0x400UL * (p))) // p = 0 -> GPIOA, 1 -> GPIOB, ...
+#define GPIOx_MODER(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x00))
+#define GPIOx_OSPEEDR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x08))
+#define GPIOx_BSRR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x18))
+#define GPIOx_AFR(p, n) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x20 + (4U * ((n) >> 3)))) // AFRL / AFRH
+
+/*-------------------------------------------SPI------------------------------------------------------------*/
+
+#define SPI1_BASE 0x40013000UL
+#define SPI2_BASE 0x40003800UL
+#define SPI3_BASE 0x40003C00UL
+
+#define SPI_CR1(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x00))
+#define SPI_CR2(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x04))
+#define SPI_SR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x08))
+#define SPI_DR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x0C))
+
+#define SPI_CR1_CPHA (1U << 0)
+#define SPI_CR1_CPOL (1U << 1)
+#define SPI_CR1_MSTR (1U << 2)
+#define SPI_CR1_BR(n) ((uint32_t)(n) << 3) // f_SCK = f_PCLK / 2^(n + 1)
+#define SPI_CR1_SPE (1U << 6)
+#define SPI_CR1_LSBFIRST (1U << 7)
+#define SPI_CR1_SSI (1U << 8)
+#define SPI_CR1_SSM (1U << 9)
+
+#define SPI_CR2_RXDMAEN (1U << 0)
+#define SPI_CR2_TXDMAEN (1U << 1)
+
+typedef enum SPI_PORTS
+{
+    SPI_1 = 0, // PA5 SCK / PA6 MISO / PA7 MOSI, AF5, APB2
+    SPI_2 = 1, // PB13 SCK / PB14 MISO / PB15 MOSI, AF5, APB1
+    SPI_3 = 2  // PB3 SCK / PB4 MISO / PB5 MOSI, AF6, APB1
+} SPI_PORTS;
+
+// CPOL (bit 1) and CPHA (bit 0) exactly as in CR1
+typedef enum SPI_MODE
+{
+    SPI_MODE_0 = 0, // idle low, sample on rising edge
+    SPI_MODE_1 = 1,
+    SPI_MODE_2 = 2,
+    SPI_MODE_3 = 3
+} SPI_MODE;
+
+typedef enum SPI_STATUS
+{
+    SPI_OK = 0,
+    SPI_BUSY = 1
+} SPI_STATUS;
+
+/*-------------------------------------------Transactions----------------------------------------------------*/
+
+typedef enum SPI_STEP_TYPE
+{
+    SPI_STEP_GPIO = 0, // one BSRR store: chip select, latch edge, D/C line, ...
+    SPI_STEP_DATA = 1  // full-duplex DMA transfer; Tx = 0 sends 0xFF, Rx = 0 discards
+} SPI_STEP_TYPE;
+
+typedef struct SPI_Step_t
+{
+    SPI_STEP_TYPE type;
+    uint16_t length;
+    volatile uint32_t *bsrr;
+    uint32_t bsrr_word;
+    const uint8_t *tx;
+    uint8_t *rx;
+} SPI_Step_t;
+
+#define SPI_STEP_PIN_HIGH(port, pin) {SPI_STEP_GPIO, 0, &GPIOx_BSRR(port), (1UL << (pin)), 0, 0}
+#define SPI_STEP_PIN_LOW(port, pin) {SPI_STEP_GPIO, 0, &GPIOx_BSRR(port), (1UL << ((pin) + 16U)), 0, 0}
+#define SPI_STEP_TRANSFER(tx, rx, length) {SPI_STEP_DATA, (length), 0, 0, (tx), (rx)}
+
+typedef struct SPI_Transaction_t SPI_Transaction_t;
+typedef void (*SPI_Callback_t)(SPI_Transaction_t *Transaction);
+
+// Caller-owned; must stay valid until Done is called. Queued by linking, no copies, no allocation.
+struct SPI_Transaction_t
+{
+    const SPI_Step_t *steps;
+    uint8_t count;
+    SPI_Callback_t done;
+    void *context;
+    SPI_Transaction_t *next;
+};
+
+typedef struct SPI_Port_t
+{
+    uint32_t base;
+    DMA_CONTROLLER dma;
+    uint8_t rx_stream;
+    uint8_t tx_stream;
+    uint8_t channel;
+    uint8_t gpio_port;
+    uint8_t sck_pin; // MISO = SCK + 1, MOSI = SCK + 2 on all three ports
+    uint8_t af;
+
+    SPI_Transaction_t *head;
+    SPI_Transaction_t *tail;
+    uint8_t step;
+    volatile uint8_t running;
+    uint8_t dummy_tx;
+    uint8_t dummy_rx;
+    volatile uint32_t errors;
+} SPI_Port_t;
+
+// DMA request mapping (RM0383 / RM0390): SPI1 DMA2 S0/S3 ch3, SPI2 DMA1 S3/S4 ch0, SPI3 DMA1 S0/S5 ch0
+static SPI_Port_t SPI_Ports[3] =
+{
+    {SPI1_BASE, DMA_2, 0, 3, 3, 0, 5, 5, 0, 0, 0, 0, 0xFF, 0, 0},
+    {SPI2_BASE, DMA_1, 3, 4, 0, 1, 13, 5, 0, 0, 0, 0, 0xFF, 0, 0},
+    {SPI3_BASE, DMA_1, 0, 5, 0, 1, 3, 6, 0, 0, 0, 0, 0xFF, 0, 0},
+};
+
+/*-------------------------------------------Engine---------------------------------------------------------*/
+
+// One data step: RX stream first (it must be ready for the first received byte), then TX
+void SPI_Start_Data(SPI_Port_t *Spi, const SPI_Step_t *Step)
+{
+    if (Step->rx)
+    {
+        DMA_SxCR(Spi->dma, Spi->rx_stream) |= DMA_CR_MINC;
+    }
+    else
+    {
+        DMA_SxCR(Spi->dma, Spi->rx_stream) &= ~DMA_CR_MINC;
+    }
+
+    if (Step->tx)
+    {
+        DMA_SxCR(Spi->dma, Spi->tx_stream) |= DMA_CR_MINC;
+    }
+    else
+    {
+        DMA_SxCR(Spi->dma, Spi->tx_stream) &= ~DMA_CR_MINC;
+    }
+
+    DMA_Stream_Start(Spi->dma, Spi->rx_stream, Step->rx ? Step->rx : &Spi->dummy_rx, Step->length);
+    DMA_Stream_Start(Spi->dma, Spi->tx_stream, Step->tx ? Step->tx : &Spi->dummy_tx, Step->length);
+}
+
+// Executes GPIO steps inline and stops at the next data step; called again from the RX DMA complete.
+// Runs at NVIC_PREEMPT_DMA, or from SPI_Submit with that level masked.
+void SPI_Run(SPI_Port_t *Spi)
+{
+    Spi->running = 1;
+
+    while (Spi->head)
+    {
+        SPI_Transaction_t *t = Spi->head;
+
+        if (Spi->step < t->count)
+        {
+            const SPI_Step_t *step = &t->steps[Spi->step++];
+
+            if (step->type == SPI_STEP_GPIO)
+            {
+                *step->bsrr = step->bsrr_word;
+            }
+            else if (step->length)
+            {
+                SPI_Start_Data(Spi, step);
+                return; // resumed by SPI_Rx_DMA_Callback
+            }
+
+            continue;
+        }
+
+        // Transaction complete: unlink before the callback, which may submit again
+        Spi->head = t->next;
+
+        if (Spi->head == 0)
+        {
+            Spi->tail = 0;
+        }
+
+        Spi->step = 0;
+        t->next = 0;
+
+        if (t->done)
+        {
+            t->done(t);
+        }
+    }
+
+    Spi->running = 0;
+}
+
+// RX complete = last bit really clocked (TX complete only means the last byte entered the shift register),
+// so a chip select or latch step that follows never cuts the transfer short.
+void SPI_Rx_DMA_Callback(void *Context, uint8_t Flags)
+{
+    SPI_Port_t *spi = (SPI_Port_t *)Context;
+
+    if (Flags & DMA_FLAG_TE)
+    {
+        spi->errors++;
+    }
+
+    if (Flags & (DMA_FLAG_TC | DMA_FLAG_TE))
+    {
+        SPI_Run(spi);
+    }
+}
+
+/*-------------------------------------------API------------------------------------------------------------*/
+
+// Appends to the port's queue and starts it if idle. Safe from main and from any callback.
+void SPI_Submit(SPI_PORTS Port, SPI_Transaction_t *Transaction)
+{
+    SPI_Port_t *spi = &SPI_Ports[Port];
+    uint32_t state = NVIC_Enter_Critical(NVIC_PREEMPT_DMA);
+
+    Transaction->next = 0;
+
+    if (spi->tail)
+    {
+        spi->tail->next = Transaction;
+    }
+    else
+    {
+        spi->head = Transaction;
+    }
+
+    spi->tail = Transaction;
+
+    if (!spi->running)
+    {
+        SPI_Run(spi);
+    }
+
+    NVIC_Exit_Critical(state);
+}
+
+uint8_t SPI_Idle(SPI_PORTS Port)
+{
+    return (uint8_t)(SPI_Ports[Port].running == 0U);
+}
+
+// Highest SCK not above Max_Hz: f_PCLK / 2, / 4, ... / 256
+void SPI_Init(SPI_PORTS Port, uint32_t Max_Hz, SPI_MODE Mode, uint8_t Lsb_First)
+{
+    SPI_Port_t *spi = &SPI_Ports[Port];
+    uint32_t clock = (Port == SPI_1) ? APB2_CLK : APB1_CLK;
+    uint32_t br = 0;
+
+    switch (Port)
+    {
+    case SPI_1:
+        RCC_Clock_Ensure(RCC_CLK_SPI1);
+        break;
+
+    case SPI_2:
+        RCC_Clock_Ensure(RCC_CLK_SPI2);
+        break;
+
+    case SPI_3:
+        RCC_Clock_Ensure(RCC_CLK_SPI3);
+        break;
+
+    default:
+        return;
+    }
+
+    while ((br < 7U) && ((clock >> (br + 1U)) > Max_Hz))
+    {
+        br++;
+    }
+
+    // SCK, MISO, MOSI in alternate function mode, high speed on SCK / MOSI
+    RCC_Clock_Ensure(RCC_CLK_GPIO(spi->gpio_port));
+
+    for (uint8_t pin = spi->sck_pin; pin <= (uint8_t)(spi->sck_pin + 2U); pin++)
+    {
+        GPIOx_AFR(spi->gpio_port, pin) &= ~(0xFUL << (4U * (pin & 7U)));
+        GPIOx_AFR(spi->gpio_port, pin) |= ((uint32_t)spi->af << (4U * (pin & 7U)));
+        GPIOx_MODER(spi->gpio_port) &= ~(3UL << (2U * pin));
+        GPIOx_MODER(spi->gpio_port) |= (2UL << (2U * pin));
+        GPIOx_OSPEEDR(spi->gpio_port) |= (2UL << (2U * pin));
+    }
+
+    spi->head = 0;
+    spi->tail = 0;
+    spi->step = 0;
+    spi->running = 0;
+    spi->errors = 0;
+
+    // Software NSS held high: chip selects are GPIO steps, so any number of devices share the bus
+    SPI_CR1(spi->base) = 0;
+    SPI_CR2(spi->base) = SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN;
+
+    DMA_Stream_Init(spi->dma, spi->rx_stream,
+                    DMA_CR_CHSEL(spi->channel) | DMA_CR_DIR_P2M | DMA_CR_PL(3) | DMA_CR_TCIE | DMA_CR_TEIE,
+                    0, &SPI_DR(spi->base), SPI_Rx_DMA_Callback, spi, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+
+    DMA_Stream_Init(spi->dma, spi->tx_stream, DMA_CR_CHSEL(spi->channel) | DMA_CR_DIR_M2P | DMA_CR_PL(2),
+                    0, &SPI_DR(spi->base), 0, 0, 0, 0);
+
+    SPI_CR1(spi->base) = SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI | SPI_CR1_BR(br) | (uint32_t)Mode |
+                         (Lsb_First ? SPI_CR1_LSBFIRST : 0U) | SPI_CR1_SPE;
+}
+
+/*-------------------------------------------Shift-register output expander----------------------------------
+  N outputs through daisy-chained 74HC595 (SER = MOSI, SRCLK = SCK, RCLK = latch GPIO), SPI mode 0, MSB first.
+  One refresh = one transaction: DMA the framebuffer, latch high, latch low. The byte sent first ends up in
+  the register farthest from the MCU, so output n is bit (n % 8) of frame[Bytes - 1 - n / 8].
+----------------------------------------------------------------------------------------------------------*/
+
+typedef struct Expander_t
+{
+    SPI_PORTS port;
+    uint8_t *frame;
+    uint16_t bytes;
+    SPI_Step_t steps[3];
+    SPI_Transaction_t transaction;
+    volatile uint8_t queued;
+    volatile uint8_t auto_refresh;
+    volatile uint32_t refreshes;
+} Expander_t;
+
+#define EXPANDER_BYTES(outputs) (((outputs) + 7U) / 8U)
+
+void Expander_Done(SPI_Transaction_t *Transaction)
+{
+    Expander_t *exp = (Expander_t *)Transaction->context;
+
+    exp->refreshes++;
+
+    if (exp->auto_refresh)
+    {
+        SPI_Submit(exp->port, Transaction); // back to back: the chain is rewritten as fast as the bus allows
+    }
+    else
+    {
+        exp->queued = 0;
+    }
+}
+
+// Frame must hold EXPANDER_BYTES(Outputs) bytes. The SPI port is initialised separately (SPI_Init).
+void Expander_Init(Expander_t *Exp, SPI_PORTS Port, uint8_t *Frame, uint16_t Outputs, uint8_t Latch_Port,
+                   uint8_t Latch_Pin)
+{
+    const SPI_Step_t data = SPI_STEP_TRANSFER(Frame, 0, EXPANDER_BYTES(Outputs));
+    const SPI_Step_t latch_high = SPI_STEP_PIN_HIGH(Latch_Port, Latch_Pin);
+    const SPI_Step_t latch_low = SPI_STEP_PIN_LOW(Latch_Port, Latch_Pin);
+
+    Exp->port = Port;
+    Exp->frame = Frame;
+    Exp->bytes = EXPANDER_BYTES(Outputs);
+    Exp->steps[0] = data;
+    Exp->steps[1] = latch_high; // RCLK rising edge copies the shift registers to the outputs
+    Exp->steps[2] = latch_low;
+    Exp->transaction.steps = Exp->steps;
+    Exp->transaction.count = 3;
+    Exp->transaction.done = Expander_Done;
+    Exp->transaction.context = Exp;
+    Exp->transaction.next = 0;
+    Exp->queued = 0;
+    Exp->auto_refresh = 0;
+    Exp->refreshes = 0;
+
+    for (uint16_t i = 0; i < Exp->bytes; i++)
+    {
+        Frame[i] = 0;
+    }
+
+    RCC_Clock_Ensure(RCC_CLK_GPIO(Latch_Port));
+    GPIOx_BSRR(Latch_Port) = (1UL << (Latch_Pin + 16U));
+    GPIOx_MODER(Latch_Port) &= ~(3UL << (2U * Latch_Pin));
+    GPIOx_MODER(Latch_Port) |= (1UL << (2U * Latch_Pin));
+}
+
+void Expander_Set(Expander_t *Exp, uint16_t Output, uint8_t Value)
+{
+    uint8_t *byte = &Exp->frame[Exp->bytes - 1U - (Output >> 3)];
+    uint8_t mask = (uint8_t)(1U << (Output & 7U));
+
+    if (Value)
+    {
+        *byte |= mask;
+    }
+    else
+    {
+        *byte &= (uint8_t)~mask;
+    }
+}
+
+uint8_t Expander_Get(const Expander_t *Exp, uint16_t Output)
+{
+    return (uint8_t)((Exp->frame[Exp->bytes - 1U - (Output >> 3)] >> (Output & 7U)) & 1U);
+}
+
+// One refresh; ignored while the previous one is still queued (it will pick up the new frame anyway)
+void Expander_Refresh(Expander_t *Exp)
+{
+    uint32_t state = NVIC_Enter_Critical(NVIC_PREEMPT_DMA);
+
+    if (!Exp->queued)
+    {
+        Exp->queued = 1;
+        SPI_Submit(Exp->port, &Exp->transaction);
+    }
+
+    NVIC_Exit_Critical(state);
+}
+
+// Continuous refresh driven entirely by the DMA complete interrupt. A frame written by the application
+// reaches the outputs within two refresh periods; a refresh can show a half-updated frame for one period.
+void Expander_Auto_Refresh(Expander_t *Exp, uint8_t Enable)
+{
+    Exp->auto_refresh = Enable;
+
+    if (Enable)
+    {
+        Expander_Refresh(Exp);
+    }
+}
+
+#endif
@@ -0,0 +1,304 @@
+// Software PWM on up to 32 arbitrary GPIO pins from one general-purpose timer (STM32F411x / STM32F446xx)
+// The duties are turned into a list of edges sorted by tick. Each entry holds the combined BSRR word per
+// port for every pin that switches at that tick, so the CC1 interrupt applies one entry with one store
+// per port. Interrupts per period = distinct duty values + 1 (period start), not pins x steps.
+// Two edge lists: Soft_PWM_Commit() rebuilds the idle one only when a duty changed, and the interrupt
+// switches to it at the next period start, so a period never mixes old and new duties.
+// The timer is chosen at build time (SOFT_PWM_TIM 2..5) because the driver owns its interrupt vector.
+
+#ifndef SOFT_PWM_STM32F4XX_H
+#define SOFT_PWM_STM32F4XX_H
+
+#include <stdint.h>
+#include "GP_Timer_STM32F4xx.h"
+#include "NVIC_Driver_STM32F4xx.h"
+
+#ifndef SOFT_PWM_TIM
+#define SOFT_PWM_TIM 3
+#endif
+
+#ifndef SOFT_PWM_MAX_CHANNELS
+#define SOFT_PWM_MAX_CHANNELS 32U
+#endif
+
+// GPIOA..GPIOC; every edge entry carries one BSRR word per port
+#ifndef SOFT_PWM_PORTS
+#define SOFT_PWM_PORTS 3U
+#endif
+
+// An edge this close to CNT is not scheduled through CCR1 (the match could be missed), the ISR waits for it
+#ifndef SOFT_PWM_GUARD_TICKS
+#define SOFT_PWM_GUARD_TICKS 1U
+#endif
+
+#define SOFT_PWM_TIMER ((GP_TIMER)(SOFT_PWM_TIM - 2))
+#define SOFT_PWM_HANDLER_NAME(n) TIM##n##_IRQHandler
+#define SOFT_PWM_HANDLER(n) SOFT_PWM_HANDLER_NAME(n)
+
+#define GPIOx_BSRR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x18))
+
+typedef struct Soft_PWM_Edge_t
+{
+    uint32_t tick;
+    uint32_t bsrr[SOFT_PWM_PORTS]; // 0 = no pin of this port switches here
+} Soft_PWM_Edge_t;
+
+typedef struct Soft_PWM_t
+{
+    uint8_t port[SOFT_PWM_MAX_CHANNELS];
+    uint8_t pin[SOFT_PWM_MAX_CHANNELS];
+    uint16_t duty[SOFT_PWM_MAX_CHANNELS];
+    uint8_t channels;
+    uint16_t steps;
+    uint8_t dirty;
+
+    // [list][entry]: entry 0 is the period start (tick 0), then one entry per distinct duty
+    Soft_PWM_Edge_t edges[2][SOFT_PWM_MAX_CHANNELS + 1U];
+    uint8_t count[2];
+    volatile uint8_t active;
+    volatile uint8_t pending; // idle list is complete and waits for the next period start
+    uint8_t next;
+
+    volatile uint32_t periods;
+    volatile uint32_t interrupts;
+} Soft_PWM_t;
+
+static Soft_PWM_t Soft_PWM;
+
+/*-------------------------------------------Init----------------------------------------------------------*/
+
+// Steps = duty resolution; the timer ticks at Pwm_Hz * Steps and must be slower than one ISR run
+// (200 Hz x 250 steps = 50 kHz: 20 us per tick). Timer_Clock / (Pwm_Hz * Steps) must be an integer.
+void Soft_PWM_Init(uint32_t Timer_Clock, uint32_t Pwm_Hz, uint16_t Steps)
+{
+    GP_TIMER t = SOFT_PWM_TIMER;
+
+    Soft_PWM.channels = 0;
+    Soft_PWM.steps = Steps;
+    Soft_PWM.dirty = 1;
+    Soft_PWM.count[0] = 0;
+    Soft_PWM.count[1] = 0;
+    Soft_PWM.active = 0;
+    Soft_PWM.pending = 0;
+    Soft_PWM.next = 0;
+
+    RCC_Clock_Enable(GP_Timer_Clock(t));
+    GP_Timer_Reset(t);
+
+    TIMx_ARR(t) = Steps - 1U;
+    GP_Timer_Load_Prescaler(t, (Timer_Clock / (Pwm_Hz * Steps)) - 1U);
+    TIMx_CCR(t, 1) = 0; // CC1 in frozen output mode (CCMR reset value): the match only raises CC1IF
+
+    NVIC_Setup_IRQ(GP_Timer_IRQn[t], NVIC_PREEMPT_APP, 0);
+}
+
+// Pin as push-pull output, low; returns the channel number for Soft_PWM_Set_Duty()
+uint8_t Soft_PWM_Add_Channel(uint8_t Port, uint8_t Pin)
+{
+    uint8_t ch = Soft_PWM.channels;
+
+    if ((ch >= SOFT_PWM_MAX_CHANNELS) || (Port >= SOFT_PWM_PORTS))
+    {
+        return 0xFFU;
+    }
+
+    RCC_Clock_Ensure(RCC_CLK_GPIO(Port));
+    GPIOx_BSRR(Port) = 1UL << (Pin + 16U);
+    GPIOx_MODER(Port) = (GPIOx_MODER(Port) & ~(3UL << (2U * Pin))) | (1UL << (2U * Pin));
+
+    Soft_PWM.port[ch] = Port;
+    Soft_PWM.pin[ch] = Pin;
+    Soft_PWM.duty[ch] = 0;
+    Soft_PWM.channels = ch + 1U;
+    Soft_PWM.dirty = 1;
+
+    return ch;
+}
+
+/*-------------------------------------------Duties--------------------------------------------------------*/
+
+// 0 = off, Steps = always on. Takes effect at Soft_PWM_Commit().
+void Soft_PWM_Set_Duty(uint8_t Channel, uint16_t Duty)
+{
+    if (Channel >= Soft_PWM.channels)
+    {
+        return; // includes 0xFF from a failed Soft_PWM_Add_Channel()
+    }
+
+    if (Duty > Soft_PWM.steps)
+    {
+        Duty = Soft_PWM.steps;
+    }
+
+    if (Soft_PWM.duty[Channel] != Duty)
+    {
+        Soft_PWM.duty[Channel] = Duty;
+        Soft_PWM.dirty = 1;
+    }
+}
+
+// Sort channels by duty (insertion sort: at most 32 entries, nearly sorted between frames) and merge
+// equal duties into one entry: period start sets every pin with a duty, each entry resets its pins.
+static void Soft_PWM_Build(Soft_PWM_Edge_t *List, uint8_t *Count)
+{
+    uint8_t order[SOFT_PWM_MAX_CHANNELS];
+    uint8_t n = 0;
+
+    for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+    {
+        List[0].bsrr[p] = 0;
+    }
+
+    List[0].tick = 0;
+
+    for (uint8_t ch = 0; ch < Soft_PWM.channels; ch++)
+    {
+        uint16_t duty = Soft_PWM.duty[ch];
+        uint8_t i = n;
+
+        List[0].bsrr[Soft_PWM.port[ch]] |= (duty == 0U) ? (1UL << (Soft_PWM.pin[ch] + 16U))
+                                                         : (1UL << Soft_PWM.pin[ch]);
+
+        if ((duty == 0U) || (duty >= Soft_PWM.steps))
+        {
+            continue; // no edge inside the period
+        }
+
+        while ((i > 0U) && (Soft_PWM.duty[order[i - 1U]] > duty))
+        {
+            order[i] = order[i - 1U];
+            i--;
+        }
+
+        order[i] = ch;
+        n++;
+    }
+
+    *Count = 1;
+
+    for (uint8_t k = 0; k < n; k++)
+    {
+        uint8_t ch = order[k];
+        Soft_PWM_Edge_t *edge = &List[*Count - 1U];
+
+        if (edge->tick != Soft_PWM.duty[ch])
+        {
+            edge = &List[(*Count)++];
+            edge->tick = Soft_PWM.duty[ch];
+
+            for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+            {
+                edge->bsrr[p] = 0;
+            }
+        }
+
+        edge->bsrr[Soft_PWM.port[ch]] |= 1UL << (Soft_PWM.pin[ch] + 16U);
+    }
+}
+
+// Rebuild the idle list if any duty changed; returns 0 while the previous commit is still waiting
+// for its period start (call again next frame).
+uint8_t Soft_PWM_Commit(void)
+{
+    uint8_t idle = Soft_PWM.active ^ 1U;
+
+    if (Soft_PWM.pending)
+    {
+        return 0;
+    }
+
+    if (Soft_PWM.dirty)
+    {
+        Soft_PWM.dirty = 0;
+        Soft_PWM_Build(Soft_PWM.edges[idle], &Soft_PWM.count[idle]);
+
+        // edges[] / count[] are not volatile: keep the compiler from sinking their stores past the flag.
+        // Same core as the ISR, so program order is all that is needed (no dmb).
+        __asm volatile("" ::: "memory");
+        Soft_PWM.pending = 1; // published last: the ISR only looks at the idle list after this store
+    }
+
+    return 1;
+}
+
+void Soft_PWM_Start(void)
+{
+    GP_TIMER t = SOFT_PWM_TIMER;
+
+    Soft_PWM_Commit();
+
+    Soft_PWM.next = 0;
+    TIMx_CCR(t, 1) = 0;
+    TIMx_SR(t) = ~TIM_SR_CCIF(1);
+    TIMx_DIER(t) |= TIM_DIER_CCIE(1);
+    TIMx_EGR(t) = TIM_EGR_UG;
+    TIMx_CR1(t) = TIM_CR1_CEN; // pins stay low until the first match on tick 0 applies the period start
+}
+
+void Soft_PWM_Stop(void)
+{
+    GP_TIMER t = SOFT_PWM_TIMER;
+
+    TIMx_CR1(t) = 0;
+    TIMx_DIER(t) = 0;
+
+    for (uint8_t ch = 0; ch < Soft_PWM.channels; ch++)
+    {
+        GPIOx_BSRR(Soft_PWM.port[ch]) = 1UL << (Soft_PWM.pin[ch] + 16U);
+    }
+}
+
+// Edge interrupts per period of the list in use (1 = all pins static)
+uint8_t Soft_PWM_Edges_Per_Period(void)
+{
+    return Soft_PWM.count[Soft_PWM.active];
+}
+
+/*-------------------------------------------Interrupt-----------------------------------------------------*/
+
+// Apply the due entry, then schedule the next one on CC1. An edge within the guard window is waited
+// for here instead; after the last entry CCR1 = 0 matches at the next period start.
+void SOFT_PWM_HANDLER(SOFT_PWM_TIM)(void)
+{
+    GP_TIMER t = SOFT_PWM_TIMER;
+    const Soft_PWM_Edge_t *edge;
+    uint32_t tick;
+
+    TIMx_SR(t) = ~TIM_SR_CCIF(1);
+    Soft_PWM.interrupts++;
+
+    do
+    {
+        if (Soft_PWM.next == 0U)
+        {
+            if (Soft_PWM.pending)
+            {
+                Soft_PWM.active ^= 1U;
+                Soft_PWM.pending = 0;
+            }
+
+            Soft_PWM.periods++;
+        }
+
+        edge = &Soft_PWM.edges[Soft_PWM.active][Soft_PWM.next];
+
+        while ((TIMx_CNT(t) < edge->tick) && ((edge->tick - TIMx_CNT(t)) <= SOFT_PWM_GUARD_TICKS))
+        {
+        }
+
+        for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+        {
+            if (edge->bsrr[p])
+            {
+                GPIOx_BSRR(p) = edge->bsrr[p];
+            }
+        }
+
+        Soft_PWM.next = ((Soft_PWM.next + 1U) < Soft_PWM.count[Soft_PWM.active]) ? (Soft_PWM.next + 1U) : 0U;
+        tick = Soft_PWM.edges[Soft_PWM.active][Soft_PWM.next].tick;
+    } while ((Soft_PWM.next != 0U) && (tick <= (TIMx_CNT(t) + SOFT_PWM_GUARD_TICKS)));
+
+    TIMx_CCR(t, 1) = tick;
+}
+
+#endif
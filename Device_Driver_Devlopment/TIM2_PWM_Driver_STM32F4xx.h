@@ -0,0 +1,129 @@
+// TIM2 PWM output driver for STM32F411x / STM32F446xx
+// Timer is configured once and never stopped; outputs switch between static level and PWM
+// by rewriting only the OCxM field (force inactive / force active / PWM mode 1) or one MODER field.
+
+#ifndef TIM2_PWM_DRIVER_STM32F4XX_H
+#define TIM2_PWM_DRIVER_STM32F4XX_H
+
+#include <stdint.h>
+#include "RCC_Clock_Manager_STM32F4xx.h"
+
+/*-------------------------------------------GPIOA--------------------------------------------------------*/
+
+#define GPIOA_BASE 0x40020000UL
+#define GPIOA_MODER (*(volatile uint32_t *)(GPIOA_BASE + 0x00))
+#define GPIOA_BSRR (*(volatile uint32_t *)(GPIOA_BASE + 0x18))
+#define GPIOA_AFRL (*(volatile uint32_t *)(GPIOA_BASE + 0x20))
+#define GPIOA_AFRH (*(volatile uint32_t *)(GPIOA_BASE + 0x24))
+
+#define GPIO_MODE_OUTPUT 1U
+#define GPIO_MODE_AF 2U
+#define GPIO_AF1_TIM2 1U
+
+/*-------------------------------------------TIM2---------------------------------------------------------*/
+
+#define TIM2_BASE 0x40000000UL
+#define TIM2_CR1 (*(volatile uint32_t *)(TIM2_BASE + 0x00))
+#define TIM2_EGR (*(volatile uint32_t *)(TIM2_BASE + 0x14))
+#define TIM2_CCMR1 (*(volatile uint32_t *)(TIM2_BASE + 0x18))
+#define TIM2_CCMR2 (*(volatile uint32_t *)(TIM2_BASE + 0x1C))
+#define TIM2_CCER (*(volatile uint32_t *)(TIM2_BASE + 0x20))
+#define TIM2_CNT (*(volatile uint32_t *)(TIM2_BASE + 0x24))
+#define TIM2_PSC (*(volatile uint32_t *)(TIM2_BASE + 0x28))
+#define TIM2_ARR (*(volatile uint32_t *)(TIM2_BASE + 0x2C))
+#define TIM2_CCR(ch) (*(volatile uint32_t *)(TIM2_BASE + 0x34 + (4U * ((ch) - 1U)))) // ch = 1..4
+
+#define TIM2_CCMR(ch) (*(volatile uint32_t *)(TIM2_BASE + (((ch) <= 2U) ? 0x18 : 0x1C)))
+#define TIM2_OCM_SHIFT(ch) ((((ch) - 1U) & 1U) ? 12U : 4U) // OC1M/OC3M bits 6:4, OC2M/OC4M bits 14:12
+#define TIM2_OCPE_SHIFT(ch) ((((ch) - 1U) & 1U) ? 11U : 3U)
+
+#define TIM_CR1_CEN (1U << 0)
+#define TIM_CR1_ARPE (1U << 7)
+#define TIM_EGR_UG (1U << 0)
+
+typedef enum PWM_OUTPUT_MODE
+{
+    PWM_OUT_FORCE_INACTIVE = 4, // OCxREF forced low  -> LED off
+    PWM_OUT_FORCE_ACTIVE = 5,   // OCxREF forced high -> LED on
+    PWM_OUT_PWM1 = 6            // high while CNT < CCRx
+} PWM_OUTPUT_MODE;
+
+/*-------------------------------------------Init (once)--------------------------------------------------*/
+
+void PWM_Output_Init(uint32_t Prescaler, uint32_t Period)
+{
+    RCC_Clock_Enable(RCC_CLK_TIM2);
+
+    TIM2_PSC = Prescaler;
+    TIM2_ARR = Period;
+
+    TIM2_CR1 |= TIM_CR1_ARPE;
+    TIM2_EGR = TIM_EGR_UG;   // load PSC / ARR
+    TIM2_CR1 |= TIM_CR1_CEN; // runs from here on, mode changes never stop it
+}
+
+// Pin must carry TIM2_CHx on AF1 (PA0/PA5/PA15 = CH1, PA1 = CH2, PA2 = CH3, PA3 = CH4)
+void PWM_Output_Channel_Init(uint8_t Channel, uint8_t Pin)
+{
+    RCC_Clock_Ensure(RCC_CLK_GPIOA);
+
+    if (Pin < 8U)
+    {
+        GPIOA_AFRL &= ~(0xFUL << (4U * Pin));
+        GPIOA_AFRL |= (GPIO_AF1_TIM2 << (4U * Pin));
+    }
+    else
+    {
+        GPIOA_AFRH &= ~(0xFUL << (4U * (Pin - 8U)));
+        GPIOA_AFRH |= (GPIO_AF1_TIM2 << (4U * (Pin - 8U)));
+    }
+
+    GPIOA_MODER &= ~(3UL << (2U * Pin));
+    GPIOA_MODER |= (GPIO_MODE_AF << (2U * Pin));
+
+    TIM2_CCR(Channel) = 0;
+    TIM2_CCMR(Channel) &= ~(0xFFUL << (TIM2_OCM_SHIFT(Channel) - 4U));
+    TIM2_CCMR(Channel) |= ((uint32_t)PWM_OUT_FORCE_INACTIVE << TIM2_OCM_SHIFT(Channel)) |
+                          (1UL << TIM2_OCPE_SHIFT(Channel)); // CCR preload: duty changes at update only
+
+    TIM2_CCER |= (1UL << (4U * (Channel - 1U))); // CCxE
+}
+
+// Stops the counter and gives the TIM2 clock back; outputs must be parked first (forced low or GPIO)
+void PWM_Output_Deinit(void)
+{
+    TIM2_CR1 &= ~TIM_CR1_CEN;
+    RCC_Clock_Release(RCC_CLK_TIM2);
+}
+
+/*-------------------------------------------Mode switching (a few cycles)----------------------------------*/
+
+// OCxM is not preloaded: the new mode applies on the next timer clock, CNT keeps running,
+// so returning to PWM continues at the same phase and duty.
+void PWM_Output_Set_Mode(uint8_t Channel, PWM_OUTPUT_MODE Mode)
+{
+    uint32_t shift = TIM2_OCM_SHIFT(Channel);
+    uint32_t ccmr = TIM2_CCMR(Channel);
+
+    ccmr &= ~(7UL << shift);
+    ccmr |= ((uint32_t)Mode << shift);
+    TIM2_CCMR(Channel) = ccmr;
+}
+
+void PWM_Output_Set_Duty(uint8_t Channel, uint8_t Percent)
+{
+    TIM2_CCR(Channel) = ((TIM2_ARR + 1U) * Percent) / 100U;
+}
+
+// Alternative path: hand the pin to ODR/BSRR (one MODER field) while the channel keeps running internally
+void PWM_Output_Pin_GPIO(uint8_t Pin)
+{
+    GPIOA_MODER = (GPIOA_MODER & ~(3UL << (2U * Pin))) | (GPIO_MODE_OUTPUT << (2U * Pin));
+}
+
+void PWM_Output_Pin_Timer(uint8_t Pin)
+{
+    GPIOA_MODER = (GPIOA_MODER & ~(3UL << (2U * Pin))) | (GPIO_MODE_AF << (2U * Pin));
+}
+
+#endif
@@ -0,0 +1,142 @@
+// 64-bit hardware timebase for STM32F411x / STM32F446xx: two general-purpose timers chained in hardware
+// The low timer (TIM2 / TIM5, 32-bit) counts the tick; its update event goes out on TRGO and clocks the
+// high timer in external clock mode 1 through ITRx. No interrupt ever runs: the overflow count lives in
+// the high timer's CNT, and Chain64_Now() assembles both halves without a torn read.
+// With a 16-bit high timer (TIM3 / TIM4) the timebase is 48 bits wide: 8.9 years at 1 MHz.
+
+#ifndef TIMER_CHAIN64_STM32F4XX_H
+#define TIMER_CHAIN64_STM32F4XX_H
+
+#include <stdint.h>
+#include "GP_Timer_STM32F4xx.h"
+
+// Timer clocks (before the prescaler) after a low-timer wrap during which the high timer may not have
+// counted it yet (TRGO -> ITR -> slave counter resynchronisation takes a few timer clocks).
+// Chain64_Init() converts it to ticks: ceil(CHAIN64_GUARD_TICKS / (PSC + 1)), at least 1.
+#ifndef CHAIN64_GUARD_TICKS
+#define CHAIN64_GUARD_TICKS 8U
+#endif
+
+typedef enum CHAIN64_STATUS
+{
+    CHAIN64_OK = 0,
+    CHAIN64_NOT_LINKED = 1, // the high timer has no ITR input from the low timer
+    CHAIN64_LOW_16BIT = 2   // the low timer must be 32-bit (TIM2 / TIM5)
+} CHAIN64_STATUS;
+
+typedef struct Chain64_t
+{
+    GP_TIMER low;
+    GP_TIMER high;
+    uint32_t tick_hz;
+    uint32_t guard; // CHAIN64_GUARD_TICKS in low-timer ticks
+} Chain64_t;
+
+static Chain64_t Chain64;
+
+/*-------------------------------------------Init----------------------------------------------------------*/
+
+// Timer_Clock = APB1 timer clock (16 MHz on HSI); Tick_Hz must divide it. TIM2 -> TIM5 is the 32 + 32 bit pair.
+CHAIN64_STATUS Chain64_Init(GP_TIMER Low, GP_TIMER High, uint32_t Timer_Clock, uint32_t Tick_Hz)
+{
+    uint8_t itr = GP_Timer_Itr[High][Low];
+    uint32_t psc = (Timer_Clock / Tick_Hz) - 1U;
+
+    if (!GP_Timer_Is_32bit(Low))
+    {
+        return CHAIN64_LOW_16BIT;
+    }
+
+    if (itr == GP_TIMER_NO_ITR)
+    {
+        return CHAIN64_NOT_LINKED;
+    }
+
+    Chain64.low = Low;
+    Chain64.high = High;
+    Chain64.tick_hz = Tick_Hz;
+    Chain64.guard = (CHAIN64_GUARD_TICKS + psc) / (psc + 1U); // 8 at 16 MHz ticks, 1 at 1 MHz or slower
+
+    if (Chain64.guard == 0U)
+    {
+        Chain64.guard = 1U;
+    }
+
+    RCC_Clock_Enable(GP_Timer_Clock(Low));
+    RCC_Clock_Enable(GP_Timer_Clock(High));
+
+    GP_Timer_Reset(Low);
+    GP_Timer_Reset(High);
+
+    // Low: free-running tick counter, full 32-bit range. The prescaler load happens before MMS is set,
+    // so its UG does not count as a first overflow.
+    TIMx_ARR(Low) = 0xFFFFFFFFUL;
+    GP_Timer_Load_Prescaler(Low, psc);
+    TIMx_CR2(Low) = TIM_CR2_MMS_UPDATE;
+
+    // High: one count per low-timer overflow; never prescaled, ARR at the counter's full range
+    TIMx_ARR(High) = GP_Timer_Max(High);
+    GP_Timer_Load_Prescaler(High, 0);
+    TIMx_SMCR(High) = TIM_SMCR_TS(itr) | TIM_SMCR_SMS(TIM_SMS_EXT_CLOCK);
+    TIMx_CR1(High) = TIM_CR1_CEN;
+
+    // Slave listens before the master runs: the first overflow cannot be missed
+    TIMx_CR1(Low) = TIM_CR1_CEN;
+    return CHAIN64_OK;
+}
+
+void Chain64_Deinit(void)
+{
+    TIMx_CR1(Chain64.low) = 0;
+    TIMx_CR1(Chain64.high) = 0;
+    RCC_Clock_Release(GP_Timer_Clock(Chain64.low));
+    RCC_Clock_Release(GP_Timer_Clock(Chain64.high));
+}
+
+/*-------------------------------------------Reading-------------------------------------------------------*/
+
+// Consistent from any context, interrupts enabled, no lock:
+//  - low is sampled first; if it is within the guard window after a wrap, wait until the high timer has
+//    surely counted that wrap before reading it (at most Chain64.guard ticks, one tick at 1 kHz)
+//  - if low has wrapped again by the time high was read, high may already include the next overflow: retry
+// A preemption in between only costs a retry, never a wrong value (unless it lasts a full 2^32 ticks).
+uint64_t Chain64_Now(void)
+{
+    volatile uint32_t *low_cnt = &TIMx_CNT(Chain64.low);
+    volatile uint32_t *high_cnt = &TIMx_CNT(Chain64.high);
+    uint32_t low;
+    uint32_t high;
+
+    do
+    {
+        low = *low_cnt;
+
+        if (low < Chain64.guard)
+        {
+            while (*low_cnt < Chain64.guard)
+            {
+            }
+        }
+
+        high = *high_cnt;
+    } while (*low_cnt < low);
+
+    return ((uint64_t)high << 32) | low;
+}
+
+// Low half only: one load, for intervals below 2^32 ticks (71 minutes at 1 MHz)
+uint32_t Chain64_Now32(void)
+{
+    return TIMx_CNT(Chain64.low);
+}
+
+// Split in whole seconds and remainder: Ticks * 10^6 alone would overflow after 213 days at 1 MHz
+uint64_t Chain64_Ticks_To_Us(uint64_t Ticks)
+{
+    uint64_t seconds = Ticks / Chain64.tick_hz;
+    uint64_t rest = Ticks % Chain64.tick_hz;
+
+    return (seconds * 1000000ULL) + ((rest * 1000000ULL) / Chain64.tick_hz);
+}
+
+#endif
@@ -0,0 +1,186 @@
+// Hardware-triggered delayed pulse for STM32F411x / STM32F446xx (TIM2..TIM5, slave trigger + one-pulse mode)
+// An edge on TI1 / TI2 / ETR (or another timer's TRGO on ITRx) sets CEN in hardware; the output channel runs
+// PWM mode 2 (low until CNT = CCR, high until ARR) and OPM stops the counter at the end of the pulse.
+// No interrupt is involved between the input edge and the output edge: latency is the input
+// synchroniser + filter, jitter is one timer clock. Optional update DMA loads the next pulse's
+// delay / width from a table after every pulse.
+
+#ifndef TIMER_ONE_PULSE_STM32F4XX_H
+#define TIMER_ONE_PULSE_STM32F4XX_H
+
+#include <stdint.h>
+#include "GP_Timer_STM32F4xx.h"
+#include "DMA_Driver_STM32F4xx.h"
+
+// CCMR output fields, per channel byte (input fields are in GP_Timer_STM32F4xx.h)
+#define TIM_CCMR_OCFE (1U << 2)      // fast enable: trigger acts as a compare match
+#define TIM_CCMR_OCM(n) ((uint32_t)(n) << 4)
+#define TIM_OCM_PWM2 7U              // inactive while CNT < CCR, active after
+
+#define TIM_CCER_CCE(ch) (1UL << (4U * ((ch) - 1U)))
+
+// DCR: burst of DBL + 1 words through DMAR, starting at register DBA (word offset)
+#define TIM_DCR_DBA(n) ((uint32_t)(n) << 0)
+#define TIM_DCR_DBL(n) ((uint32_t)(n) << 8)
+#define TIM_DBA_ARR (0x2CU / 4U)
+
+// PWM mode 2 with CCR = 0 is active at CNT = 0, so the output would idle high between pulses.
+// A delay of 0 is raised to 1 tick everywhere a delay is loaded (also in the OPM_PULSE table macro).
+#define OPM_MIN_DELAY 1U
+#define OPM_DELAY(d) (((uint32_t)(d) < OPM_MIN_DELAY) ? OPM_MIN_DELAY : (uint32_t)(d))
+
+typedef struct OPM_Config_t
+{
+    GP_TIMER timer;
+    uint8_t trigger;        // TIM_TS_TI1FP1, TIM_TS_TI2FP2, TIM_TS_ETRF or TIM_TS_ITRx
+    uint8_t falling;        // trigger on the falling edge (TIx / ETR)
+    uint8_t filter;         // ICxF / ETF 0..15: 0 = none, 3 = 8 samples at f_CK_INT, 15 = 8 at f_DTS / 32
+    uint8_t output_channel; // 1..4, not the trigger input's channel; DMA updates need channel 1
+    uint8_t fast;           // OCxFE: pulse starts on the trigger itself, the delay is ignored
+    uint32_t prescaler;
+    uint32_t delay;         // ticks from trigger to the rising output edge, >= OPM_MIN_DELAY (0 is raised to 1)
+    uint32_t width;         // ticks high
+} OPM_Config_t;
+
+// One DMA burst per pulse: ARR, the register at 0x30 (RCR on TIM1/8, unused on TIM2..TIM5), CCR1
+typedef struct OPM_Pulse_t
+{
+    uint32_t arr;
+    uint32_t unused;
+    uint32_t ccr1;
+} OPM_Pulse_t;
+
+#define OPM_PULSE(delay, width) {OPM_DELAY(delay) + (uint32_t)(width) - 1U, 0U, OPM_DELAY(delay)}
+#define OPM_BURST_WORDS 3U
+
+// Update DMA request per timer (DMA1): TIM2_UP S1 ch3, TIM3_UP S2 ch5, TIM4_UP S6 ch2, TIM5_UP S0 ch6
+static const uint8_t OPM_Dma_Stream[GP_TIMER_COUNT] = {1, 2, 6, 0};
+static const uint8_t OPM_Dma_Channel[GP_TIMER_COUNT] = {3, 5, 2, 6};
+
+typedef struct OPM_t
+{
+    GP_TIMER timer;
+    uint8_t channel;
+    volatile uint32_t sequences; // DMA table passes completed
+} OPM_t;
+
+static OPM_t OPM;
+
+/*-------------------------------------------Init----------------------------------------------------------*/
+
+// Input pin (TIx / ETR) and output pin must already be routed with GP_Timer_Pin()
+void OPM_Init(const OPM_Config_t *Config)
+{
+    GP_TIMER t = Config->timer;
+    uint8_t ch = Config->output_channel;
+    uint32_t ccmr;
+
+    OPM.timer = t;
+    OPM.channel = ch;
+    OPM.sequences = 0;
+
+    RCC_Clock_Enable(GP_Timer_Clock(t));
+    GP_Timer_Reset(t);
+
+    // Trigger input: TI1 / TI2 as input capture (only for the filter and polarity), or ETR
+    if ((Config->trigger == TIM_TS_TI1FP1) || (Config->trigger == TIM_TS_TI2FP2))
+    {
+        uint8_t in = (Config->trigger == TIM_TS_TI1FP1) ? 1U : 2U;
+
+        ccmr = TIMx_CCMR(t, in) & ~(0xFFUL << TIMx_CCMR_SHIFT(in));
+        TIMx_CCMR(t, in) = ccmr | ((TIM_CCMR_CCS_INPUT | TIM_CCMR_ICF(Config->filter)) << TIMx_CCMR_SHIFT(in));
+
+        if (Config->falling)
+        {
+            TIMx_CCER(t) |= TIM_CCER_CCP(in);
+        }
+    }
+
+    TIMx_SMCR(t) = ((Config->trigger == TIM_TS_ETRF) ? TIM_SMCR_ETF(Config->filter) : 0U) |
+                   ((Config->falling && (Config->trigger == TIM_TS_ETRF)) ? TIM_SMCR_ETP : 0U);
+
+    // Output: PWM mode 2, no preload (values written while stopped apply to the next trigger)
+    ccmr = TIMx_CCMR(t, ch) & ~(0xFFUL << TIMx_CCMR_SHIFT(ch));
+    TIMx_CCMR(t, ch) = ccmr | ((TIM_CCMR_OCM(TIM_OCM_PWM2) | (Config->fast ? TIM_CCMR_OCFE : 0U))
+                               << TIMx_CCMR_SHIFT(ch));
+
+    TIMx_ARR(t) = OPM_DELAY(Config->delay) + Config->width - 1U;
+    TIMx_CCR(t, ch) = OPM_DELAY(Config->delay);
+    GP_Timer_Load_Prescaler(t, Config->prescaler); // also CNT = 0: OCxREF idles low
+
+    TIMx_CCER(t) |= TIM_CCER_CCE(ch);
+    TIMx_CR1(t) = TIM_CR1_OPM;
+
+    // Trigger mode last: from here on the input edge starts the counter
+    TIMx_SMCR(t) |= TIM_SMCR_TS(Config->trigger) | TIM_SMCR_SMS(TIM_SMS_TRIGGER);
+}
+
+void OPM_Deinit(void)
+{
+    TIMx_SMCR(OPM.timer) = 0;
+    TIMx_CR1(OPM.timer) = 0;
+    TIMx_DIER(OPM.timer) = 0;
+    TIMx_CCER(OPM.timer) = 0;
+    RCC_Clock_Release(GP_Timer_Clock(OPM.timer));
+}
+
+/*-------------------------------------------Control-------------------------------------------------------*/
+
+// No preload: written while idle it applies to the next trigger, written during a pulse it changes that
+// pulse. Wait for OPM_Busy() == 0 when that matters. Delay 0 is raised to OPM_MIN_DELAY.
+void OPM_Set(uint32_t Delay, uint32_t Width)
+{
+    Delay = OPM_DELAY(Delay);
+
+    TIMx_ARR(OPM.timer) = Delay + Width - 1U;
+    TIMx_CCR(OPM.timer, OPM.channel) = Delay;
+}
+
+// Software trigger, same pulse as an input edge
+void OPM_Fire(void)
+{
+    TIMx_CR1(OPM.timer) |= TIM_CR1_CEN;
+}
+
+uint8_t OPM_Busy(void)
+{
+    return (TIMx_CR1(OPM.timer) & TIM_CR1_CEN) ? 1U : 0U;
+}
+
+/*-------------------------------------------DMA parameter sequence----------------------------------------*/
+
+void OPM_DMA_Callback(void *Context, uint8_t Flags)
+{
+    (void)Context;
+
+    if (Flags & DMA_FLAG_TC)
+    {
+        OPM.sequences++;
+    }
+}
+
+// Pulse k uses Table[k]. A software update event bursts Table[0] into ARR / CCR1 now; the update event
+// that ends pulse k bursts Table[k + 1] before the next trigger can come (3 words, well under 1 us).
+// Circular repeats the table, otherwise the last entry stays. Output must be channel 1.
+void OPM_Attach_Sequence(const OPM_Pulse_t *Table, uint16_t Count, uint8_t Circular)
+{
+    GP_TIMER t = OPM.timer;
+
+    if ((OPM.channel != 1U) || (Count == 0U))
+    {
+        return;
+    }
+
+    TIMx_DCR(t) = TIM_DCR_DBA(TIM_DBA_ARR) | TIM_DCR_DBL(OPM_BURST_WORDS - 1U);
+
+    DMA_Stream_Init(DMA_1, OPM_Dma_Stream[t],
+                    DMA_CR_CHSEL(OPM_Dma_Channel[t]) | DMA_CR_DIR_M2P | DMA_CR_MINC | DMA_CR_PSIZE_32 |
+                        DMA_CR_MSIZE_32 | DMA_CR_PL(3) | DMA_CR_TCIE | (Circular ? DMA_CR_CIRC : 0U),
+                    0, &TIMx_DMAR(t), OPM_DMA_Callback, 0, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_TX);
+
+    DMA_Stream_Start(DMA_1, OPM_Dma_Stream[t], Table, (uint16_t)(Count * OPM_BURST_WORDS));
+    TIMx_DIER(t) |= TIM_DIER_UDE;
+    TIMx_EGR(t) = TIM_EGR_UG; // URS = 0: UG requests the first burst; it does not start the counter
+}
+
+#endif
@@ -0,0 +1,358 @@
+// USART1 / USART2 / USART6 driver with DMA for STM32F411x / STM32F446xx
+// RX: circular DMA into a caller-owned ring, frames delimited by the IDLE-line interrupt, data handed out in place.
+// TX: DMA straight from a caller-owned buffer, completion callback.
+
+#ifndef UART_DMA_DRIVER_STM32F4XX_H
+#define UART_DMA_DRIVER_STM32F4XX_H
+
+#include <stdint.h>
+#include "DMA_Driver_STM32F4xx.h"
+
+/*-------------------------------Bus clocks (HSI, no prescaler)----------------------------------------------*/
+
+#ifndef APB1_CLK
+#define APB1_CLK 16000000UL
+#endif
+
+#ifndef APB2_CLK
+#define APB2_CLK 16000000UL
+#endif
+
+/*-------------------------------------------GPIO---------------------------------------------------------*/
+
+#define GPIOx_BASE(p) (0x40020000UL + (0x400UL * (p))) // p = 0 -> GPIOA, 1 -> GPIOB, ...
+#define GPIOx_MODER(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x00))
+#define GPIOx_PUPDR(p) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x0C))
+#define GPIOx_AFR(p, n) (*(volatile uint32_t *)(GPIOx_BASE(p) + 0x20 + (4U * ((n) >> 3)))) // AFRL / AFRH
+
+/*-------------------------------------------USART--------------------------------------------------------*/
+
+#define USART1_BASE 0x40011000UL
+#define USART2_BASE 0x40004400UL
+#define USART6_BASE 0x40011400UL
+
+#define USART_SR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x00))
+#define USART_DR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x04))
+#define USART_BRR(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x08))
+#define USART_CR1(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x0C))
+#define USART_CR2(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x10))
+#define USART_CR3(b) (*(volatile uint32_t *)(uintptr_t)((b) + 0x14))
+
+#define USART_SR_FE (1U << 1)
+#define USART_SR_NF (1U << 2)
+#define USART_SR_ORE (1U << 3)
+#define USART_SR_IDLE (1U << 4)
+#define USART_SR_TC (1U << 6)
+
+#define USART_CR1_RE (1U << 2)
+#define USART_CR1_TE (1U << 3)
+#define USART_CR1_IDLEIE (1U << 4)
+#define USART_CR1_UE (1U << 13)
+#define USART_CR1_OVER8 (1U << 15)
+
+#define USART_CR3_EIE (1U << 0)
+#define USART_CR3_DMAR (1U << 6)
+#define USART_CR3_DMAT (1U << 7)
+
+typedef enum UART_PORTS
+{
+    UART_1 = 0, // PA9 TX / PA10 RX, AF7, APB2
+    UART_2 = 1, // PA2 TX / PA3 RX,  AF7, APB1 (ST-Link VCP on Nucleo)
+    UART_6 = 2  // PA11 TX / PA12 RX (F411) or PC6 TX / PC7 RX (F446), AF8, APB2
+} UART_PORTS;
+
+// USART6 is not on PA11 / PA12 on the F446 (build with -DSTM32F446xx)
+#if defined(STM32F446xx)
+#define UART6_GPIO_PORT 2U
+#define UART6_TX_PIN 6U
+#else
+#define UART6_GPIO_PORT 0U
+#define UART6_TX_PIN 11U
+#endif
+
+typedef enum UART_STATUS
+{
+    UART_OK = 0,
+    UART_BUSY = 1,
+    UART_ERROR_CONFIG = 2, // baud rate out of range (above Clock / 8) or no RX callback
+    UART_ERROR_TX = 3      // TX DMA transfer error: the frame did not (completely) leave
+} UART_STATUS;
+
+// Data points into the RX ring; it stays valid until the DMA comes round again (ring size - Length bytes later)
+typedef void (*UART_Rx_Callback_t)(const uint8_t *Data, uint16_t Length);
+typedef void (*UART_Tx_Callback_t)(UART_STATUS Status); // UART_OK or UART_ERROR_TX
+
+typedef struct UART_Port_t
+{
+    uint32_t base;
+    DMA_CONTROLLER dma;
+    uint8_t rx_stream;
+    uint8_t tx_stream;
+    uint8_t channel;
+    uint8_t irqn;
+    uint8_t gpio_port;
+    uint8_t tx_pin;
+    uint8_t af;
+
+    uint8_t *rx_ring;
+    uint16_t rx_size;
+    uint16_t rx_read;
+    UART_Rx_Callback_t rx_callback;
+    UART_Tx_Callback_t tx_callback;
+    volatile uint8_t tx_busy;
+    volatile uint32_t rx_errors;
+} UART_Port_t;
+
+// DMA request mapping (RM0383 / RM0390 table 28/29)
+static UART_Port_t UART_Ports[3] =
+{
+    {USART1_BASE, DMA_2, 2, 7, 4, 37, 0, 9, 7, 0, 0, 0, 0, 0, 0, 0},
+    {USART2_BASE, DMA_1, 5, 6, 4, 38, 0, 2, 7, 0, 0, 0, 0, 0, 0, 0},
+    {USART6_BASE, DMA_2, 1, 6, 5, 71, UART6_GPIO_PORT, UART6_TX_PIN, 8, 0, 0, 0, 0, 0, 0, 0},
+};
+
+/*-------------------------------------------Baud rate----------------------------------------------------*/
+
+// x = Clock / Baud (rounded) is 16 * USARTDIV with OVER16 and 8 * USARTDIV with OVER8.
+// OVER8 is only used when OVER16 cannot reach the rate (x < 16), e.g. 2 Mbaud from 16 MHz.
+// Returns 0 (not a valid BRR) above Clock / 8, where even OVER8 has no divider left.
+uint32_t UART_Compute_BRR(uint32_t Clock, uint32_t Baud, uint8_t *Over8)
+{
+    if (Baud == 0U)
+    {
+        return 0;
+    }
+
+    uint32_t x = (Clock + (Baud / 2U)) / Baud;
+
+    if (x < 8U)
+    {
+        return 0;
+    }
+
+    if (x >= 16U)
+    {
+        *Over8 = 0;
+        return x;
+    }
+
+    *Over8 = 1;
+    return ((x >> 3) << 4) | (x & 7U);
+}
+
+/*-------------------------------------------RX path------------------------------------------------------*/
+
+// Runs from DMA HT/TC and USART IDLE, all at the same NVIC level, so they never preempt each other
+void UART_Rx_Process(UART_Port_t *Uart)
+{
+    uint16_t write = (uint16_t)(Uart->rx_size - DMA_Stream_Remaining(Uart->dma, Uart->rx_stream));
+    uint16_t read = Uart->rx_read;
+
+    if (write >= Uart->rx_size)
+    {
+        write = 0;
+    }
+
+    if (write == read)
+    {
+        return;
+    }
+
+    if (write > read)
+    {
+        Uart->rx_callback(&Uart->rx_ring[read], (uint16_t)(write - read));
+    }
+    else
+    {
+        // Wrapped: two contiguous pieces, still no copy
+        Uart->rx_callback(&Uart->rx_ring[read], (uint16_t)(Uart->rx_size - read));
+
+        if (write)
+        {
+            Uart->rx_callback(&Uart->rx_ring[0], write);
+        }
+    }
+
+    Uart->rx_read = write;
+}
+
+void UART_Rx_DMA_Callback(void *Context, uint8_t Flags)
+{
+    UART_Port_t *uart = (UART_Port_t *)Context;
+
+    if (Flags & DMA_FLAG_TE)
+    {
+        uart->rx_errors++;
+    }
+
+    if (Flags & (DMA_FLAG_HT | DMA_FLAG_TC))
+    {
+        UART_Rx_Process(uart);
+    }
+}
+
+void UART_IRQ_Dispatch(UART_Port_t *Uart)
+{
+    uint32_t sr = USART_SR(Uart->base);
+
+    if (sr & (USART_SR_IDLE | USART_SR_ORE | USART_SR_NF | USART_SR_FE))
+    {
+        (void)USART_DR(Uart->base); // SR then DR read clears IDLE / ORE / NF / FE
+
+        if (sr & (USART_SR_ORE | USART_SR_NF | USART_SR_FE))
+        {
+            Uart->rx_errors++;
+        }
+
+        UART_Rx_Process(Uart);
+    }
+}
+
+void USART1_IRQHandler(void)
+{
+    UART_IRQ_Dispatch(&UART_Ports[UART_1]);
+}
+
+void USART2_IRQHandler(void)
+{
+    UART_IRQ_Dispatch(&UART_Ports[UART_2]);
+}
+
+void USART6_IRQHandler(void)
+{
+    UART_IRQ_Dispatch(&UART_Ports[UART_6]);
+}
+
+/*-------------------------------------------TX path------------------------------------------------------*/
+
+void UART_Tx_DMA_Callback(void *Context, uint8_t Flags)
+{
+    UART_Port_t *uart = (UART_Port_t *)Context;
+
+    if (Flags & (DMA_FLAG_TC | DMA_FLAG_TE))
+    {
+        uart->tx_busy = 0;
+
+        if (uart->tx_callback)
+        {
+            uart->tx_callback((Flags & DMA_FLAG_TE) ? UART_ERROR_TX : UART_OK);
+        }
+    }
+}
+
+// Data must stay untouched until Done is called (the DMA reads it directly)
+UART_STATUS UART_DMA_Transmit(UART_PORTS Port, const uint8_t *Data, uint16_t Length, UART_Tx_Callback_t Done)
+{
+    UART_Port_t *uart = &UART_Ports[Port];
+
+    if (Length == 0U)
+    {
+        return UART_BUSY;
+    }
+
+    // Check and claim in one step: callers run from thread code and from the RX callbacks (DMA level)
+    uint32_t state = NVIC_Enter_Critical(NVIC_PREEMPT_DMA);
+
+    if (uart->tx_busy)
+    {
+        NVIC_Exit_Critical(state);
+        return UART_BUSY;
+    }
+
+    uart->tx_busy = 1;
+    uart->tx_callback = Done;
+    NVIC_Exit_Critical(state);
+
+    USART_SR(uart->base) = ~USART_SR_TC; // TC is rc_w0
+    DMA_Stream_Start(uart->dma, uart->tx_stream, Data, Length);
+
+    return UART_OK;
+}
+
+uint8_t UART_DMA_Tx_Busy(UART_PORTS Port)
+{
+    return UART_Ports[Port].tx_busy;
+}
+
+/*-------------------------------------------Init---------------------------------------------------------*/
+
+UART_STATUS UART_DMA_Init(UART_PORTS Port, uint32_t Baud, uint8_t *Rx_Ring, uint16_t Rx_Size,
+                          UART_Rx_Callback_t Rx_Callback)
+{
+    UART_Port_t *uart = &UART_Ports[Port];
+    uint32_t clock = (Port == UART_2) ? APB1_CLK : APB2_CLK;
+    uint8_t over8;
+    uint32_t brr = UART_Compute_BRR(clock, Baud, &over8);
+
+    if ((brr == 0U) || (Rx_Callback == 0))
+    {
+        return UART_ERROR_CONFIG;
+    }
+
+    switch (Port)
+    {
+    case UART_1:
+        RCC_Clock_Ensure(RCC_CLK_USART1);
+        break;
+
+    case UART_2:
+        RCC_Clock_Ensure(RCC_CLK_USART2);
+        break;
+
+    case UART_6:
+        RCC_Clock_Ensure(RCC_CLK_USART6);
+        break;
+
+    default:
+        return UART_ERROR_CONFIG;
+    }
+
+    // TX pin and RX pin (TX + 1) in alternate function mode, pull-up on RX
+    uint8_t port = uart->gpio_port;
+
+    RCC_Clock_Ensure(RCC_CLK_GPIO(port));
+
+    for (uint8_t pin = uart->tx_pin; pin <= (uint8_t)(uart->tx_pin + 1U); pin++)
+    {
+        GPIOx_MODER(port) &= ~(3UL << (2U * pin));
+        GPIOx_MODER(port) |= (2UL << (2U * pin));
+
+        GPIOx_AFR(port, pin) &= ~(0xFUL << (4U * (pin & 7U)));
+        GPIOx_AFR(port, pin) |= ((uint32_t)uart->af << (4U * (pin & 7U)));
+    }
+
+    GPIOx_PUPDR(port) &= ~(3UL << (2U * (uart->tx_pin + 1U)));
+    GPIOx_PUPDR(port) |= (1UL << (2U * (uart->tx_pin + 1U)));
+
+    uart->rx_ring = Rx_Ring;
+    uart->rx_size = Rx_Size;
+    uart->rx_read = 0;
+    uart->rx_callback = Rx_Callback;
+    uart->tx_busy = 0;
+    uart->rx_errors = 0;
+
+    USART_CR1(uart->base) = 0;
+    USART_BRR(uart->base) = brr;
+    USART_CR3(uart->base) = USART_CR3_DMAR | USART_CR3_DMAT | USART_CR3_EIE;
+
+    DMA_Stream_Init(uart->dma, uart->rx_stream,
+                    DMA_CR_CHSEL(uart->channel) | DMA_CR_DIR_P2M | DMA_CR_MINC | DMA_CR_CIRC | DMA_CR_PL(2) |
+                        DMA_CR_HTIE | DMA_CR_TCIE | DMA_CR_TEIE,
+                    0, &USART_DR(uart->base), UART_Rx_DMA_Callback, uart, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+
+    DMA_Stream_Init(uart->dma, uart->tx_stream,
+                    DMA_CR_CHSEL(uart->channel) | DMA_CR_DIR_M2P | DMA_CR_MINC | DMA_CR_PL(1) |
+                        DMA_CR_TCIE | DMA_CR_TEIE,
+                    0, &USART_DR(uart->base), UART_Tx_DMA_Callback, uart, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_TX);
+
+    DMA_Stream_Start(uart->dma, uart->rx_stream, Rx_Ring, Rx_Size);
+
+    NVIC_Setup_IRQ(uart->irqn, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_RX);
+
+    USART_CR1(uart->base) = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE | USART_CR1_IDLEIE |
+                            (over8 ? USART_CR1_OVER8 : 0U);
+
+    return UART_OK;
+}
+
+#endif
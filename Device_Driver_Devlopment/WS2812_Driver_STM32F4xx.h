@@ -0,0 +1,186 @@
+// WS2812 / SK6812 addressable LED driver on TIM2 PWM + DMA for STM32F411x / STM32F446xx
+// One PWM period per bit (800 kHz), the duty is the bit: the TIM2 update DMA request writes the next CCR1.
+// The CCR values are expanded from a 3-byte-per-LED framebuffer into a small circular buffer, one half at a
+// time from the half / full transfer interrupts, so RAM does not grow with the strip.
+
+#ifndef WS2812_DRIVER_STM32F4XX_H
+#define WS2812_DRIVER_STM32F4XX_H
+
+#include <stdint.h>
+#include "TIM2_PWM_Driver_STM32F4xx.h"
+#include "DMA_Driver_STM32F4xx.h"
+
+#define TIM2_DIER (*(volatile uint32_t *)(TIM2_BASE + 0x0C))
+#define TIM_DIER_UDE (1U << 8) // DMA request on update
+
+// TIM2_UP: DMA1 Stream1 channel 3 (shared with I2C3 RX, which uses channel 1)
+#define WS2812_DMA DMA_1
+#define WS2812_DMA_STREAM 1U
+#define WS2812_DMA_CHANNEL 3U
+
+#define WS2812_CHANNEL 1U // TIM2_CH1
+#define WS2812_PIN 0U     // PA0, AF1
+
+// LEDs expanded per half buffer: 4 LEDs = 120 us between interrupts
+#ifndef WS2812_LEDS_PER_HALF
+#define WS2812_LEDS_PER_HALF 4U
+#endif
+
+#define WS2812_BITS_PER_LED 24U
+#define WS2812_HALF_SLOTS (WS2812_LEDS_PER_HALF * WS2812_BITS_PER_LED)
+
+// Latch: line low for >= 280 us (WS2812B rev. 5; older parts need 50 us) = 224 bit periods
+#define WS2812_RESET_SLOTS 224U
+#define WS2812_RESET_CHUNKS ((WS2812_RESET_SLOTS + WS2812_HALF_SLOTS - 1U) / WS2812_HALF_SLOTS)
+
+typedef enum WS2812_STATUS
+{
+    WS2812_OK = 0,
+    WS2812_BUSY = 1
+} WS2812_STATUS;
+
+typedef struct WS2812_t
+{
+    uint8_t *frame; // G, R, B per LED (wire order)
+    uint16_t count;
+    uint32_t t0h;   // CCR for a 0 bit: 0.4 us high
+    uint32_t t1h;   // CCR for a 1 bit: 0.8 us high
+    uint16_t next_led;
+    uint16_t chunks_played;
+    uint16_t chunks_total;
+    volatile uint8_t busy;
+    volatile uint32_t frames;
+} WS2812_t;
+
+static WS2812_t WS2812;
+static uint32_t WS2812_Dma_Buffer[2U * WS2812_HALF_SLOTS]; // 768 bytes for 4 LEDs per half
+
+/*-------------------------------------------Expansion------------------------------------------------------*/
+
+// One chunk = WS2812_LEDS_PER_HALF LEDs; past the end of the frame it is all zeros (line low, reset time)
+void WS2812_Fill(uint32_t *Half)
+{
+    for (uint8_t led = 0; led < WS2812_LEDS_PER_HALF; led++)
+    {
+        if (WS2812.next_led < WS2812.count)
+        {
+            const uint8_t *grb = &WS2812.frame[3U * WS2812.next_led++];
+
+            for (uint8_t c = 0; c < 3U; c++)
+            {
+                uint8_t byte = grb[c];
+
+                for (uint8_t bit = 0; bit < 8U; bit++)
+                {
+                    *Half++ = (byte & 0x80U) ? WS2812.t1h : WS2812.t0h; // MSB first
+                    byte = (uint8_t)(byte << 1);
+                }
+            }
+        }
+        else
+        {
+            for (uint8_t bit = 0; bit < WS2812_BITS_PER_LED; bit++)
+            {
+                *Half++ = 0;
+            }
+        }
+    }
+}
+
+// HT: first half played, refill it; TC: second half played. The DMA keeps reading the other half,
+// so the deadline is one half (120 us at 4 LEDs per half), not one bit.
+void WS2812_DMA_Callback(void *Context, uint8_t Flags)
+{
+    (void)Context;
+
+    if (!(Flags & (DMA_FLAG_HT | DMA_FLAG_TC)))
+    {
+        return;
+    }
+
+    if (++WS2812.chunks_played >= WS2812.chunks_total)
+    {
+        // Last reset chunk out: stop on a low line
+        DMA_Stream_Stop(WS2812_DMA, WS2812_DMA_STREAM);
+        TIM2_CCR(WS2812_CHANNEL) = 0;
+        WS2812.busy = 0;
+        WS2812.frames++;
+        return;
+    }
+
+    WS2812_Fill((Flags & DMA_FLAG_TC) ? &WS2812_Dma_Buffer[WS2812_HALF_SLOTS] : &WS2812_Dma_Buffer[0]);
+}
+
+/*-------------------------------------------API------------------------------------------------------------*/
+
+// Frame holds 3 * Count bytes. Timer_Clock = TIM2 input clock (16 MHz HSI: ARR = 19, T0H = 6, T1H = 13)
+void WS2812_Init(uint8_t *Frame, uint16_t Count, uint32_t Timer_Clock)
+{
+    uint32_t period = Timer_Clock / 800000UL;
+
+    WS2812.frame = Frame;
+    WS2812.count = Count;
+    WS2812.t0h = (Timer_Clock + 1250000UL) / 2500000UL;        // 0.4 us, rounded
+    WS2812.t1h = ((Timer_Clock * 4U) + 2500000UL) / 5000000UL; // 0.8 us, rounded
+    WS2812.busy = 0;
+    WS2812.frames = 0;
+
+    for (uint32_t i = 0; i < (3UL * Count); i++)
+    {
+        Frame[i] = 0;
+    }
+
+    PWM_Output_Init(0, period - 1U);
+    PWM_Output_Channel_Init(WS2812_CHANNEL, WS2812_PIN);
+    PWM_Output_Set_Mode(WS2812_CHANNEL, PWM_OUT_PWM1); // CCR = 0: line stays low between frames
+
+    DMA_Stream_Init(WS2812_DMA, WS2812_DMA_STREAM,
+                    DMA_CR_CHSEL(WS2812_DMA_CHANNEL) | DMA_CR_DIR_M2P | DMA_CR_MINC | DMA_CR_CIRC |
+                        DMA_CR_PSIZE_32 | DMA_CR_MSIZE_32 | DMA_CR_PL(3) | DMA_CR_HTIE | DMA_CR_TCIE,
+                    0, &TIM2_CCR(WS2812_CHANNEL), WS2812_DMA_Callback, 0, NVIC_PREEMPT_DMA, NVIC_SUB_DMA_TX);
+
+    TIM2_DIER |= TIM_DIER_UDE;
+}
+
+void WS2812_Set_Pixel(uint16_t Index, uint8_t Red, uint8_t Green, uint8_t Blue)
+{
+    if (Index < WS2812.count)
+    {
+        uint8_t *grb = &WS2812.frame[3U * Index];
+
+        grb[0] = Green;
+        grb[1] = Red;
+        grb[2] = Blue;
+    }
+}
+
+uint8_t WS2812_Busy(void)
+{
+    return WS2812.busy;
+}
+
+// Sends the whole frame; the framebuffer must not change until WS2812_Busy() returns 0.
+// Duration: 30 us per LED + 360 us reset (300 LEDs: 9.4 ms, 500 LEDs: 15.4 ms -> 65 fps).
+WS2812_STATUS WS2812_Show(void)
+{
+    if (WS2812.busy)
+    {
+        return WS2812_BUSY;
+    }
+
+    WS2812.busy = 1;
+    WS2812.next_led = 0;
+    WS2812.chunks_played = 0;
+    WS2812.chunks_total = (uint16_t)(((WS2812.count + WS2812_LEDS_PER_HALF - 1U) / WS2812_LEDS_PER_HALF) +
+                                     WS2812_RESET_CHUNKS);
+
+    WS2812_Fill(&WS2812_Dma_Buffer[0]);
+    WS2812_Fill(&WS2812_Dma_Buffer[WS2812_HALF_SLOTS]);
+
+    // The first request comes with the next update; CCR preload puts each value on the wire one
+    // period later, so the frame starts with one low period.
+    DMA_Stream_Start(WS2812_DMA, WS2812_DMA_STREAM, WS2812_Dma_Buffer, (uint16_t)(2U * WS2812_HALF_SLOTS));
+    return WS2812_OK;
+}
+
+#endif
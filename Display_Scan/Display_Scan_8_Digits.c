@@ -0,0 +1,106 @@
+// 8-digit multiplexed 7-segment display refreshed by TIM1 + DMA2 alone (STM32F446xx, Nucleo-F446RE)
+// Segments a..g, dp on PB0..PB7, digit commons (through NPN transistors, common cathode) on PB8..PB15.
+// 250 Hz full refresh, 16 brightness slots per digit: TIM1 update at 8 x 16 x 250 = 32 kHz, one DMA word
+// per update into GPIOB_BSRR. The CPU only rewrites the framebuffer, 8 word stores every 100 ms: uptime
+// in tenths of a second, leading zeros blank, the tenths digit dimmer than the rest.
+// STM32F411 Black Pill: PB11 is not bonded out, use DISPLAY_DIGITS 7 and PB12..PB15 for digits 3..6.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/Display_Scan_STM32F4xx.h"
+
+#define SYST_CSR (*(volatile uint32_t *)(0xE000E010UL))
+#define SYST_RVR (*(volatile uint32_t *)(0xE000E014UL))
+#define SYST_CVR (*(volatile uint32_t *)(0xE000E018UL))
+
+#define HSI_CLK 16000000UL
+#define REFRESH_HZ 250U
+#define UPDATE_MS 100U
+
+#define GPIO_PORT_B 1U
+#define DISPLAY_DIGITS 8U
+
+#define BRIGHT_DIGITS DISPLAY_SLOTS
+#define BRIGHT_TENTHS 6U
+
+static const Display_Config_t Panel =
+{
+    .port = GPIO_PORT_B,
+    .rows = DISPLAY_DIGITS,
+    .columns = 8,
+    .row_pin = {8, 9, 10, 11, 12, 13, 14, 15},
+    .column_pin = {0, 1, 2, 3, 4, 5, 6, 7}, // a b c d e f g dp
+    .row_active_low = 0,                    // NPN low-side switch per digit: high = digit on
+    .column_active_low = 0,                 // common cathode: high = segment on
+    .timer_clock = HSI_CLK,
+    .refresh_hz = REFRESH_HZ
+};
+
+void delay_ms(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        while (((SYST_CSR >> 16) & 1U) == 0U)
+        {
+        }
+    }
+}
+
+// Right-aligned "nnnnnnn.n" with blank leading zeros; Text needs DISPLAY_DIGITS + 2 chars
+static void Format_Tenths(uint32_t Tenths, char *Text)
+{
+    char digits[DISPLAY_DIGITS];
+    uint8_t n = 0;
+
+    for (uint8_t i = 0; i < DISPLAY_DIGITS; i++)
+    {
+        digits[i] = ' ';
+    }
+
+    // Always show "0.0"
+    do
+    {
+        digits[DISPLAY_DIGITS - 1U - n] = (char)('0' + (Tenths % 10U));
+        Tenths /= 10U;
+        n++;
+    } while (((Tenths != 0U) || (n < 2U)) && (n < DISPLAY_DIGITS));
+
+    for (uint8_t i = 0; i < (DISPLAY_DIGITS - 1U); i++)
+    {
+        *Text++ = digits[i];
+    }
+
+    *Text++ = '.'; // dp of the digit before the tenths
+    *Text++ = digits[DISPLAY_DIGITS - 1U];
+    *Text = '\0';
+}
+
+int main(void)
+{
+    char text[DISPLAY_DIGITS + 2U];
+    uint32_t tenths = 0;
+
+    SYST_RVR = (HSI_CLK / 1000U) - 1U;
+    SYST_CVR = 0;
+    SYST_CSR = (1U << 0) | (1U << 2);
+
+    if (Display_Init(&Panel) != DISPLAY_OK)
+    {
+        while (1)
+        {
+        }
+    }
+
+    Display_Set_All_Brightness(BRIGHT_DIGITS);
+    Display_Set_Brightness(DISPLAY_DIGITS - 1U, BRIGHT_TENTHS);
+
+    Display_Print("HELLO");
+    Display_Start();
+    delay_ms(1000);
+
+    while (1)
+    {
+        Format_Tenths(tenths++, text);
+        Display_Print(text);
+        delay_ms(UPDATE_MS);
+    }
+}
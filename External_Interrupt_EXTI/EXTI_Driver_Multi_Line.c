@@ -0,0 +1,90 @@
+// Several buttons on shared and dedicated EXTI lines handled by the generic EXTI driver (STM32F411 Black Pill)
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/EXTI_Driver_STM32F4xx.h"
+
+// GPIOA / GPIOB / GPIOC -------------------------------------------------------------
+
+#define GPIOA_BASE 0x40020000UL
+#define GPIOA_MODER (*(volatile uint32_t *)(GPIOA_BASE + 0x00))
+#define GPIOA_ODR (*(volatile uint32_t *)(GPIOA_BASE + 0x14))
+#define GPIOA_BSRR (*(volatile uint32_t *)(GPIOA_BASE + 0x18))
+
+#define GPIOB_BASE 0x40020400UL
+#define GPIOB_MODER (*(volatile uint32_t *)(GPIOB_BASE + 0x00))
+#define GPIOB_PUPDR (*(volatile uint32_t *)(GPIOB_BASE + 0x0C))
+
+#define GPIOC_BASE 0x40020800UL
+#define GPIOC_MODER (*(volatile uint32_t *)(GPIOC_BASE + 0x00))
+
+#define GPIO_BSRR_RESET 16U
+
+// LED BUTTON ----------------------------------------------------------------------
+
+#define LED_PA1 1
+#define LED_PA3 3
+#define LED_PA4 4
+
+#define BUTTON_PA2 2   // EXTI2      (dedicated vector)
+#define BUTTON_PB5 5   // EXTI9_5    (shared vector)
+#define BUTTON_PB7 7   // EXTI9_5    (shared vector)
+#define BUTTON_PC13 13 // EXTI15_10  (shared vector, Black Pill KEY)
+
+void LED_Toggle_PA(uint8_t Pin)
+{
+    if (GPIOA_ODR & (1 << Pin))
+    {
+        GPIOA_BSRR = 1 << (Pin + GPIO_BSRR_RESET);
+    }
+    else
+    {
+        GPIOA_BSRR = 1 << Pin;
+    }
+}
+
+void Button_PA2_Pressed(uint8_t Line)
+{
+    (void)Line;
+    LED_Toggle_PA(LED_PA1);
+}
+
+void Button_PB_Pressed(uint8_t Line)
+{
+    // PB5 and PB7 share EXTI9_5_IRQHandler; the driver passes the line that fired
+    LED_Toggle_PA((Line == BUTTON_PB5) ? LED_PA3 : LED_PA4);
+}
+
+void Button_PC13_Pressed(uint8_t Line)
+{
+    (void)Line;
+    GPIOA_BSRR = (1 << (LED_PA1 + GPIO_BSRR_RESET)) |
+                 (1 << (LED_PA3 + GPIO_BSRR_RESET)) |
+                 (1 << (LED_PA4 + GPIO_BSRR_RESET));
+}
+
+int main(void)
+{
+    RCC_Clock_Ensure(RCC_CLK_GPIOA);
+    RCC_Clock_Ensure(RCC_CLK_GPIOB);
+    RCC_Clock_Ensure(RCC_CLK_GPIOC);
+
+    GPIOA_MODER &= ~((3 << (2 * LED_PA1)) | (3 << (2 * LED_PA3)) | (3 << (2 * LED_PA4)) | (3 << (2 * BUTTON_PA2)));
+    GPIOA_MODER |= (1 << (2 * LED_PA1)) | (1 << (2 * LED_PA3)) | (1 << (2 * LED_PA4));
+
+    GPIOB_MODER &= ~((3 << (2 * BUTTON_PB5)) | (3 << (2 * BUTTON_PB7)));
+    GPIOB_PUPDR &= ~((3 << (2 * BUTTON_PB5)) | (3 << (2 * BUTTON_PB7)));
+    GPIOB_PUPDR |= (1 << (2 * BUTTON_PB5)) | (1 << (2 * BUTTON_PB7)); // pull-up, button to GND
+
+    GPIOC_MODER &= ~(3U << (2 * BUTTON_PC13));
+
+    NVIC_Init();
+
+    EXTI_Init(EXTI_PORT_A, BUTTON_PA2, EXTI_EDGE_RISING, Button_PA2_Pressed);
+    EXTI_Init(EXTI_PORT_B, BUTTON_PB5, EXTI_EDGE_FALLING, Button_PB_Pressed);
+    EXTI_Init(EXTI_PORT_B, BUTTON_PB7, EXTI_EDGE_FALLING, Button_PB_Pressed);
+    EXTI_Init(EXTI_PORT_C, BUTTON_PC13, EXTI_EDGE_FALLING, Button_PC13_Pressed);
+
+    while (1)
+    {
+    }
+}
@@ -0,0 +1,211 @@
+// Flash wait states, prefetch and ART caches measured with DWT CYCCNT (STM32F411 / F446)
+// Three loops (GPIO toggle, delay spin, 16-tap FIR with coefficients in flash), each compiled twice from the
+// same body: once in flash, once in SRAM. Every accelerator setting is measured at 16 MHz (0 WS) and at
+// 84 MHz from the PLL (2 WS). Cycles per iteration end up in Results[] (read them with the debugger);
+// LED PA5 turns on when the run is complete.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/Flash_ACR_STM32F4xx.h"
+
+#define RCC_BASE 0x40023800UL
+#define RCC_CR (*(volatile uint32_t *)(RCC_BASE + 0x00))
+#define RCC_PLLCFGR (*(volatile uint32_t *)(RCC_BASE + 0x04))
+#define RCC_CFGR (*(volatile uint32_t *)(RCC_BASE + 0x08))
+#define RCC_AHB1ENR (*(volatile uint32_t *)(RCC_BASE + 0x30))
+
+#define GPIOA_MODER (*(volatile uint32_t *)(0x40020000UL + 0x00))
+#define GPIOA_BSRR (*(volatile uint32_t *)(0x40020000UL + 0x18))
+
+#define DEMCR (*(volatile uint32_t *)(0xE000EDFCUL))
+#define DWT_CTRL (*(volatile uint32_t *)(0xE0001000UL))
+#define DWT_CYCCNT (*(volatile uint32_t *)(0xE0001004UL))
+
+#define LED_PA5 5
+
+#define HSI_CLK 16000000UL
+#define PLL_CLK 84000000UL // HSI / 8 * 168 / 4; VOS scale 2 is enough on the F411, reset value on both
+
+// Placed in .data: the startup code copies it to SRAM with the initialised variables, no linker script
+// changes needed. long_call because SRAM (0x2000 0000) is out of BL range from flash (0x0800 0000).
+#define SRAM_CODE __attribute__((section(".data.ramfunc"), noinline, long_call))
+#define FLASH_CODE __attribute__((noinline))
+
+#define TOGGLE_ITERATIONS 1000U
+#define DELAY_ITERATIONS 1000U
+#define FIR_TAPS 16U
+#define FIR_BLOCK 64U
+
+/*-------------------------------------------Kernels (one body, two placements)-------------------------------*/
+
+// Same 16-tap low-pass as the DSP benchmark; const = read from flash through the data cache
+const int16_t Fir_Coeffs[FIR_TAPS] =
+{
+    -114, -159, -139, 291, 1450, 3284, 5246, 6524, 6524, 5246, 3284, 1450, 291, -139, -159, -114
+};
+
+int16_t Fir_Input[FIR_TAPS - 1U + FIR_BLOCK];
+int16_t Fir_Output[FIR_BLOCK];
+
+static inline __attribute__((always_inline)) void Toggle_Body(void)
+{
+    for (uint32_t i = 0; i < TOGGLE_ITERATIONS; i++)
+    {
+        GPIOA_BSRR = (1U << LED_PA5);
+        GPIOA_BSRR = (1U << (LED_PA5 + 16U));
+    }
+}
+
+// The repository's delay idiom: a volatile counter, so every iteration is a load / add / store / compare
+static inline __attribute__((always_inline)) void Delay_Body(void)
+{
+    for (volatile uint32_t i = 0; i < DELAY_ITERATIONS; i++)
+    {
+    }
+}
+
+static inline __attribute__((always_inline)) void Fir_Body(void)
+{
+    for (uint32_t n = 0; n < FIR_BLOCK; n++)
+    {
+        int32_t acc = 0;
+
+        for (uint32_t k = 0; k < FIR_TAPS; k++)
+        {
+            acc += (int32_t)Fir_Coeffs[k] * Fir_Input[n + k];
+        }
+
+        Fir_Output[n] = (int16_t)(acc >> 15);
+    }
+}
+
+FLASH_CODE void Toggle_Flash(void) { Toggle_Body(); }
+FLASH_CODE void Delay_Flash(void) { Delay_Body(); }
+FLASH_CODE void Fir_Flash(void) { Fir_Body(); }
+
+SRAM_CODE void Toggle_Sram(void) { Toggle_Body(); }
+SRAM_CODE void Delay_Sram(void) { Delay_Body(); }
+SRAM_CODE void Fir_Sram(void) { Fir_Body(); }
+
+typedef enum KERNEL
+{
+    KERNEL_TOGGLE = 0, // per toggle pair
+    KERNEL_DELAY = 1,  // per spin
+    KERNEL_FIR = 2,    // per output sample (16 MACs)
+    KERNEL_COUNT = 3
+} KERNEL;
+
+typedef enum PLACEMENT
+{
+    IN_FLASH = 0,
+    IN_SRAM = 1
+} PLACEMENT;
+
+typedef void (*Kernel_t)(void);
+
+const Kernel_t Kernels[KERNEL_COUNT][2] =
+{
+    {Toggle_Flash, Toggle_Sram},
+    {Delay_Flash, Delay_Sram},
+    {Fir_Flash, Fir_Sram},
+};
+
+const uint32_t Kernel_Iterations[KERNEL_COUNT] = {TOGGLE_ITERATIONS, DELAY_ITERATIONS, FIR_BLOCK};
+
+/*-------------------------------------------Configurations--------------------------------------------------*/
+
+typedef struct BENCH_CONFIG
+{
+    uint32_t hclk;
+    uint8_t features;
+} BENCH_CONFIG;
+
+const BENCH_CONFIG Configs[] =
+{
+    {HSI_CLK, 0},                           // 0 WS, accelerator off
+    {HSI_CLK, FLASH_ART_ALL},               // 0 WS, accelerator on
+    {PLL_CLK, 0},                           // 2 WS, every fetch waits
+    {PLL_CLK, FLASH_PREFETCH},              // 2 WS, sequential fetch hidden
+    {PLL_CLK, FLASH_ICACHE},                // 2 WS, loops hit the instruction cache
+    {PLL_CLK, FLASH_ICACHE | FLASH_DCACHE}, // 2 WS, + literal pools / const data cached
+    {PLL_CLK, FLASH_ART_ALL},               // 2 WS, everything on (recommended)
+};
+
+#define CONFIG_COUNT (sizeof(Configs) / sizeof(Configs[0]))
+
+// Cycles per iteration x 10, warm run (second call: caches filled, branch targets fetched once)
+uint32_t Results[CONFIG_COUNT][KERNEL_COUNT][2];
+
+uint32_t Measure(Kernel_t Kernel)
+{
+    uint32_t start;
+
+    Kernel(); // warm up
+    start = DWT_CYCCNT;
+    Kernel();
+    return DWT_CYCCNT - start;
+}
+
+/*-------------------------------------------Clock: HSI -> PLL 84 MHz----------------------------------------*/
+
+void Clock_PLL_84MHz(void)
+{
+    // VCO in = 16 / 8 = 2 MHz, VCO = 2 * 168 = 336 MHz, SYSCLK = 336 / 4 = 84 MHz, USB = 336 / 7 = 48 MHz
+    RCC_PLLCFGR = (RCC_PLLCFGR & ~((0x3FUL << 0) | (0x1FFUL << 6) | (3UL << 16) | (1UL << 22) | (0xFUL << 24))) |
+                  (8UL << 0) | (168UL << 6) | (1UL << 16) | (7UL << 24);
+    RCC_CR |= (1UL << 24); // PLLON
+
+    while (!(RCC_CR & (1UL << 25)))
+    {
+    }
+
+    RCC_CFGR = (RCC_CFGR & ~(7UL << 10)) | (4UL << 10); // APB1 = HCLK / 2 (42 MHz max on the F411 / 45 on F446)
+
+    FLASH_Prepare_Clock_Change(PLL_CLK); // wait states first, then the faster clock
+    RCC_CFGR = (RCC_CFGR & ~3UL) | 2UL;
+
+    while (((RCC_CFGR >> 2) & 3UL) != 2UL)
+    {
+    }
+
+    FLASH_Finish_Clock_Change(PLL_CLK);
+}
+
+int main(void)
+{
+    RCC_AHB1ENR |= (1 << 0);
+    GPIOA_MODER &= ~(3U << (LED_PA5 * 2));
+    GPIOA_MODER |= (1U << (LED_PA5 * 2));
+
+    DEMCR |= (1UL << 24);
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= (1UL << 0);
+
+    for (uint32_t i = 0; i < (FIR_TAPS - 1U + FIR_BLOCK); i++)
+    {
+        Fir_Input[i] = (int16_t)((i * 2731U) & 0x7FFFU);
+    }
+
+    for (uint8_t c = 0; c < CONFIG_COUNT; c++)
+    {
+        if ((Configs[c].hclk == PLL_CLK) && (FLASH_Get_Latency() == 0U))
+        {
+            Clock_PLL_84MHz();
+        }
+
+        FLASH_Configure(Configs[c].hclk, Configs[c].features);
+
+        for (uint8_t k = 0; k < KERNEL_COUNT; k++)
+        {
+            for (uint8_t p = IN_FLASH; p <= IN_SRAM; p++)
+            {
+                Results[c][k][p] = (Measure(Kernels[k][p]) * 10U) / Kernel_Iterations[k];
+            }
+        }
+    }
+
+    GPIOA_BSRR = (1U << LED_PA5);
+
+    while (1)
+    {
+    }
+}
@@ -0,0 +1,83 @@
+// 4 bit binary counter with the edges counted by TIM2 in external clock mode 2 (STM32F446xx / STM32F411xx)
+// The pulse input is PA15 = TIM2_ETR (AF1), button or signal generator. No interrupt per edge: the LEDs on
+// PA0 - PA3 show the low 4 bits of TIM2_CNT, refreshed from the SysTick interrupt at 1 kHz, which also
+// measures the input rate once per second. Channel 1 compares at BATCH_PULSES and raises Batch_Done.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/Pulse_Counter_STM32F4xx.h"
+
+#define GPIOA_MODER (*(volatile uint32_t *)(0x40020000UL + 0x00))
+#define GPIOA_BSRR (*(volatile uint32_t *)(0x40020000UL + 0x18))
+
+#define SYST_CSR (*(volatile uint32_t *)(0xE000E010UL))
+#define SYST_RVR (*(volatile uint32_t *)(0xE000E014UL))
+#define SYST_CVR (*(volatile uint32_t *)(0xE000E018UL))
+
+#define CLK_FRQ 16000000UL
+#define LED_RST_MASK 0xFU // PA0 - PA3 led connected
+#define GPIO_PORT_A 0U
+#define ETR_PA15 15U
+
+#define BATCH_PULSES 1000U
+
+volatile uint32_t Rate_Hz;
+volatile uint32_t Batch_Done;
+volatile uint64_t Total_Pulses;
+
+static uint32_t Ms_Ticks;
+static uint64_t Last_Total;
+
+void Batch_Callback(uint8_t Channel, uint32_t Count)
+{
+    (void)Channel;
+    (void)Count;
+    Batch_Done++;
+}
+
+void SysTick_Handler(void)
+{
+    uint32_t count = Pulse_Counter_Read();
+
+    GPIOA_BSRR = (LED_RST_MASK << 16) | (count & LED_RST_MASK); // reset + set in one write: no dark gap
+
+    if (++Ms_Ticks >= 1000U)
+    {
+        Ms_Ticks = 0;
+        Total_Pulses = Pulse_Counter_Total();
+        Rate_Hz = (uint32_t)(Total_Pulses - Last_Total);
+        Last_Total = Total_Pulses;
+    }
+}
+
+int main(void)
+{
+    // Button: 8 samples at f_DTS / 32 = 16 us stable; for a clean flow-meter signal use filter 3 (0.5 us)
+    const Pulse_Counter_Config_t config =
+    {
+        .input = PULSE_INPUT_ETR,
+        .falling = 0,
+        .filter = 15,
+        .etr_prescaler = 0,
+        .modulus = 0, // full 32 bits, the LEDs show CNT modulo 16
+        .extend = 1   // one interrupt per 2^32 pulses
+    };
+
+    NVIC_Init();
+
+    RCC_Clock_Enable(RCC_CLK_GPIOA);
+    GPIOA_MODER &= ~0xFFU;
+    GPIOA_MODER |= 0x55U; // PA0 - PA3 output
+
+    GP_Timer_Pin(TIM_2, GPIO_PORT_A, ETR_PA15, GP_TIMER_PULL_DOWN);
+    Pulse_Counter_Init(&config);
+    Pulse_Counter_Set_Threshold(1, BATCH_PULSES, Batch_Callback);
+
+    SYST_RVR = (CLK_FRQ / 1000U) - 1U;
+    SYST_CVR = 0;
+    SYST_CSR = (1U << 0) | (1U << 1) | (1U << 2);
+
+    while (1)
+    {
+        __asm volatile("wfi");
+    }
+}
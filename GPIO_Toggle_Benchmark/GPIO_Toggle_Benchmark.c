@@ -0,0 +1,335 @@
+// Maximum GPIO toggle rate per access strategy, measured with DWT CYCCNT and a timer loopback (STM32F411 / F446)
+// Every strategy drives PA6. A wire from PA6 to PA0 (TIM2_ETR) feeds the pulse counter, so the edges that
+// really reached the pin are counted in hardware next to the CPU's cycle count.
+// Results[] holds cycles per edge and the sustained square-wave frequency (read them with the debugger).
+// Same file on the host (gcc -O2 GPIO_Toggle_Benchmark.c) runs the CPU strategies against a simulated port
+// in RAM and prints ns per edge: relative cost of the access patterns only, no bus timing.
+
+#include <stdint.h>
+
+#define TOGGLE_PAIRS 1024U // per CPU strategy: 2048 edges, loop unrolled by 8 pairs
+#define UNROLL 8U
+#define BENCH_PIN 6U
+
+/*-------------------------------------------Port under test-----------------------------------------------*/
+
+typedef struct GPIO_Regs_t
+{
+    volatile uint32_t MODER;
+    volatile uint32_t OTYPER;
+    volatile uint32_t OSPEEDR;
+    volatile uint32_t PUPDR;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t LCKR;
+    volatile uint32_t AFR[2];
+} GPIO_Regs_t;
+
+#if defined(__arm__)
+
+#include "../Device_Driver_Devlopment/Pulse_Counter_STM32F4xx.h"
+#include "../Device_Driver_Devlopment/DMA_Driver_STM32F4xx.h"
+#include "../Device_Driver_Devlopment/Led_Driver_STM32F446RE.h" // GPIO_TogglePin(): the driver-header path
+
+#define BENCH_BASE 0x40020000UL // GPIOA
+
+// Bit-band alias: one word per bit of the peripheral region (0x4000 0000 -> 0x4200 0000)
+#define BITBAND_PERIPH(addr, bit) (*(volatile uint32_t *)(0x42000000UL + (((addr) - 0x40000000UL) * 32U) + ((bit) * 4U)))
+#define BENCH_ODR_BIT BITBAND_PERIPH(BENCH_BASE + 0x14U, BENCH_PIN)
+
+#define DEMCR (*(volatile uint32_t *)(0xE000EDFCUL))
+#define DWT_CTRL (*(volatile uint32_t *)(0xE0001000UL))
+#define DWT_CYCCNT (*(volatile uint32_t *)(0xE0001004UL))
+
+#define BENCH_NOW() (DWT_CYCCNT)
+
+#define HCLK 16000000UL // HSI, timers at HCLK (APB1 prescaler 1)
+#define GPIO_PORT_A 0U
+#define LOOPBACK_PA0 0U
+#define ETR_DIV 8U          // ETPS /8: the counter follows inputs up to 8 x HCLK / 4
+#define DMA_EDGES 1024U     // memory-to-memory burst of BSRR words
+#define DMA_STREAM 4U       // DMA2 stream 4: not used by any other driver here
+#define TIMER_WINDOW 16000U // cycles the output-compare strategy runs for
+
+#else
+
+#include <stdio.h>
+#include <time.h>
+
+static GPIO_Regs_t Sim_Port;
+static volatile uint32_t Sim_Bitband[16];
+
+#define BENCH_BASE ((uintptr_t)&Sim_Port)
+#define BENCH_ODR_BIT (Sim_Bitband[BENCH_PIN])
+
+static uint32_t Host_Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((ts.tv_sec * 1000000000ULL) + ts.tv_nsec);
+}
+
+#define BENCH_NOW() Host_Now() // ns instead of cycles on the host
+
+#endif
+
+#define BENCH_ODR (*(volatile uint32_t *)(BENCH_BASE + 0x14))
+#define BENCH_BSRR (*(volatile uint32_t *)(BENCH_BASE + 0x18))
+#define BENCH_PORT ((GPIO_Regs_t *)BENCH_BASE)
+
+#define PIN_SET (1UL << BENCH_PIN)
+#define PIN_RESET (1UL << (BENCH_PIN + 16U))
+
+/*-------------------------------------------CPU strategies (one toggle pair per step)-----------------------*/
+
+#define UNROLLED(step)                                     \
+    for (uint32_t i = 0; i < (TOGGLE_PAIRS / UNROLL); i++) \
+    {                                                      \
+        step step step step step step step step            \
+    }
+
+// ODR read-modify-write: LDR, ORR / BIC, STR per edge; not safe against an ISR touching the same port
+__attribute__((noinline)) void Toggle_ODR_RMW(void)
+{
+    UNROLLED(BENCH_ODR |= PIN_SET; BENCH_ODR &= ~PIN_SET;)
+}
+
+// BSRR: one store per edge, no read, atomic against other pins' writers
+__attribute__((noinline)) void Toggle_BSRR(void)
+{
+    UNROLLED(BENCH_BSRR = PIN_SET; BENCH_BSRR = PIN_RESET;)
+}
+
+// ODR XOR: the classic one-line toggle, still a read-modify-write per edge
+__attribute__((noinline)) void Toggle_ODR_XOR(void)
+{
+    UNROLLED(BENCH_ODR ^= PIN_SET; BENCH_ODR ^= PIN_SET;)
+}
+
+// Bit-band alias of the ODR bit: one store per edge, the bus does the read-modify-write (locked)
+__attribute__((noinline)) void Toggle_Bitband(void)
+{
+    UNROLLED(BENCH_ODR_BIT = 1U; BENCH_ODR_BIT = 0U;)
+}
+
+// Struct overlay (CMSIS style): base in a register, BSRR at an immediate offset
+__attribute__((noinline)) void Toggle_Struct(void)
+{
+    GPIO_Regs_t *port = BENCH_PORT;
+
+    UNROLLED(port->BSRR = PIN_SET; port->BSRR = PIN_RESET;)
+}
+
+#if defined(__arm__)
+
+// Repository driver path: function call, ODR read, branch, BSRR store through pointers
+__attribute__((noinline)) void Toggle_Driver(void)
+{
+    UNROLLED(GPIO_TogglePin(&GPIOA_ODR, &GPIOA_BSRR, GPIOA_PA6); GPIO_TogglePin(&GPIOA_ODR, &GPIOA_BSRR, GPIOA_PA6);)
+}
+
+#endif
+
+typedef void (*Toggle_t)(void);
+
+typedef struct Strategy_t
+{
+    const char *name;
+    Toggle_t run;
+} Strategy_t;
+
+static const Strategy_t Cpu_Strategies[] =
+{
+    {"ODR RMW", Toggle_ODR_RMW},
+    {"BSRR", Toggle_BSRR},
+    {"ODR XOR", Toggle_ODR_XOR},
+    {"bit-band", Toggle_Bitband},
+    {"struct overlay", Toggle_Struct},
+#if defined(__arm__)
+    {"driver GPIO_TogglePin", Toggle_Driver},
+#endif
+};
+
+#define CPU_STRATEGY_COUNT (sizeof(Cpu_Strategies) / sizeof(Cpu_Strategies[0]))
+
+/*-------------------------------------------Results--------------------------------------------------------*/
+
+typedef struct Bench_Result_t
+{
+    const char *name;
+    uint32_t edges;          // edges the strategy produced
+    uint32_t time;           // cycles (target) / ns (host)
+    uint32_t per_edge_x100;  // cycles (ns) per edge x 100
+    uint32_t toggle_hz;      // sustained square-wave frequency on the pin (target)
+    uint32_t loopback_edges; // edges seen by the TIM2 ETR counter (target, +- ETR_DIV)
+} Bench_Result_t;
+
+Bench_Result_t Results[CPU_STRATEGY_COUNT + 2U];
+uint8_t Result_Count = 0;
+
+static void Record(const char *Name, uint32_t Edges, uint32_t Time, uint32_t Loopback)
+{
+    Bench_Result_t *r = &Results[Result_Count++];
+
+    r->name = Name;
+    r->edges = Edges;
+    r->time = Time;
+    r->per_edge_x100 = (uint32_t)(((uint64_t)Time * 100U) / Edges);
+    r->loopback_edges = Loopback;
+#if defined(__arm__)
+    r->toggle_hz = (uint32_t)(((uint64_t)HCLK * Edges) / (2U * (uint64_t)Time));
+#else
+    r->toggle_hz = 0;
+#endif
+}
+
+#if defined(__arm__)
+
+/*-------------------------------------------Hardware strategies--------------------------------------------*/
+
+static uint32_t Dma_Table[DMA_EDGES]; // alternating set / reset words
+
+static void Pin_Mode(uint32_t Mode)
+{
+    GPIOA_MODER = (GPIOA_MODER & ~(3UL << (2U * BENCH_PIN))) | (Mode << (2U * BENCH_PIN));
+}
+
+static uint32_t Loopback_Edges(void)
+{
+    return 2U * ETR_DIV * Pulse_Counter_Read(); // rising edges / 8 -> all edges
+}
+
+// DMA2 memory-to-memory: the source walks the table, the destination stays on BSRR. Paced only by the
+// bus matrix and AHB1, this is the fastest any DMA can drive the pin.
+static void Bench_DMA(void)
+{
+    uint32_t start;
+
+    for (uint32_t i = 0; i < DMA_EDGES; i++)
+    {
+        Dma_Table[i] = (i & 1U) ? PIN_RESET : PIN_SET;
+    }
+
+    DMA_Stream_Init(DMA_2, DMA_STREAM,
+                    DMA_CR_DIR_M2M | DMA_CR_PINC | DMA_CR_PSIZE_32 | DMA_CR_MSIZE_32 | DMA_CR_PL(3),
+                    DMA_FCR_DMDIS | DMA_FCR_FTH_FULL, Dma_Table, 0, 0, 0, 0);
+
+    Pulse_Counter_Reset();
+    start = BENCH_NOW();
+    DMA_Stream_Start(DMA_2, DMA_STREAM, &GPIOA_BSRR, DMA_EDGES);
+
+    while (!(DMA_Stream_Get_Flags(DMA_2, DMA_STREAM) & DMA_FLAG_TC))
+    {
+    }
+
+    Record("DMA to BSRR", DMA_EDGES, BENCH_NOW() - start, Loopback_Edges());
+    DMA_Stream_Stop(DMA_2, DMA_STREAM);
+}
+
+// TIM3_CH1 on PA6 in toggle mode with ARR = 1, CCR1 = 0: an edge every 2 timer clocks and no CPU at all.
+// The edges are counted over a fixed DWT window.
+static void Bench_Timer(void)
+{
+    uint32_t start;
+
+    RCC_Clock_Enable(GP_Timer_Clock(TIM_3));
+    GP_Timer_Reset(TIM_3);
+    TIMx_ARR(TIM_3) = 1U;
+    TIMx_CCR(TIM_3, 1) = 0U;
+    GP_Timer_Load_Prescaler(TIM_3, 0);
+    TIMx_CCMR(TIM_3, 1) = (3UL << 4); // OC1M = 011 toggle on match
+    TIMx_CCER(TIM_3) = 1U;            // CC1E
+
+    GP_Timer_Pin(TIM_3, GPIO_PORT_A, BENCH_PIN, GP_TIMER_PULL_NONE); // PA6 -> AF2
+
+    Pulse_Counter_Reset();
+    start = BENCH_NOW();
+    TIMx_CR1(TIM_3) = TIM_CR1_CEN;
+
+    while ((BENCH_NOW() - start) < TIMER_WINDOW)
+    {
+    }
+
+    TIMx_CR1(TIM_3) = 0;
+    Record("timer output compare", Loopback_Edges(), BENCH_NOW() - start, Loopback_Edges());
+
+    TIMx_CCER(TIM_3) = 0;
+    RCC_Clock_Release(GP_Timer_Clock(TIM_3));
+    Pin_Mode(1U);
+}
+
+int main(void)
+{
+    const Pulse_Counter_Config_t loopback =
+    {
+        .input = PULSE_INPUT_ETR,
+        .falling = 0,
+        .filter = 0, // no filter: the filter would swallow the fastest strategies
+        .etr_prescaler = 3,
+        .modulus = 0,
+        .extend = 0
+    };
+
+    NVIC_Init();
+
+    DEMCR |= 1UL << 24; // TRCENA
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1U;
+
+    GPIO_Init(GPIOA_PA6);
+    BENCH_PORT->OSPEEDR |= 3UL << (2U * BENCH_PIN); // very high speed: the edges must keep up with the fastest strategy
+
+    GP_Timer_Pin(TIM_2, GPIO_PORT_A, LOOPBACK_PA0, GP_TIMER_PULL_NONE);
+    Pulse_Counter_Init(&loopback);
+
+    for (uint8_t s = 0; s < CPU_STRATEGY_COUNT; s++)
+    {
+        uint32_t start;
+        uint32_t cycles;
+
+        GPIOA_BSRR = PIN_RESET;
+        Pulse_Counter_Reset();
+
+        start = BENCH_NOW();
+        Cpu_Strategies[s].run();
+        cycles = BENCH_NOW() - start;
+
+        Record(Cpu_Strategies[s].name, 2U * TOGGLE_PAIRS, cycles, Loopback_Edges());
+    }
+
+    Bench_DMA();
+    Bench_Timer();
+
+    while (1)
+    {
+        __asm volatile("wfi");
+    }
+}
+
+#else
+
+int main(void)
+{
+    for (uint8_t s = 0; s < CPU_STRATEGY_COUNT; s++)
+    {
+        uint32_t start = BENCH_NOW();
+
+        Cpu_Strategies[s].run();
+        Record(Cpu_Strategies[s].name, 2U * TOGGLE_PAIRS, BENCH_NOW() - start, 0);
+    }
+
+    printf("%-22s %12s\n", "strategy", "ns / edge");
+
+    for (uint8_t i = 0; i < Result_Count; i++)
+    {
+        printf("%-22s %9u.%02u\n", Results[i].name, (unsigned)(Results[i].per_edge_x100 / 100U),
+               (unsigned)(Results[i].per_edge_x100 % 100U));
+    }
+
+    printf("(simulated port in RAM: DMA, timer and bus wait states exist only on the target)\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,86 @@
+// 64-bit microsecond timebase from TIM2 -> TIM5 chained in hardware, no timer interrupt at all
+// TIM2 counts 1 MHz ticks, its overflow clocks TIM5 through ITR0. The LED PA5 blink is scheduled from
+// Chain64_Now() in the super loop; a 1 kHz SysTick interrupt reads the same clock and preempts the loop
+// in the middle of its reads. Both sides check that time never goes backwards: Monotonic_Errors stays 0,
+// also across the TIM2 wraps (the first one is forced 1 s after start by presetting TIM2_CNT).
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/Timer_Chain64_STM32F4xx.h"
+
+#define GPIOA_MODER (*(volatile uint32_t *)(0x40020000UL + 0x00))
+#define GPIOA_BSRR (*(volatile uint32_t *)(0x40020000UL + 0x18))
+
+#define SYST_CSR (*(volatile uint32_t *)(0xE000E010UL))
+#define SYST_RVR (*(volatile uint32_t *)(0xE000E014UL))
+#define SYST_CVR (*(volatile uint32_t *)(0xE000E018UL))
+
+#define HSI_CLK 16000000UL
+#define TICK_HZ 1000000UL
+#define LED_PA5 5U
+#define BLINK_US 500000ULL
+
+volatile uint64_t Isr_Last;
+volatile uint32_t Isr_Reads;
+volatile uint32_t Monotonic_Errors;
+volatile uint32_t Wraps_Seen;
+uint64_t Uptime_Us;
+
+void SysTick_Handler(void)
+{
+    uint64_t now = Chain64_Now();
+
+    if (now < Isr_Last)
+    {
+        Monotonic_Errors++;
+    }
+
+    Isr_Last = now;
+    Isr_Reads++;
+}
+
+int main(void)
+{
+    uint64_t last = 0;
+    uint64_t next_blink;
+    uint32_t last_high = 0;
+    uint8_t led = 0;
+
+    RCC_Clock_Enable(RCC_CLK_GPIOA);
+    GPIOA_MODER &= ~(3U << (LED_PA5 * 2U));
+    GPIOA_MODER |= (1U << (LED_PA5 * 2U));
+
+    Chain64_Init(TIM_2, TIM_5, HSI_CLK, TICK_HZ);
+    TIMx_CNT(TIM_2) = 0xFFFFFFFFUL - TICK_HZ; // first 32-bit wrap after 1 s instead of 71 min
+    next_blink = Chain64_Now() + BLINK_US;
+
+    SYST_RVR = (HSI_CLK / 1000U) - 1U;
+    SYST_CVR = 0;
+    SYST_CSR = (1U << 0) | (1U << 1) | (1U << 2); // enable, interrupt, processor clock
+
+    while (1)
+    {
+        uint64_t now = Chain64_Now();
+
+        if (now < last)
+        {
+            Monotonic_Errors++;
+        }
+
+        if ((uint32_t)(now >> 32) != last_high)
+        {
+            last_high = (uint32_t)(now >> 32);
+            Wraps_Seen++;
+        }
+
+        last = now;
+
+        if (now >= next_blink)
+        {
+            next_blink += BLINK_US;
+            led ^= 1U;
+            GPIOA_BSRR = (Monotonic_Errors || led) ? (1U << LED_PA5) : (1U << (LED_PA5 + 16U)); // errors: LED stays on
+        }
+
+        Uptime_Us = Chain64_Ticks_To_Us(now);
+    }
+}
@@ -0,0 +1,102 @@
+// TIM2 1 ms timebase that keeps counting while a slow EXTI handler runs (NVIC priority plan) STM32F411
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/EXTI_Driver_STM32F4xx.h"
+
+#define TIM2_BASE 0x40000000UL
+#define TIM2_CR1 (*(volatile uint32_t *)(TIM2_BASE + 0x00))
+#define TIM2_DIER (*(volatile uint32_t *)(TIM2_BASE + 0x0C))
+#define TIM2_SR (*(volatile uint32_t *)(TIM2_BASE + 0x10))
+#define TIM2_EGR (*(volatile uint32_t *)(TIM2_BASE + 0x14))
+#define TIM2_PSC (*(volatile uint32_t *)(TIM2_BASE + 0x28))
+#define TIM2_ARR (*(volatile uint32_t *)(TIM2_BASE + 0x2C))
+
+#define TIM2_IRQn 28U
+
+#define GPIOA_BASE 0x40020000UL
+#define GPIOA_MODER (*(volatile uint32_t *)(GPIOA_BASE + 0x00))
+#define GPIOA_ODR (*(volatile uint32_t *)(GPIOA_BASE + 0x14))
+#define GPIOA_BSRR (*(volatile uint32_t *)(GPIOA_BASE + 0x18))
+
+#define HSI_CLK 16000000U
+#define LED_PA3 3
+#define BUTTON_PA2 2
+
+volatile uint32_t ms_counter = 0;
+volatile uint32_t button_events = 0;
+
+void TIM2_IRQHandler(void)
+{
+    TIM2_SR = ~(1U << 0); // UIF is rc_w0: writing 1 to the other flags leaves them untouched
+    ms_counter++;
+}
+
+// Deliberately slow handler (~5 ms). At NVIC_PREEMPT_EXTI it is preempted by TIM2,
+// so ms_counter still advances by 5 while it runs. With default priorities it would not.
+void Button_Pressed(uint8_t Line)
+{
+    (void)Line;
+    uint32_t start = ms_counter;
+
+    while ((ms_counter - start) < 5U)
+    {
+    }
+
+    button_events++;
+}
+
+void Init_TIM2_Timebase(void)
+{
+    RCC_Clock_Ensure(RCC_CLK_TIM2);
+    TIM2_PSC = (HSI_CLK / 1000000U) - 1; // 1 MHz
+    TIM2_ARR = 1000U - 1;                // 1 ms update
+    TIM2_EGR = 1 << 0;
+    TIM2_SR = 0;
+    TIM2_DIER |= 1 << 0;
+
+    NVIC_Setup_IRQ(TIM2_IRQn, NVIC_PREEMPT_TIMEBASE, 0);
+
+    TIM2_CR1 |= 1 << 0;
+}
+
+void delay(uint32_t ms)
+{
+    uint32_t start_time = ms_counter;
+    while ((ms_counter - start_time) < ms);
+}
+
+int main(void)
+{
+    NVIC_Init();
+
+    RCC_Clock_Ensure(RCC_CLK_GPIOA);
+    GPIOA_MODER &= ~((3 << (LED_PA3 * 2)) | (3 << (BUTTON_PA2 * 2)));
+    GPIOA_MODER |= 1 << (LED_PA3 * 2);
+
+    Init_TIM2_Timebase();
+    EXTI_Init(EXTI_PORT_A, BUTTON_PA2, EXTI_EDGE_RISING, Button_Pressed);
+
+    while (1)
+    {
+        // Read-and-clear of a counter shared with the EXTI callback.
+        // Only EXTI (and less urgent) IRQs are masked; the TIM2 timebase keeps running.
+        uint32_t state = NVIC_Enter_Critical(NVIC_PREEMPT_EXTI);
+        uint32_t events = button_events;
+        button_events = 0;
+        NVIC_Exit_Critical(state);
+
+        if (events & 1U)
+        {
+            if (GPIOA_ODR & (1 << LED_PA3))
+            {
+                GPIOA_BSRR = 1 << (LED_PA3 + 16);
+            }
+            else
+            {
+                GPIOA_BSRR = 1 << LED_PA3;
+            }
+        }
+
+        delay(100);
+    }
+}
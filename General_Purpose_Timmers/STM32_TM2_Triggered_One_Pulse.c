@@ -0,0 +1,54 @@
+// Button edge -> delayed LED pulse entirely in hardware: TIM2 slave trigger mode + one-pulse mode
+// PA1 (TIM2_CH2, AF1) is the trigger input: a rising edge through the digital filter sets CEN.
+// PA5 (TIM2_CH1, AF1, LED) goes high 100 ms later and stays high for the width of the current table entry.
+// After each pulse the update DMA loads the next entry: widths cycle 100 / 200 / 300 / 400 ms.
+// The CPU sleeps; the only interrupt is one DMA transfer-complete per pass through the table.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/Timer_One_Pulse_STM32F4xx.h"
+
+#define HSI_CLK 16000000UL
+#define TICK_HZ 1000000UL // 1 us per tick, TIM2 is 32-bit: pulses up to 71 minutes
+
+#define GPIO_PORT_A 0U
+#define TRIGGER_PA1 1U
+#define LED_PA5 5U
+
+#define DELAY_US 100000U
+
+static const OPM_Pulse_t Pulse_Table[4] =
+{
+    OPM_PULSE(DELAY_US, 100000U),
+    OPM_PULSE(DELAY_US, 200000U),
+    OPM_PULSE(DELAY_US, 300000U),
+    OPM_PULSE(DELAY_US, 400000U)
+};
+
+int main(void)
+{
+    const OPM_Config_t config =
+    {
+        .timer = TIM_2,
+        .trigger = TIM_TS_TI2FP2,
+        .falling = 0,
+        .filter = 15, // 8 samples at f_DTS / 32: 16 us of stable level, rejects contact chatter spikes
+        .output_channel = 1,
+        .fast = 0,
+        .prescaler = (HSI_CLK / TICK_HZ) - 1U,
+        .delay = DELAY_US,
+        .width = 100000U
+    };
+
+    NVIC_Init();
+
+    GP_Timer_Pin(TIM_2, GPIO_PORT_A, TRIGGER_PA1, GP_TIMER_PULL_DOWN); // button to 3V3
+    GP_Timer_Pin(TIM_2, GPIO_PORT_A, LED_PA5, GP_TIMER_PULL_NONE);
+
+    OPM_Init(&config);
+    OPM_Attach_Sequence(Pulse_Table, 4, 1);
+
+    while (1)
+    {
+        __asm volatile("wfi");
+    }
+}
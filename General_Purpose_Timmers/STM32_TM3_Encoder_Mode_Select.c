@@ -0,0 +1,101 @@
+// Panel rotary encoder -> mode selection with TIM3 in encoder mode (STM32F411x / STM32F446xx)
+// A = PA6 (TIM3_CH1), B = PA7 (TIM3_CH2), AF2, contacts to GND with pull-ups, filter against chatter.
+// TIM3 decodes every edge in hardware (x4). TIM2 is a 1 ms timebase; every 10 ms it samples the encoder,
+// which extends the 16-bit CNT to a 64-bit position and measures the velocity.
+// One detent = 4 counts; the detent number modulo 4 selects the mode, shown one-hot on PA0 - PA3.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/Encoder_STM32F4xx.h"
+
+#define GPIOA_MODER (*(volatile uint32_t *)(0x40020000UL + 0x00))
+#define GPIOA_BSRR (*(volatile uint32_t *)(0x40020000UL + 0x18))
+
+#define HSI_CLK 16000000UL
+#define SAMPLE_HZ 100U
+#define COUNTS_PER_DETENT 4
+#define MODE_COUNT 4
+
+#define GPIO_PORT_A 0U
+#define ENC_A_PA6 6U
+#define ENC_B_PA7 7U
+#define LED_RST_MASK 0xFU // PA0 - PA3 led connected
+
+volatile uint32_t ms_counter;
+volatile int32_t Mode;
+volatile int32_t Velocity; // counts/s, signed
+volatile int8_t Direction;
+
+void TIM2_IRQHandler(void)
+{
+    TIMx_SR(TIM_2) = ~TIM_SR_UIF;
+    ms_counter++;
+
+    if ((ms_counter % (1000U / SAMPLE_HZ)) == 0U)
+    {
+        Encoder_Sample(TIM_3);
+    }
+}
+
+void Init_TIM2_Timebase(void)
+{
+    RCC_Clock_Enable(GP_Timer_Clock(TIM_2));
+    GP_Timer_Reset(TIM_2);
+
+    TIMx_ARR(TIM_2) = 1000U - 1U; // 1 ms update
+    GP_Timer_Load_Prescaler(TIM_2, (HSI_CLK / 1000000UL) - 1U); // 1 MHz
+    TIMx_DIER(TIM_2) = TIM_DIER_UIE;
+
+    NVIC_Setup_IRQ(GP_Timer_IRQn[TIM_2], NVIC_PREEMPT_TIMEBASE, 0);
+    TIMx_CR1(TIM_2) = TIM_CR1_CEN;
+}
+
+int main(void)
+{
+    const Encoder_Config_t config =
+    {
+        .timer = TIM_3,
+        .mode = ENCODER_X4,
+        .filter = 15, // 8 samples at f_DTS / 32: 16 us stable, mechanical contacts bounce for less
+        .reverse = 0,
+        .sample_hz = SAMPLE_HZ
+    };
+
+    NVIC_Init();
+
+    RCC_Clock_Enable(RCC_CLK_GPIOA);
+    GPIOA_MODER &= ~0xFFU;
+    GPIOA_MODER |= 0x55U; // PA0 - PA3 output
+
+    GP_Timer_Pin(TIM_3, GPIO_PORT_A, ENC_A_PA6, GP_TIMER_PULL_UP);
+    GP_Timer_Pin(TIM_3, GPIO_PORT_A, ENC_B_PA7, GP_TIMER_PULL_UP);
+
+    Encoder_Init(&config);
+    Init_TIM2_Timebase();
+
+    while (1)
+    {
+        int64_t position = Encoder_Position(TIM_3);
+        int32_t detent;
+
+        if (position < 0)
+        {
+            position -= COUNTS_PER_DETENT - 1; // floor: -1..-4 is detent -1, not 0 (C division truncates)
+        }
+
+        detent = (int32_t)(position / COUNTS_PER_DETENT);
+        int32_t mode = detent % MODE_COUNT;
+
+        if (mode < 0)
+        {
+            mode += MODE_COUNT; // turning left from 0 goes to the last mode
+        }
+
+        Mode = mode;
+        Velocity = Encoder_Velocity(TIM_3);
+        Direction = Encoder_Direction(TIM_3);
+
+        GPIOA_BSRR = (LED_RST_MASK << 16) | (1U << mode);
+
+        __asm volatile("wfi"); // next timebase tick
+    }
+}
@@ -0,0 +1,94 @@
+// 16 dimmable LEDs on arbitrary GPIO pins from TIM3 alone: sorted-edge software PWM (STM32F411x / STM32F446xx)
+// 200 Hz PWM, 250 brightness steps (TIM3 at 50 kHz). A brightness wave runs across the LEDs, one frame every
+// 20 ms. Levels come from a 16-entry gamma table, so there are never more than 16 distinct duties and at
+// most 17 interrupts per period, independent of the LED count. Edges_Per_Period shows the live figure.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/Soft_PWM_STM32F4xx.h"
+
+#define SYST_CSR (*(volatile uint32_t *)(0xE000E010UL))
+#define SYST_RVR (*(volatile uint32_t *)(0xE000E014UL))
+#define SYST_CVR (*(volatile uint32_t *)(0xE000E018UL))
+
+#define HSI_CLK 16000000UL
+#define PWM_HZ 200U
+#define PWM_STEPS 250U
+#define FRAME_MS 20U
+
+#define GPIO_PORT_A 0U
+#define GPIO_PORT_B 1U
+#define GPIO_PORT_C 2U
+
+#define LED_COUNT 16U
+#define LEVELS 16U
+
+typedef struct Led_Pin_t
+{
+    uint8_t port;
+    uint8_t pin;
+} Led_Pin_t;
+
+// Any output-capable pins; PA5 / PC13 are the board LEDs on the Nucleo-F446RE / Black Pill F411
+static const Led_Pin_t Led_Pins[LED_COUNT] =
+{
+    {GPIO_PORT_A, 0}, {GPIO_PORT_A, 1}, {GPIO_PORT_A, 4}, {GPIO_PORT_A, 5},
+    {GPIO_PORT_A, 6}, {GPIO_PORT_A, 7}, {GPIO_PORT_A, 8}, {GPIO_PORT_A, 9},
+    {GPIO_PORT_B, 0}, {GPIO_PORT_B, 1}, {GPIO_PORT_B, 10}, {GPIO_PORT_B, 12},
+    {GPIO_PORT_B, 13}, {GPIO_PORT_B, 14}, {GPIO_PORT_B, 15}, {GPIO_PORT_C, 13}
+};
+
+// Perceived brightness 0..15 -> duty in steps (gamma 2.2)
+static const uint16_t Gamma[LEVELS] = {0, 1, 3, 6, 11, 18, 27, 38, 51, 67, 85, 105, 129, 155, 184, 216};
+
+volatile uint8_t Edges_Per_Period;
+
+void delay_ms(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        while (((SYST_CSR >> 16) & 1U) == 0U)
+        {
+        }
+    }
+}
+
+int main(void)
+{
+    uint8_t channel[LED_COUNT];
+    uint32_t frame = 0;
+
+    NVIC_Init();
+
+    SYST_RVR = (HSI_CLK / 1000U) - 1U;
+    SYST_CVR = 0;
+    SYST_CSR = (1U << 0) | (1U << 2);
+
+    Soft_PWM_Init(HSI_CLK, PWM_HZ, PWM_STEPS);
+
+    for (uint8_t i = 0; i < LED_COUNT; i++)
+    {
+        channel[i] = Soft_PWM_Add_Channel(Led_Pins[i].port, Led_Pins[i].pin);
+    }
+
+    Soft_PWM_Start();
+
+    while (1)
+    {
+        // Triangle wave 0..15..0 over 30 frames, shifted by 2 frames per LED
+        for (uint8_t i = 0; i < LED_COUNT; i++)
+        {
+            uint32_t phase = (frame + (2U * i)) % (2U * (LEVELS - 1U));
+            uint32_t level = (phase < LEVELS) ? phase : ((2U * (LEVELS - 1U)) - phase);
+
+            Soft_PWM_Set_Duty(channel[i], Gamma[level]);
+        }
+
+        while (!Soft_PWM_Commit())
+        {
+        }
+
+        Edges_Per_Period = Soft_PWM_Edges_Per_Period();
+        frame++;
+        delay_ms(FRAME_MS);
+    }
+}
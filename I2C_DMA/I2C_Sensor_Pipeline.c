@@ -0,0 +1,107 @@
+// Two I2C sensors read back to back every millisecond on I2C1 at 400 kHz (STM32F411x / STM32F446xx)
+// PB8 = SCL, PB9 = SDA (Nucleo D15 / D14), external 2.2k pull-ups.
+// MPU-6050 at 0x68 (accel, temperature, gyro) and BMP280 at 0x76 (pressure, temperature).
+// SysTick queues both register reads; the I2C / DMA interrupts run them and the CPU never waits on a flag.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/I2C_DMA_Driver_STM32F4xx.h"
+
+// SysTick Registers-------------------------------------------------------------------
+#define SYST_CSR (*(volatile uint32_t *)(0xE000E010UL))
+#define SYST_RVR (*(volatile uint32_t *)(0xE000E014UL))
+#define SYST_CVR (*(volatile uint32_t *)(0xE000E018UL))
+
+#define CLK_FRQ 16000000UL
+#define LOAD_VAL ((CLK_FRQ / 1000U) - 1U)
+
+#define MPU6050_ADDRESS 0x68U
+#define MPU6050_PWR_MGMT_1 0x6BU
+#define MPU6050_ACCEL_XOUT_H 0x3BU
+
+#define BMP280_ADDRESS 0x76U
+#define BMP280_CTRL_MEAS 0xF4U
+#define BMP280_PRESS_MSB 0xF7U
+
+/*-------------------------------------------Transactions------------------------------------------------------*/
+
+const uint8_t Mpu_Wake[] = {MPU6050_PWR_MGMT_1, 0x00};
+const uint8_t Bmp_Normal_Mode[] = {BMP280_CTRL_MEAS, 0x27}; // T x1, P x1, normal mode
+const uint8_t Mpu_Data_Register = MPU6050_ACCEL_XOUT_H;
+const uint8_t Bmp_Data_Register = BMP280_PRESS_MSB;
+
+uint8_t Mpu_Raw[14];
+uint8_t Bmp_Raw[6];
+
+volatile uint32_t reads_done;
+volatile uint32_t read_errors[6]; // per I2C_STATUS
+
+void Read_Done(I2C_Transaction_t *Transaction)
+{
+    if (Transaction->status == I2C_OK)
+    {
+        reads_done++;
+    }
+    else
+    {
+        read_errors[Transaction->status]++;
+    }
+}
+
+I2C_Transaction_t Mpu_Init = {MPU6050_ADDRESS, Mpu_Wake, 2, 0, 0, Read_Done, 0, I2C_OK, 0};
+I2C_Transaction_t Bmp_Init = {BMP280_ADDRESS, Bmp_Normal_Mode, 2, 0, 0, Read_Done, 0, I2C_OK, 0};
+
+// Register pointer write, repeated start, burst read
+I2C_Transaction_t Mpu_Read = {MPU6050_ADDRESS, &Mpu_Data_Register, 1, Mpu_Raw, 14, Read_Done, 0, I2C_OK, 0};
+I2C_Transaction_t Bmp_Read = {BMP280_ADDRESS, &Bmp_Data_Register, 1, Bmp_Raw, 6, Read_Done, 0, I2C_OK, 0};
+
+/*-------------------------------------------1 ms tick-------------------------------------------------------*/
+
+void SysTick_Handler(void)
+{
+    I2C_Timeout_Tick(I2C_1);
+
+    // 22 payload bytes + 2 x (3 address / register bytes): ~0.7 ms at 400 kHz, so both fit in every tick
+    if (I2C_Idle(I2C_1))
+    {
+        I2C_Submit(I2C_1, &Mpu_Read);
+        I2C_Submit(I2C_1, &Bmp_Read);
+    }
+}
+
+void Systimer_Init(void)
+{
+    SYST_RVR = LOAD_VAL;
+    SYST_CVR = 0;
+
+    SYST_CSR = 0;
+    SYST_CSR |= (1 << 0) | (1 << 1) | (1 << 2); // enable, interrupt, processor clock
+}
+
+int main(void)
+{
+    int16_t accel_x = 0;
+    uint32_t pressure_raw = 0;
+
+    NVIC_Init();
+
+    I2C_Init(I2C_1, I2C_SPEED_FAST);
+    I2C_Submit(I2C_1, &Mpu_Init);
+    I2C_Submit(I2C_1, &Bmp_Init);
+
+    Systimer_Init();
+
+    while (1)
+    {
+        __asm volatile("wfi");
+
+        // Buffers are only rewritten while a read is queued; a snapshot between reads is consistent
+        if (I2C_Idle(I2C_1))
+        {
+            accel_x = (int16_t)(((uint16_t)Mpu_Raw[0] << 8) | Mpu_Raw[1]);
+            pressure_raw = ((uint32_t)Bmp_Raw[0] << 12) | ((uint32_t)Bmp_Raw[1] << 4) | ((uint32_t)Bmp_Raw[2] >> 4);
+        }
+
+        (void)accel_x;
+        (void)pressure_raw;
+    }
+}
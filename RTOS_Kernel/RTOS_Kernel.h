@@ -0,0 +1,860 @@
+// Minimal preemptive priority kernel for Cortex-M4F (STM32F411x / STM32F446xx)
+// PendSV context switch with lazy FPU stacking, CLZ ready bitmap, tickless idle,
+// semaphores, queues and event flags. Header-only like the rest of the drivers: include once in main.c.
+
+#ifndef RTOS_KERNEL_H
+#define RTOS_KERNEL_H
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/NVIC_Driver_STM32F4xx.h"
+
+/*-------------------------------------------Configuration------------------------------------------------*/
+
+#ifndef CLK_FRQ
+#define CLK_FRQ 16000000UL // Using STM32F411 CPU Clock (HSI)
+#endif
+
+#define RTOS_TICK_HZ 1000UL
+#define RTOS_CYCLES_PER_TICK (CLK_FRQ / RTOS_TICK_HZ)
+#define RTOS_MAX_IDLE_TICKS (0x00FFFFFFUL / RTOS_CYCLES_PER_TICK) // SysTick is 24 bit
+
+#define RTOS_PRIORITIES 32U                          // 0 = most urgent, one bitmap bit per level
+#define RTOS_IDLE_PRIORITY (RTOS_PRIORITIES - 1U)    // reserved for the idle task
+#define RTOS_IDLE_STACK_WORDS 64U
+
+// IRQs at this preempt level or less urgent may call the *_Give / *_Send / *_Set functions.
+// More urgent IRQs (TIM2 timebase, reserved level 0) are never masked by the kernel and must not call it.
+#define RTOS_MAX_SYSCALL_PREEMPT NVIC_PREEMPT_DMA
+
+#define RTOS_WAIT_FOREVER 0xFFFFFFFFUL
+#define RTOS_NO_WAIT 0UL
+
+/*-------------------------------------------SysTick / SCB--------------------------------------------------*/
+
+#define SYST_CSR (*(volatile uint32_t *)(0xE000E010UL))
+#define SYST_RVR (*(volatile uint32_t *)(0xE000E014UL))
+#define SYST_CVR (*(volatile uint32_t *)(0xE000E018UL))
+
+#define SYST_CSR_ENABLE (1UL << 0)
+#define SYST_CSR_TICKINT (1UL << 1)
+#define SYST_CSR_CLKSOURCE (1UL << 2)
+#define SYST_CSR_COUNTFLAG (1UL << 16)
+
+#define SCB_ICSR (*(volatile uint32_t *)(0xE000ED04UL))
+#define SCB_ICSR_PENDSVSET (1UL << 28)
+#define SCB_ICSR_PENDSTSET (1UL << 26)
+
+#define SCB_CPACR (*(volatile uint32_t *)(0xE000ED88UL))
+#define FPU_FPCCR (*(volatile uint32_t *)(0xE000EF34UL))
+#define FPU_FPCCR_ASPEN (1UL << 31) // hardware saves FP context on exception entry
+#define FPU_FPCCR_LSPEN (1UL << 30) // ... lazily, only if the handler touches the FPU
+
+/*-------------------------------------------Types--------------------------------------------------------*/
+
+typedef enum RTOS_RESULT
+{
+    RTOS_OK = 0,
+    RTOS_TIMEOUT = 1
+} RTOS_RESULT;
+
+typedef enum RTOS_TASK_STATE
+{
+    RTOS_READY = 0,
+    RTOS_BLOCKED = 1,
+    RTOS_DORMANT = 2
+} RTOS_TASK_STATE;
+
+typedef struct RTOS_Task
+{
+    uint32_t *sp;                    // must stay first: PendSV loads/stores through it
+    struct RTOS_Task *next;          // ready list or wait list link
+    struct RTOS_Task *delay_next;    // delayed list link, sorted by wake_tick
+    struct RTOS_Task **wait_list;    // list the task is blocked on, 0 if none
+    uint32_t wake_tick;
+    uint8_t priority;
+    uint8_t state;
+    uint8_t delayed;
+    uint8_t wait_result;
+} RTOS_Task_t;
+
+typedef void (*RTOS_Task_Entry_t)(void *Arg);
+
+typedef struct RTOS_Sem
+{
+    volatile uint32_t count;
+    RTOS_Task_t *waiters;
+} RTOS_Sem_t;
+
+typedef struct RTOS_Queue
+{
+    uint8_t *buffer;
+    uint16_t item_size;
+    uint16_t capacity;
+    uint16_t head;
+    uint16_t count;
+    RTOS_Task_t *senders;
+    RTOS_Task_t *receivers;
+} RTOS_Queue_t;
+
+#define RTOS_EVENT_ANY 0x00U
+#define RTOS_EVENT_ALL 0x01U
+#define RTOS_EVENT_CLEAR 0x02U
+
+typedef struct RTOS_Event
+{
+    volatile uint32_t flags;
+    RTOS_Task_t *waiters;
+} RTOS_Event_t;
+
+/*-------------------------------------------Kernel state--------------------------------------------------*/
+
+// Referenced by name from PendSV_Handler, so not static
+RTOS_Task_t *volatile RTOS_Current;
+RTOS_Task_t *volatile RTOS_Next;
+
+static RTOS_Task_t *RTOS_Ready_Head[RTOS_PRIORITIES];
+static RTOS_Task_t *RTOS_Ready_Tail[RTOS_PRIORITIES];
+static volatile uint32_t RTOS_Ready_Bitmap; // bit (31 - priority) set when that level has a ready task
+static RTOS_Task_t *RTOS_Delay_Head;
+static volatile uint32_t RTOS_Tick_Count;
+
+static RTOS_Task_t RTOS_Idle_Task;
+static uint32_t RTOS_Idle_Stack[RTOS_IDLE_STACK_WORDS] __attribute__((aligned(8)));
+
+#define RTOS_PRIO_BIT(p) (0x80000000UL >> (p))
+#define RTOS_TIME_REACHED(now, t) ((int32_t)((now) - (t)) >= 0)
+
+/*-------------------------------------------Critical section----------------------------------------------*/
+
+uint32_t RTOS_Lock(void)
+{
+    return NVIC_Enter_Critical(RTOS_MAX_SYSCALL_PREEMPT);
+}
+
+void RTOS_Unlock(uint32_t State)
+{
+    NVIC_Exit_Critical(State);
+}
+
+/*-------------------------------------------Ready list (O(1) select)-------------------------------------*/
+
+void RTOS_Ready_Insert(RTOS_Task_t *Task)
+{
+    uint8_t p = Task->priority;
+
+    Task->next = 0;
+    Task->state = RTOS_READY;
+
+    if (RTOS_Ready_Tail[p])
+    {
+        RTOS_Ready_Tail[p]->next = Task;
+    }
+    else
+    {
+        RTOS_Ready_Head[p] = Task;
+    }
+
+    RTOS_Ready_Tail[p] = Task;
+    RTOS_Ready_Bitmap |= RTOS_PRIO_BIT(p);
+}
+
+void RTOS_Ready_Remove(RTOS_Task_t *Task)
+{
+    uint8_t p = Task->priority;
+    RTOS_Task_t **link = &RTOS_Ready_Head[p];
+    RTOS_Task_t *prev = 0;
+
+    while (*link && (*link != Task))
+    {
+        prev = *link;
+        link = &(*link)->next;
+    }
+
+    if (*link == 0)
+    {
+        return;
+    }
+
+    *link = Task->next;
+
+    if (RTOS_Ready_Tail[p] == Task)
+    {
+        RTOS_Ready_Tail[p] = prev;
+    }
+
+    if (RTOS_Ready_Head[p] == 0)
+    {
+        RTOS_Ready_Bitmap &= ~RTOS_PRIO_BIT(p);
+    }
+
+    Task->next = 0;
+}
+
+// Most urgent ready level = leading zeros of the bitmap: one CLZ, whatever the number of tasks
+void RTOS_Schedule(void)
+{
+    RTOS_Task_t *next = RTOS_Ready_Head[__builtin_clz(RTOS_Ready_Bitmap)];
+
+    RTOS_Next = next; // always refreshed so a stale pending switch cannot pick an old task
+
+    if (next != RTOS_Current)
+    {
+        SCB_ICSR = SCB_ICSR_PENDSVSET;
+    }
+}
+
+/*-------------------------------------------Delayed list / wait lists-------------------------------------*/
+
+void RTOS_Delay_Insert(RTOS_Task_t *Task, uint32_t Ticks)
+{
+    RTOS_Task_t **link = &RTOS_Delay_Head;
+
+    Task->wake_tick = RTOS_Tick_Count + Ticks;
+    Task->delayed = 1;
+
+    while (*link && RTOS_TIME_REACHED(Task->wake_tick, (*link)->wake_tick))
+    {
+        link = &(*link)->delay_next;
+    }
+
+    Task->delay_next = *link;
+    *link = Task;
+}
+
+void RTOS_Delay_Remove(RTOS_Task_t *Task)
+{
+    RTOS_Task_t **link = &RTOS_Delay_Head;
+
+    while (*link && (*link != Task))
+    {
+        link = &(*link)->delay_next;
+    }
+
+    if (*link)
+    {
+        *link = Task->delay_next;
+    }
+
+    Task->delay_next = 0;
+    Task->delayed = 0;
+}
+
+// Wait lists are kept in priority order so the most urgent waiter is always the head
+void RTOS_Wait_Insert(RTOS_Task_t **List, RTOS_Task_t *Task)
+{
+    while (*List && ((*List)->priority <= Task->priority))
+    {
+        List = &(*List)->next;
+    }
+
+    Task->next = *List;
+    *List = Task;
+}
+
+void RTOS_Wait_Remove(RTOS_Task_t **List, RTOS_Task_t *Task)
+{
+    while (*List && (*List != Task))
+    {
+        List = &(*List)->next;
+    }
+
+    if (*List)
+    {
+        *List = Task->next;
+    }
+
+    Task->next = 0;
+}
+
+void RTOS_Wake(RTOS_Task_t *Task, uint8_t Result)
+{
+    if (Task->wait_list)
+    {
+        RTOS_Wait_Remove(Task->wait_list, Task);
+        Task->wait_list = 0;
+    }
+
+    if (Task->delayed)
+    {
+        RTOS_Delay_Remove(Task);
+    }
+
+    Task->wait_result = Result;
+    RTOS_Ready_Insert(Task);
+}
+
+// Called with the kernel locked. The switch happens when the caller unlocks.
+void RTOS_Block_Current(RTOS_Task_t **Wait_List, uint32_t Timeout)
+{
+    RTOS_Task_t *task = RTOS_Current;
+
+    RTOS_Ready_Remove(task);
+    task->state = RTOS_BLOCKED;
+    task->wait_result = RTOS_TIMEOUT;
+    task->wait_list = Wait_List;
+
+    if (Wait_List)
+    {
+        RTOS_Wait_Insert(Wait_List, task);
+    }
+
+    if (Timeout != RTOS_WAIT_FOREVER)
+    {
+        RTOS_Delay_Insert(task, Timeout);
+    }
+
+    RTOS_Schedule();
+}
+
+void RTOS_Process_Delays(void)
+{
+    while (RTOS_Delay_Head && RTOS_TIME_REACHED(RTOS_Tick_Count, RTOS_Delay_Head->wake_tick))
+    {
+        RTOS_Wake(RTOS_Delay_Head, RTOS_TIMEOUT);
+    }
+}
+
+// Remaining ticks of a deadline-based wait, 0 once expired
+uint32_t RTOS_Remaining(uint32_t Timeout, uint32_t Deadline)
+{
+    if (Timeout == RTOS_WAIT_FOREVER)
+    {
+        return RTOS_WAIT_FOREVER;
+    }
+
+    if (RTOS_TIME_REACHED(RTOS_Tick_Count, Deadline))
+    {
+        return 0;
+    }
+
+    return Deadline - RTOS_Tick_Count;
+}
+
+/*-------------------------------------------Tasks---------------------------------------------------------*/
+
+void RTOS_Task_Exit(void)
+{
+    uint32_t state = RTOS_Lock();
+
+    RTOS_Ready_Remove(RTOS_Current);
+    RTOS_Current->state = RTOS_DORMANT;
+    RTOS_Schedule();
+    RTOS_Unlock(state);
+
+    while (1)
+    {
+    }
+}
+
+// Stack layout expected by PendSV_Handler (low address first):
+// r4-r11, EXC_RETURN | r0-r3, r12, lr, pc, xPSR (hardware frame)
+// Returns 0 (task not created) for Priority >= RTOS_IDLE_PRIORITY: the idle level is reserved, so
+// the tickless check sees only the idle task there, and higher values would overrun RTOS_Ready_Head[].
+uint8_t RTOS_Task_Create(RTOS_Task_t *Task, RTOS_Task_Entry_t Entry, void *Arg,
+                         uint32_t *Stack, uint32_t Stack_Words, uint8_t Priority)
+{
+    uint32_t *sp = (uint32_t *)((uintptr_t)(Stack + Stack_Words) & ~(uintptr_t)7U);
+    uint32_t state;
+
+    if ((Priority >= RTOS_IDLE_PRIORITY) && (Task != &RTOS_Idle_Task))
+    {
+        return 0;
+    }
+
+    *(--sp) = 0x01000000UL;              // xPSR: Thumb bit
+    *(--sp) = (uint32_t)(uintptr_t)Entry; // pc
+    *(--sp) = (uint32_t)(uintptr_t)RTOS_Task_Exit; // lr: entry returning ends the task
+    *(--sp) = 0;                          // r12
+    *(--sp) = 0;                          // r3
+    *(--sp) = 0;                          // r2
+    *(--sp) = 0;                          // r1
+    *(--sp) = (uint32_t)(uintptr_t)Arg;   // r0
+    *(--sp) = 0xFFFFFFFDUL;               // EXC_RETURN: thread mode, PSP, no FP frame
+
+    for (uint8_t i = 0; i < 8U; i++)
+    {
+        *(--sp) = 0; // r11..r4
+    }
+
+    Task->sp = sp;
+    Task->priority = Priority;
+    Task->wait_list = 0;
+    Task->delay_next = 0;
+    Task->delayed = 0;
+
+    state = RTOS_Lock();
+    RTOS_Ready_Insert(Task);
+
+    if (RTOS_Current)
+    {
+        RTOS_Schedule();
+    }
+
+    RTOS_Unlock(state);
+
+    return 1;
+}
+
+void RTOS_Yield(void)
+{
+    uint32_t state = RTOS_Lock();
+    RTOS_Task_t *task = RTOS_Current;
+
+    // Go behind the other tasks of the same level
+    RTOS_Ready_Remove(task);
+    RTOS_Ready_Insert(task);
+    RTOS_Schedule();
+    RTOS_Unlock(state);
+}
+
+void RTOS_Delay(uint32_t Ticks)
+{
+    uint32_t state;
+
+    if (Ticks == 0)
+    {
+        RTOS_Yield();
+        return;
+    }
+
+    state = RTOS_Lock();
+    RTOS_Block_Current(0, Ticks);
+    RTOS_Unlock(state);
+}
+
+// Fixed-rate loop: wakes at *Last_Wake + Period regardless of how long the loop body took
+void RTOS_Delay_Until(uint32_t *Last_Wake, uint32_t Period)
+{
+    uint32_t state = RTOS_Lock();
+    uint32_t wake = *Last_Wake + Period;
+
+    *Last_Wake = wake;
+
+    if (!RTOS_TIME_REACHED(RTOS_Tick_Count, wake))
+    {
+        RTOS_Block_Current(0, wake - RTOS_Tick_Count);
+    }
+
+    RTOS_Unlock(state);
+}
+
+uint32_t RTOS_Get_Ticks(void)
+{
+    return RTOS_Tick_Count;
+}
+
+/*-------------------------------------------Semaphore-----------------------------------------------------*/
+
+void RTOS_Sem_Init(RTOS_Sem_t *Sem, uint32_t Initial)
+{
+    Sem->count = Initial;
+    Sem->waiters = 0;
+}
+
+uint8_t RTOS_Sem_Take(RTOS_Sem_t *Sem, uint32_t Timeout)
+{
+    uint32_t state = RTOS_Lock();
+    uint32_t deadline = RTOS_Tick_Count + Timeout;
+
+    while (Sem->count == 0)
+    {
+        uint32_t remaining = RTOS_Remaining(Timeout, deadline);
+
+        if (remaining == 0)
+        {
+            RTOS_Unlock(state);
+            return RTOS_TIMEOUT;
+        }
+
+        RTOS_Block_Current(&Sem->waiters, remaining);
+        RTOS_Unlock(state); // switch out here
+        state = RTOS_Lock();
+    }
+
+    Sem->count--;
+    RTOS_Unlock(state);
+    return RTOS_OK;
+}
+
+// Safe from task and from IRQs at RTOS_MAX_SYSCALL_PREEMPT or less urgent
+void RTOS_Sem_Give(RTOS_Sem_t *Sem)
+{
+    uint32_t state = RTOS_Lock();
+
+    Sem->count++;
+
+    if (Sem->waiters)
+    {
+        RTOS_Wake(Sem->waiters, RTOS_OK);
+        RTOS_Schedule();
+    }
+
+    RTOS_Unlock(state);
+}
+
+/*-------------------------------------------Queue---------------------------------------------------------*/
+
+void RTOS_Queue_Init(RTOS_Queue_t *Queue, void *Buffer, uint16_t Item_Size, uint16_t Capacity)
+{
+    Queue->buffer = (uint8_t *)Buffer;
+    Queue->item_size = Item_Size;
+    Queue->capacity = Capacity;
+    Queue->head = 0;
+    Queue->count = 0;
+    Queue->senders = 0;
+    Queue->receivers = 0;
+}
+
+void RTOS_Copy(uint8_t *Dst, const uint8_t *Src, uint16_t Size)
+{
+    while (Size--)
+    {
+        *Dst++ = *Src++;
+    }
+}
+
+// Timeout RTOS_NO_WAIT from IRQs
+uint8_t RTOS_Queue_Send(RTOS_Queue_t *Queue, const void *Item, uint32_t Timeout)
+{
+    uint32_t state = RTOS_Lock();
+    uint32_t deadline = RTOS_Tick_Count + Timeout;
+    uint16_t tail;
+
+    while (Queue->count == Queue->capacity)
+    {
+        uint32_t remaining = RTOS_Remaining(Timeout, deadline);
+
+        if (remaining == 0)
+        {
+            RTOS_Unlock(state);
+            return RTOS_TIMEOUT;
+        }
+
+        RTOS_Block_Current(&Queue->senders, remaining);
+        RTOS_Unlock(state);
+        state = RTOS_Lock();
+    }
+
+    tail = (uint16_t)((Queue->head + Queue->count) % Queue->capacity);
+    RTOS_Copy(&Queue->buffer[tail * Queue->item_size], (const uint8_t *)Item, Queue->item_size);
+    Queue->count++;
+
+    if (Queue->receivers)
+    {
+        RTOS_Wake(Queue->receivers, RTOS_OK);
+        RTOS_Schedule();
+    }
+
+    RTOS_Unlock(state);
+    return RTOS_OK;
+}
+
+uint8_t RTOS_Queue_Receive(RTOS_Queue_t *Queue, void *Item, uint32_t Timeout)
+{
+    uint32_t state = RTOS_Lock();
+    uint32_t deadline = RTOS_Tick_Count + Timeout;
+
+    while (Queue->count == 0)
+    {
+        uint32_t remaining = RTOS_Remaining(Timeout, deadline);
+
+        if (remaining == 0)
+        {
+            RTOS_Unlock(state);
+            return RTOS_TIMEOUT;
+        }
+
+        RTOS_Block_Current(&Queue->receivers, remaining);
+        RTOS_Unlock(state);
+        state = RTOS_Lock();
+    }
+
+    RTOS_Copy((uint8_t *)Item, &Queue->buffer[Queue->head * Queue->item_size], Queue->item_size);
+    Queue->head = (uint16_t)((Queue->head + 1U) % Queue->capacity);
+    Queue->count--;
+
+    if (Queue->senders)
+    {
+        RTOS_Wake(Queue->senders, RTOS_OK);
+        RTOS_Schedule();
+    }
+
+    RTOS_Unlock(state);
+    return RTOS_OK;
+}
+
+/*-------------------------------------------Event flags---------------------------------------------------*/
+
+void RTOS_Event_Init(RTOS_Event_t *Event)
+{
+    Event->flags = 0;
+    Event->waiters = 0;
+}
+
+// Wakes every waiter; each one re-checks its own mask
+void RTOS_Event_Set(RTOS_Event_t *Event, uint32_t Mask)
+{
+    uint32_t state = RTOS_Lock();
+
+    Event->flags |= Mask;
+
+    if (Event->waiters)
+    {
+        while (Event->waiters)
+        {
+            RTOS_Wake(Event->waiters, RTOS_OK);
+        }
+
+        RTOS_Schedule();
+    }
+
+    RTOS_Unlock(state);
+}
+
+void RTOS_Event_Clear(RTOS_Event_t *Event, uint32_t Mask)
+{
+    uint32_t state = RTOS_Lock();
+    Event->flags &= ~Mask;
+    RTOS_Unlock(state);
+}
+
+// Returns the matched flags, 0 on timeout
+uint32_t RTOS_Event_Wait(RTOS_Event_t *Event, uint32_t Mask, uint8_t Options, uint32_t Timeout)
+{
+    uint32_t state = RTOS_Lock();
+    uint32_t deadline = RTOS_Tick_Count + Timeout;
+    uint32_t matched;
+
+    while (1)
+    {
+        uint32_t remaining;
+
+        matched = Event->flags & Mask;
+
+        if ((Options & RTOS_EVENT_ALL) ? (matched == Mask) : (matched != 0U))
+        {
+            break;
+        }
+
+        remaining = RTOS_Remaining(Timeout, deadline);
+
+        if (remaining == 0)
+        {
+            RTOS_Unlock(state);
+            return 0;
+        }
+
+        RTOS_Block_Current(&Event->waiters, remaining);
+        RTOS_Unlock(state);
+        state = RTOS_Lock();
+    }
+
+    if (Options & RTOS_EVENT_CLEAR)
+    {
+        Event->flags &= ~matched;
+    }
+
+    RTOS_Unlock(state);
+    return matched;
+}
+
+/*-------------------------------------------Tick and context switch----------------------------------------*/
+
+void SysTick_Handler(void)
+{
+    uint32_t state = RTOS_Lock();
+    RTOS_Task_t *task = RTOS_Current;
+
+    RTOS_Tick_Count++;
+    RTOS_Process_Delays();
+
+    // Round-robin between tasks that share the running task's level
+    if (task && (task->state == RTOS_READY) && (RTOS_Ready_Head[task->priority] == task) && task->next)
+    {
+        RTOS_Ready_Remove(task);
+        RTOS_Ready_Insert(task);
+    }
+
+    RTOS_Schedule();
+    RTOS_Unlock(state);
+}
+
+#if defined(__ARM_FP)
+// Only tasks that used the FPU (EXC_RETURN bit 4 = 0) pay for s16-s31; s0-s15 are stacked lazily by hardware
+#define RTOS_SAVE_FPU "tst lr, #0x10\n\t"    \
+                      "it eq\n\t"            \
+                      "vstmdbeq r0!, {s16-s31}\n\t"
+#define RTOS_RESTORE_FPU "tst lr, #0x10\n\t" \
+                         "it eq\n\t"         \
+                         "vldmiaeq r0!, {s16-s31}\n\t"
+#else
+#define RTOS_SAVE_FPU ""
+#define RTOS_RESTORE_FPU ""
+#endif
+
+// Lowest priority exception: runs only after every other handler has finished (tail-chained)
+__attribute__((naked)) void PendSV_Handler(void)
+{
+    __asm volatile(
+        "mrs r0, psp\n\t"
+        "isb\n\t"
+        "movw r3, #:lower16:RTOS_Current\n\t"
+        "movt r3, #:upper16:RTOS_Current\n\t"
+        "ldr r2, [r3]\n\t"
+        "cbz r2, 1f\n\t" // first switch from RTOS_Start: nothing to save
+        RTOS_SAVE_FPU
+        "stmdb r0!, {r4-r11, lr}\n\t"
+        "str r0, [r2]\n\t"
+        "1:\n\t"
+        "movw r1, #:lower16:RTOS_Next\n\t"
+        "movt r1, #:upper16:RTOS_Next\n\t"
+        "ldr r2, [r1]\n\t"
+        "str r2, [r3]\n\t"
+        "ldr r0, [r2]\n\t"
+        "ldmia r0!, {r4-r11, lr}\n\t"
+        RTOS_RESTORE_FPU
+        "msr psp, r0\n\t"
+        "isb\n\t"
+        "bx lr\n\t");
+}
+
+/*-------------------------------------------Tickless idle--------------------------------------------------*/
+
+// Stops the periodic tick while nothing but idle is ready and sleeps until the next wake-up.
+// Any other IRQ ends the sleep early; the tick count is then corrected from the SysTick counter.
+void RTOS_Tickless_Idle(void)
+{
+    uint32_t idle_ticks;
+    uint32_t reload;
+    uint32_t remaining;
+    uint32_t step;
+    uint32_t next;
+
+    __asm volatile("cpsid i" ::: "memory"); // WFI still wakes on a pending IRQ with PRIMASK set
+
+    if (RTOS_Ready_Bitmap != RTOS_PRIO_BIT(RTOS_IDLE_PRIORITY))
+    {
+        __asm volatile("cpsie i" ::: "memory");
+        return;
+    }
+
+    if (RTOS_Delay_Head == 0)
+    {
+        idle_ticks = RTOS_MAX_IDLE_TICKS;
+    }
+    else if (RTOS_TIME_REACHED(RTOS_Tick_Count, RTOS_Delay_Head->wake_tick))
+    {
+        idle_ticks = 0;
+    }
+    else
+    {
+        idle_ticks = RTOS_Delay_Head->wake_tick - RTOS_Tick_Count;
+    }
+
+    if (idle_ticks > RTOS_MAX_IDLE_TICKS)
+    {
+        idle_ticks = RTOS_MAX_IDLE_TICKS;
+    }
+
+    SYST_CSR &= ~SYST_CSR_ENABLE;
+
+    if ((idle_ticks < 2U) || (SCB_ICSR & SCB_ICSR_PENDSTSET))
+    {
+        SYST_CSR |= SYST_CSR_ENABLE;
+        __asm volatile("dsb\n\twfi\n\tisb\n\tcpsie i" ::: "memory");
+        return;
+    }
+
+    // Finish the current tick, then (idle_ticks - 1) whole ticks in one SysTick period
+    reload = SYST_CVR + ((idle_ticks - 1U) * RTOS_CYCLES_PER_TICK);
+    SYST_RVR = reload;
+    SYST_CVR = 0;
+    SYST_CSR |= SYST_CSR_ENABLE;
+
+    __asm volatile("dsb\n\twfi\n\tisb" ::: "memory");
+
+    SYST_CSR &= ~SYST_CSR_ENABLE;
+    remaining = SYST_CVR;
+
+    if (SCB_ICSR & SCB_ICSR_PENDSTSET)
+    {
+        // Whole period elapsed; the pending SysTick_Handler adds the last tick
+        uint32_t since_wrap = reload - remaining;
+
+        step = (idle_ticks - 1U) + (since_wrap / RTOS_CYCLES_PER_TICK);
+        next = RTOS_CYCLES_PER_TICK - (since_wrap % RTOS_CYCLES_PER_TICK);
+    }
+    else
+    {
+        // Woken early: tick boundaries lie at remaining = k * RTOS_CYCLES_PER_TICK
+        step = (idle_ticks - 1U) - (remaining / RTOS_CYCLES_PER_TICK);
+        next = remaining % RTOS_CYCLES_PER_TICK;
+
+        if (next == 0U)
+        {
+            next = RTOS_CYCLES_PER_TICK;
+        }
+    }
+
+    if (next < 2U)
+    {
+        next = 2U;
+    }
+
+    // Restart aligned to the next tick boundary, then fall back to the periodic reload
+    SYST_RVR = next - 1U;
+    SYST_CVR = 0;
+    SYST_CSR |= SYST_CSR_ENABLE;
+    SYST_RVR = RTOS_CYCLES_PER_TICK - 1U;
+
+    RTOS_Tick_Count += step;
+    RTOS_Process_Delays();
+    RTOS_Schedule();
+
+    __asm volatile("cpsie i" ::: "memory");
+}
+
+void RTOS_Idle(void *Arg)
+{
+    (void)Arg;
+
+    while (1)
+    {
+        RTOS_Tickless_Idle();
+    }
+}
+
+/*-------------------------------------------Start---------------------------------------------------------*/
+
+void RTOS_Init(void)
+{
+    NVIC_Init(); // grouping 3_1, SysTick / PendSV at NVIC_PREEMPT_KERNEL
+
+#if defined(__ARM_FP)
+    SCB_CPACR |= (0xFUL << 20);                      // CP10/CP11 full access
+    FPU_FPCCR |= FPU_FPCCR_ASPEN | FPU_FPCCR_LSPEN; // lazy stacking (reset default, made explicit)
+    __asm volatile("dsb\n\tisb" ::: "memory");
+#endif
+
+    RTOS_Task_Create(&RTOS_Idle_Task, RTOS_Idle, 0, RTOS_Idle_Stack, RTOS_IDLE_STACK_WORDS, RTOS_IDLE_PRIORITY);
+}
+
+// Same SysTick setup as the delay_ms() examples, with TICKINT added. Never returns.
+void RTOS_Start(void)
+{
+    uint32_t state = RTOS_Lock();
+
+    SYST_RVR = RTOS_CYCLES_PER_TICK - 1U;
+    SYST_CVR = 0;
+    SYST_CSR = SYST_CSR_ENABLE | SYST_CSR_TICKINT | SYST_CSR_CLKSOURCE;
+
+    RTOS_Current = 0;
+    RTOS_Schedule();
+    RTOS_Unlock(state);
+
+    while (1)
+    {
+    }
+}
+
+#endif
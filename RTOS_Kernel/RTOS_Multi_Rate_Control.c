@@ -0,0 +1,156 @@
+// Three control loops at 1 ms / 10 ms / 500 ms plus a button task on one STM32F411 using the RTOS kernel
+
+#include <stdint.h>
+#include "RTOS_Kernel.h"
+#include "../Device_Driver_Devlopment/EXTI_Driver_STM32F4xx.h"
+
+// GPIOA ------------------------------------------------------------------------------
+
+#define GPIOA_BASE 0x40020000UL
+#define GPIOA_MODER (*(volatile uint32_t *)(GPIOA_BASE + 0x00))
+#define GPIOA_ODR (*(volatile uint32_t *)(GPIOA_BASE + 0x14))
+#define GPIOA_BSRR (*(volatile uint32_t *)(GPIOA_BASE + 0x18))
+
+#define GPIO_BSRR_RESET 16U
+
+#define OUT_PA0 0    // 1 ms loop heartbeat (scope)
+#define OUT_PA1 1    // 10 ms loop heartbeat (scope)
+#define LED_PA3 3    // 500 ms status LED
+#define LED_PA4 4    // toggled by button task
+#define BUTTON_PA2 2
+
+#define STACK_WORDS 256U
+
+// Tasks ------------------------------------------------------------------------------
+
+RTOS_Task_t Fast_Loop_Task;
+RTOS_Task_t Slow_Loop_Task;
+RTOS_Task_t Status_Task;
+RTOS_Task_t Button_Task;
+
+uint32_t Fast_Loop_Stack[STACK_WORDS] __attribute__((aligned(8)));
+uint32_t Slow_Loop_Stack[STACK_WORDS] __attribute__((aligned(8)));
+uint32_t Status_Stack[STACK_WORDS] __attribute__((aligned(8)));
+uint32_t Button_Stack[STACK_WORDS] __attribute__((aligned(8)));
+
+RTOS_Sem_t Button_Sem;
+RTOS_Queue_t Setpoint_Queue;
+uint32_t Setpoint_Buffer[4];
+RTOS_Event_t Status_Events;
+
+#define EVENT_SETPOINT_CHANGED (1U << 0)
+
+void GPIO_Pin_Toggle(uint8_t Pin)
+{
+    if (GPIOA_ODR & (1 << Pin))
+    {
+        GPIOA_BSRR = 1 << (Pin + GPIO_BSRR_RESET);
+    }
+    else
+    {
+        GPIOA_BSRR = 1 << Pin;
+    }
+}
+
+// 1 ms loop, most urgent task
+void Fast_Loop(void *Arg)
+{
+    (void)Arg;
+    uint32_t last_wake = RTOS_Get_Ticks();
+    uint32_t setpoint = 0;
+    float filtered = 0.0f; // FPU use: context saved through lazy stacking
+
+    while (1)
+    {
+        RTOS_Queue_Receive(&Setpoint_Queue, &setpoint, RTOS_NO_WAIT);
+        filtered += 0.1f * ((float)setpoint - filtered);
+
+        GPIO_Pin_Toggle(OUT_PA0);
+        RTOS_Delay_Until(&last_wake, 1);
+    }
+}
+
+// 10 ms loop, publishes a new setpoint every second
+void Slow_Loop(void *Arg)
+{
+    (void)Arg;
+    uint32_t last_wake = RTOS_Get_Ticks();
+    uint32_t cycles = 0;
+    uint32_t setpoint = 0;
+
+    while (1)
+    {
+        GPIO_Pin_Toggle(OUT_PA1);
+
+        if (++cycles == 100U)
+        {
+            cycles = 0;
+            setpoint = (setpoint + 100U) % 1000U;
+            RTOS_Queue_Send(&Setpoint_Queue, &setpoint, RTOS_NO_WAIT);
+            RTOS_Event_Set(&Status_Events, EVENT_SETPOINT_CHANGED);
+        }
+
+        RTOS_Delay_Until(&last_wake, 10);
+    }
+}
+
+// 500 ms status LED, blinks twice as fast right after a setpoint change
+void Status(void *Arg)
+{
+    (void)Arg;
+
+    while (1)
+    {
+        uint32_t events = RTOS_Event_Wait(&Status_Events, EVENT_SETPOINT_CHANGED, RTOS_EVENT_ANY | RTOS_EVENT_CLEAR, 500);
+
+        GPIO_Pin_Toggle(LED_PA3);
+
+        if (events)
+        {
+            RTOS_Delay(250);
+            GPIO_Pin_Toggle(LED_PA3);
+        }
+    }
+}
+
+void Button_Handler(void *Arg)
+{
+    (void)Arg;
+
+    while (1)
+    {
+        RTOS_Sem_Take(&Button_Sem, RTOS_WAIT_FOREVER);
+        GPIO_Pin_Toggle(LED_PA4);
+    }
+}
+
+// EXTI callback runs at NVIC_PREEMPT_EXTI, which is allowed to call the kernel
+void Button_Pressed(uint8_t Line)
+{
+    (void)Line;
+    RTOS_Sem_Give(&Button_Sem);
+}
+
+int main(void)
+{
+    RCC_Clock_Ensure(RCC_CLK_GPIOA);
+
+    GPIOA_MODER &= ~((3 << (2 * OUT_PA0)) | (3 << (2 * OUT_PA1)) | (3 << (2 * BUTTON_PA2)) |
+                     (3 << (2 * LED_PA3)) | (3 << (2 * LED_PA4)));
+    GPIOA_MODER |= (1 << (2 * OUT_PA0)) | (1 << (2 * OUT_PA1)) | (1 << (2 * LED_PA3)) | (1 << (2 * LED_PA4));
+
+    RTOS_Init();
+
+    RTOS_Sem_Init(&Button_Sem, 0);
+    RTOS_Queue_Init(&Setpoint_Queue, Setpoint_Buffer, sizeof(uint32_t), 4);
+    RTOS_Event_Init(&Status_Events);
+
+    RTOS_Task_Create(&Fast_Loop_Task, Fast_Loop, 0, Fast_Loop_Stack, STACK_WORDS, 1);
+    RTOS_Task_Create(&Slow_Loop_Task, Slow_Loop, 0, Slow_Loop_Stack, STACK_WORDS, 2);
+    RTOS_Task_Create(&Button_Task, Button_Handler, 0, Button_Stack, STACK_WORDS, 3);
+    RTOS_Task_Create(&Status_Task, Status, 0, Status_Stack, STACK_WORDS, 4);
+
+    EXTI_Init(EXTI_PORT_A, BUTTON_PA2, EXTI_EDGE_RISING, Button_Pressed);
+
+    RTOS_Start();
+}
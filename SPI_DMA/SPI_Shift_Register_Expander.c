@@ -0,0 +1,50 @@
+// 64 LED outputs through eight daisy-chained 74HC595 on SPI2 with DMA (STM32F411x / STM32F446xx)
+// The 4-bit counter of Four_BIt_Counter/ needed one GPIO per LED; here three pins drive the whole chain.
+// PB13 = SCK -> SRCLK, PB15 = MOSI -> SER of the first 595, PB12 = latch -> RCLK of all 595s (QH' -> SER of the next)
+// Outputs 0..31: 32-bit binary counter, outputs 32..63: running light.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/SPI_DMA_Driver_STM32F4xx.h"
+
+#define GPIO_PORT_B 1U
+#define LATCH_PB12 12U
+
+#define OUTPUTS 64U
+#define SPI_CLOCK_MAX 8000000UL // 16 MHz APB1 / 2: 64 bits in 8 us, roughly 90k refreshes per second
+
+#define REFRESHES_PER_STEP 9000U // about 10 display steps per second
+
+uint8_t Frame[EXPANDER_BYTES(OUTPUTS)];
+Expander_t Leds;
+
+int main(void)
+{
+    uint32_t counter = 0;
+    uint8_t runner = 0;
+    uint32_t next_step = REFRESHES_PER_STEP;
+
+    NVIC_Init();
+
+    SPI_Init(SPI_2, SPI_CLOCK_MAX, SPI_MODE_0, 0);
+    Expander_Init(&Leds, SPI_2, Frame, OUTPUTS, GPIO_PORT_B, LATCH_PB12);
+    Expander_Auto_Refresh(&Leds, 1); // from here on the DMA interrupt rewrites the chain continuously
+
+    while (1)
+    {
+        // Only the framebuffer is touched here; no SPI, no latch handling in the application
+        if ((int32_t)(Leds.refreshes - next_step) >= 0)
+        {
+            next_step += REFRESHES_PER_STEP;
+            counter++;
+
+            for (uint16_t bit = 0; bit < 32U; bit++)
+            {
+                Expander_Set(&Leds, bit, (uint8_t)((counter >> bit) & 1U));
+            }
+
+            Expander_Set(&Leds, (uint16_t)(32U + runner), 0);
+            runner = (uint8_t)((runner + 1U) & 31U);
+            Expander_Set(&Leds, (uint16_t)(32U + runner), 1);
+        }
+    }
+}
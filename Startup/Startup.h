@@ -0,0 +1,36 @@
+// Startup interface for STM32F411CE / STM32F446RE (startup_stm32f411ce.c / startup_stm32f446re.c + linker scripts)
+// Include from application code for RAMFUNC placement and the boot report.
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <stdint.h>
+
+// Function placed in SRAM: copied together with .data before main(), fetched with zero wait states and no
+// cache misses. long_call because SRAM (0x2000 0000) is out of BL range from flash (0x0800 0000).
+#define RAMFUNC __attribute__((section(".ramfunc"), noinline, long_call))
+
+typedef void (*Handler_t)(void);
+
+// Filled by Reset_Handler just before main(); cycles counted with DWT CYCCNT from Reset_Handler entry
+typedef struct Boot_Report_t
+{
+    uint32_t data_bytes;     // .ramfunc + .data copied from flash
+    uint32_t bss_bytes;      // zeroed
+    uint32_t cycles_data;
+    uint32_t cycles_bss;
+    uint32_t cycles_init;    // .preinit_array / .init_array constructors
+    uint32_t cycles_to_main; // total, Reset_Handler entry -> main()
+} Boot_Report_t;
+
+extern Boot_Report_t Boot_Report;
+
+// Exception number of the last unexpected interrupt (16 + IRQn for peripherals), 0 if none
+extern volatile uint32_t Default_Handler_IPSR;
+
+// Copies the vector table to SRAM and points VTOR at it: exception entry no longer fetches the handler
+// address from flash, and handlers can be replaced at run time through Startup_Set_Handler().
+void Startup_Relocate_Vectors(void);
+void Startup_Set_Handler(uint8_t IRQn, Handler_t Handler);
+
+#endif
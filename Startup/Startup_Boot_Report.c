@@ -0,0 +1,74 @@
+// In-tree startup demo (STM32F446RE; STM32F411CE: link startup_stm32f411ce.c + STM32F411CE.ld instead)
+// Boot_Report holds the cycles Reset_Handler spent copying .data, zeroing .bss and running constructors.
+// The TIM2 interrupt handler and the vector table both live in SRAM, so the LED PA5 blink (2 Hz) is
+// serviced without a single flash access. Latency of each entry (CNT at ISR start) lands in Isr_Latency.
+
+#include <stdint.h>
+#include "Startup.h"
+
+#define RCC_AHB1ENR (*(volatile uint32_t *)(0x40023800UL + 0x30))
+#define RCC_APB1ENR (*(volatile uint32_t *)(0x40023800UL + 0x40))
+
+#define GPIOA_MODER (*(volatile uint32_t *)(0x40020000UL + 0x00))
+#define GPIOA_ODR (*(volatile uint32_t *)(0x40020000UL + 0x14))
+
+#define TIM2_BASE 0x40000000UL
+#define TIM2_CR1 (*(volatile uint32_t *)(TIM2_BASE + 0x00))
+#define TIM2_DIER (*(volatile uint32_t *)(TIM2_BASE + 0x0C))
+#define TIM2_SR (*(volatile uint32_t *)(TIM2_BASE + 0x10))
+#define TIM2_CNT (*(volatile uint32_t *)(TIM2_BASE + 0x24))
+#define TIM2_PSC (*(volatile uint32_t *)(TIM2_BASE + 0x28))
+#define TIM2_ARR (*(volatile uint32_t *)(TIM2_BASE + 0x2C))
+
+#define NVIC_ISER0 (*(volatile uint32_t *)(0xE000E100UL))
+
+#define TIM2_IRQn 28U
+#define LED_PA5 5U
+
+// Some initialised data and some zeroed data, so the report has something to show
+uint32_t Lookup[64] = {1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 377, 610, 987, 1597};
+uint32_t Scratch[1024];
+
+volatile uint32_t Isr_Latency;
+volatile uint32_t Isr_Count;
+Boot_Report_t Boot_Copy;
+
+/*-------------------------------------------ISR in SRAM-------------------------------------------------*/
+
+// Installed through the SRAM vector table; the name does not have to match the weak TIM2_IRQHandler
+RAMFUNC void Blink_Handler(void)
+{
+    Isr_Latency = TIM2_CNT; // timer ticks at 16 MHz: cycles since the update event
+    TIM2_SR = 0;
+    GPIOA_ODR ^= (1U << LED_PA5);
+    Isr_Count++;
+}
+
+/*-------------------------------------------Main--------------------------------------------------------*/
+
+int main(void)
+{
+    Boot_Copy = Boot_Report; // e.g. data_bytes = 256 + ramfunc, bss_bytes >= 4096
+
+    Startup_Relocate_Vectors();
+    Startup_Set_Handler(TIM2_IRQn, Blink_Handler);
+
+    RCC_AHB1ENR |= (1U << 0);
+    GPIOA_MODER &= ~(3U << (LED_PA5 * 2U));
+    GPIOA_MODER |= (1U << (LED_PA5 * 2U));
+
+    // 16 MHz, no prescaler: 4 000 000 ticks = 250 ms per toggle
+    RCC_APB1ENR |= (1U << 0);
+    TIM2_PSC = 0;
+    TIM2_ARR = 4000000UL - 1U;
+    TIM2_SR = 0;
+    TIM2_DIER = (1U << 0);
+    NVIC_ISER0 = (1U << TIM2_IRQn);
+    TIM2_CR1 = (1U << 0);
+
+    while (1)
+    {
+        __asm volatile("wfi");
+        Scratch[Isr_Count & 1023U] = Lookup[Isr_Count & 63U]; // keeps both arrays past --gc-sections
+    }
+}
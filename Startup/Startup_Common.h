@@ -0,0 +1,211 @@
+// Reset handler, data / bss initialisation, default handler and vector table layout shared by the
+// device startup files. Included once, by startup_stm32f411ce.c or startup_stm32f446re.c only,
+// after VECTOR_IRQ_COUNT is defined.
+
+#ifndef STARTUP_COMMON_H
+#define STARTUP_COMMON_H
+
+#include <stdint.h>
+#include "Startup.h"
+
+#define SCB_VTOR (*(volatile uint32_t *)(0xE000ED08UL))
+#define SCB_CPACR (*(volatile uint32_t *)(0xE000ED88UL))
+
+#define DEMCR (*(volatile uint32_t *)(0xE000EDFCUL))
+#define DWT_CTRL (*(volatile uint32_t *)(0xE0001000UL))
+#define DWT_CYCCNT (*(volatile uint32_t *)(0xE0001004UL))
+
+/*-------------------------------------------Linker script symbols--------------------------------------------*/
+
+extern uint32_t _estack;
+extern uint32_t _sidata; // load address of .data in flash
+extern uint32_t _sdata;
+extern uint32_t _edata;
+extern uint32_t _sbss;
+extern uint32_t _ebss;
+extern Handler_t __preinit_array_start[];
+extern Handler_t __preinit_array_end[];
+extern Handler_t __init_array_start[];
+extern Handler_t __init_array_end[];
+
+int main(void);
+
+/*-------------------------------------------Vector table layout----------------------------------------------*/
+
+typedef struct Vector_Table_t
+{
+    uint32_t *initial_sp;
+    Handler_t reset;
+    Handler_t nmi;
+    Handler_t hard_fault;
+    Handler_t mem_manage;
+    Handler_t bus_fault;
+    Handler_t usage_fault;
+    Handler_t reserved_7_10[4];
+    Handler_t svc;
+    Handler_t debug_monitor;
+    Handler_t reserved_13;
+    Handler_t pendsv;
+    Handler_t systick;
+    Handler_t irq[VECTOR_IRQ_COUNT]; // reserved positions stay 0
+} Vector_Table_t;
+
+_Static_assert(sizeof(Vector_Table_t) == (sizeof(Handler_t) * (16U + VECTOR_IRQ_COUNT)), "vector table layout");
+
+extern const Vector_Table_t Vector_Table;
+
+Boot_Report_t Boot_Report;
+volatile uint32_t Default_Handler_IPSR;
+
+// VTOR needs the table aligned to its size rounded up to a power of two (F411: 408 B, F446: 452 B -> 512)
+static Vector_Table_t Vector_Table_Ram __attribute__((aligned(512)));
+
+/*-------------------------------------------Handlers---------------------------------------------------------*/
+
+// Any exception without a handler ends here; the debugger shows which one in Default_Handler_IPSR
+void Default_Handler(void)
+{
+    uint32_t ipsr;
+
+    __asm volatile("mrs %0, ipsr" : "=r"(ipsr));
+    Default_Handler_IPSR = ipsr;
+
+    while (1)
+    {
+    }
+}
+
+#define WEAK_HANDLER(name) void name(void) __attribute__((weak, alias("Default_Handler")))
+
+WEAK_HANDLER(NMI_Handler);
+WEAK_HANDLER(HardFault_Handler);
+WEAK_HANDLER(MemManage_Handler);
+WEAK_HANDLER(BusFault_Handler);
+WEAK_HANDLER(UsageFault_Handler);
+WEAK_HANDLER(SVC_Handler);
+WEAK_HANDLER(DebugMon_Handler);
+WEAK_HANDLER(PendSV_Handler);
+WEAK_HANDLER(SysTick_Handler);
+
+/*-------------------------------------------Memory initialisation--------------------------------------------*/
+
+// Four words per iteration (LDM / STM of four registers), then the remaining words; the linker script keeps
+// both sections word aligned and word sized
+static inline __attribute__((always_inline)) void Startup_Copy(uint32_t *Dst, const uint32_t *Src, uint32_t *End)
+{
+    while ((End - Dst) >= 4)
+    {
+        uint32_t a = Src[0];
+        uint32_t b = Src[1];
+        uint32_t c = Src[2];
+        uint32_t d = Src[3];
+
+        Dst[0] = a;
+        Dst[1] = b;
+        Dst[2] = c;
+        Dst[3] = d;
+        Dst += 4;
+        Src += 4;
+    }
+
+    while (Dst < End)
+    {
+        *Dst++ = *Src++;
+    }
+}
+
+static inline __attribute__((always_inline)) void Startup_Zero(uint32_t *Dst, uint32_t *End)
+{
+    while ((End - Dst) >= 4)
+    {
+        Dst[0] = 0;
+        Dst[1] = 0;
+        Dst[2] = 0;
+        Dst[3] = 0;
+        Dst += 4;
+    }
+
+    while (Dst < End)
+    {
+        *Dst++ = 0;
+    }
+}
+
+/*-------------------------------------------Reset--------------------------------------------------------*/
+
+void Reset_Handler(void)
+{
+    uint32_t t_data;
+    uint32_t t_bss;
+    uint32_t t_init;
+
+    // Cycle counter first: everything below is measured
+    DEMCR |= (1UL << 24);
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= (1UL << 0);
+
+#if defined(__ARM_FP)
+    SCB_CPACR |= (0xFUL << 20); // CP10 / CP11 full access before any FPU instruction (hard-float builds)
+    __asm volatile("dsb\n isb" ::: "memory");
+#endif
+
+    SCB_VTOR = (uint32_t)(uintptr_t)&Vector_Table; // also correct when started by a bootloader
+
+    Startup_Copy(&_sdata, &_sidata, &_edata); // .ramfunc code and initialised variables
+    t_data = DWT_CYCCNT;
+
+    Startup_Zero(&_sbss, &_ebss);
+    t_bss = DWT_CYCCNT;
+
+    for (Handler_t *f = __preinit_array_start; f < __preinit_array_end; f++)
+    {
+        (*f)();
+    }
+
+    for (Handler_t *f = __init_array_start; f < __init_array_end; f++)
+    {
+        (*f)();
+    }
+
+    t_init = DWT_CYCCNT;
+
+    // .bss is zero now, so the report can be written
+    Boot_Report.data_bytes = (uint32_t)((uintptr_t)&_edata - (uintptr_t)&_sdata);
+    Boot_Report.bss_bytes = (uint32_t)((uintptr_t)&_ebss - (uintptr_t)&_sbss);
+    Boot_Report.cycles_data = t_data;
+    Boot_Report.cycles_bss = t_bss - t_data;
+    Boot_Report.cycles_init = t_init - t_bss;
+    Boot_Report.cycles_to_main = DWT_CYCCNT;
+
+    main();
+
+    while (1)
+    {
+    }
+}
+
+/*-------------------------------------------Vector table in SRAM---------------------------------------------*/
+
+void Startup_Relocate_Vectors(void)
+{
+    uint32_t primask;
+
+    Vector_Table_Ram = Vector_Table;
+
+    __asm volatile("mrs %0, primask\n cpsid i" : "=r"(primask)::"memory");
+    SCB_VTOR = (uint32_t)(uintptr_t)&Vector_Table_Ram;
+    __asm volatile("dsb\n isb" ::: "memory");
+    __asm volatile("msr primask, %0" ::"r"(primask) : "memory");
+}
+
+// Only after Startup_Relocate_Vectors(); the flash table is read-only
+void Startup_Set_Handler(uint8_t IRQn, Handler_t Handler)
+{
+    if (IRQn < VECTOR_IRQ_COUNT)
+    {
+        Vector_Table_Ram.irq[IRQn] = Handler;
+        __asm volatile("dsb" ::: "memory");
+    }
+}
+
+#endif
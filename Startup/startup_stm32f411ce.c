@@ -0,0 +1,145 @@
+// Startup code for STM32F411CE (Black Pill): typed vector table (86 IRQs, RM0383 table 37), weak handlers, reset handler
+// Link with STM32F411CE.ld; see Startup.md for the build line.
+
+#include <stdint.h>
+
+#define VECTOR_IRQ_COUNT 86U
+
+#include "Startup_Common.h"
+
+/*-------------------------------------------Peripheral handlers (weak)---------------------------------------*/
+
+WEAK_HANDLER(WWDG_IRQHandler);
+WEAK_HANDLER(PVD_IRQHandler);
+WEAK_HANDLER(TAMP_STAMP_IRQHandler);
+WEAK_HANDLER(RTC_WKUP_IRQHandler);
+WEAK_HANDLER(FLASH_IRQHandler);
+WEAK_HANDLER(RCC_IRQHandler);
+WEAK_HANDLER(EXTI0_IRQHandler);
+WEAK_HANDLER(EXTI1_IRQHandler);
+WEAK_HANDLER(EXTI2_IRQHandler);
+WEAK_HANDLER(EXTI3_IRQHandler);
+WEAK_HANDLER(EXTI4_IRQHandler);
+WEAK_HANDLER(DMA1_Stream0_IRQHandler);
+WEAK_HANDLER(DMA1_Stream1_IRQHandler);
+WEAK_HANDLER(DMA1_Stream2_IRQHandler);
+WEAK_HANDLER(DMA1_Stream3_IRQHandler);
+WEAK_HANDLER(DMA1_Stream4_IRQHandler);
+WEAK_HANDLER(DMA1_Stream5_IRQHandler);
+WEAK_HANDLER(DMA1_Stream6_IRQHandler);
+WEAK_HANDLER(ADC_IRQHandler);
+WEAK_HANDLER(EXTI9_5_IRQHandler);
+WEAK_HANDLER(TIM1_BRK_TIM9_IRQHandler);
+WEAK_HANDLER(TIM1_UP_TIM10_IRQHandler);
+WEAK_HANDLER(TIM1_TRG_COM_TIM11_IRQHandler);
+WEAK_HANDLER(TIM1_CC_IRQHandler);
+WEAK_HANDLER(TIM2_IRQHandler);
+WEAK_HANDLER(TIM3_IRQHandler);
+WEAK_HANDLER(TIM4_IRQHandler);
+WEAK_HANDLER(I2C1_EV_IRQHandler);
+WEAK_HANDLER(I2C1_ER_IRQHandler);
+WEAK_HANDLER(I2C2_EV_IRQHandler);
+WEAK_HANDLER(I2C2_ER_IRQHandler);
+WEAK_HANDLER(SPI1_IRQHandler);
+WEAK_HANDLER(SPI2_IRQHandler);
+WEAK_HANDLER(USART1_IRQHandler);
+WEAK_HANDLER(USART2_IRQHandler);
+WEAK_HANDLER(EXTI15_10_IRQHandler);
+WEAK_HANDLER(RTC_Alarm_IRQHandler);
+WEAK_HANDLER(OTG_FS_WKUP_IRQHandler);
+WEAK_HANDLER(DMA1_Stream7_IRQHandler);
+WEAK_HANDLER(SDIO_IRQHandler);
+WEAK_HANDLER(TIM5_IRQHandler);
+WEAK_HANDLER(SPI3_IRQHandler);
+WEAK_HANDLER(DMA2_Stream0_IRQHandler);
+WEAK_HANDLER(DMA2_Stream1_IRQHandler);
+WEAK_HANDLER(DMA2_Stream2_IRQHandler);
+WEAK_HANDLER(DMA2_Stream3_IRQHandler);
+WEAK_HANDLER(DMA2_Stream4_IRQHandler);
+WEAK_HANDLER(OTG_FS_IRQHandler);
+WEAK_HANDLER(DMA2_Stream5_IRQHandler);
+WEAK_HANDLER(DMA2_Stream6_IRQHandler);
+WEAK_HANDLER(DMA2_Stream7_IRQHandler);
+WEAK_HANDLER(USART6_IRQHandler);
+WEAK_HANDLER(I2C3_EV_IRQHandler);
+WEAK_HANDLER(I2C3_ER_IRQHandler);
+WEAK_HANDLER(FPU_IRQHandler);
+WEAK_HANDLER(SPI4_IRQHandler);
+WEAK_HANDLER(SPI5_IRQHandler);
+
+/*-------------------------------------------Vector table----------------------------------------------------*/
+
+__attribute__((section(".isr_vector"), used)) const Vector_Table_t Vector_Table =
+{
+    .initial_sp = &_estack,
+    .reset = Reset_Handler,
+    .nmi = NMI_Handler,
+    .hard_fault = HardFault_Handler,
+    .mem_manage = MemManage_Handler,
+    .bus_fault = BusFault_Handler,
+    .usage_fault = UsageFault_Handler,
+    .svc = SVC_Handler,
+    .debug_monitor = DebugMon_Handler,
+    .pendsv = PendSV_Handler,
+    .systick = SysTick_Handler,
+    .irq =
+    {
+        [0] = WWDG_IRQHandler,
+        [1] = PVD_IRQHandler,
+        [2] = TAMP_STAMP_IRQHandler,
+        [3] = RTC_WKUP_IRQHandler,
+        [4] = FLASH_IRQHandler,
+        [5] = RCC_IRQHandler,
+        [6] = EXTI0_IRQHandler,
+        [7] = EXTI1_IRQHandler,
+        [8] = EXTI2_IRQHandler,
+        [9] = EXTI3_IRQHandler,
+        [10] = EXTI4_IRQHandler,
+        [11] = DMA1_Stream0_IRQHandler,
+        [12] = DMA1_Stream1_IRQHandler,
+        [13] = DMA1_Stream2_IRQHandler,
+        [14] = DMA1_Stream3_IRQHandler,
+        [15] = DMA1_Stream4_IRQHandler,
+        [16] = DMA1_Stream5_IRQHandler,
+        [17] = DMA1_Stream6_IRQHandler,
+        [18] = ADC_IRQHandler,
+        [23] = EXTI9_5_IRQHandler,
+        [24] = TIM1_BRK_TIM9_IRQHandler,
+        [25] = TIM1_UP_TIM10_IRQHandler,
+        [26] = TIM1_TRG_COM_TIM11_IRQHandler,
+        [27] = TIM1_CC_IRQHandler,
+        [28] = TIM2_IRQHandler,
+        [29] = TIM3_IRQHandler,
+        [30] = TIM4_IRQHandler,
+        [31] = I2C1_EV_IRQHandler,
+        [32] = I2C1_ER_IRQHandler,
+        [33] = I2C2_EV_IRQHandler,
+        [34] = I2C2_ER_IRQHandler,
+        [35] = SPI1_IRQHandler,
+        [36] = SPI2_IRQHandler,
+        [37] = USART1_IRQHandler,
+        [38] = USART2_IRQHandler,
+        [40] = EXTI15_10_IRQHandler,
+        [41] = RTC_Alarm_IRQHandler,
+        [42] = OTG_FS_WKUP_IRQHandler,
+        [47] = DMA1_Stream7_IRQHandler,
+        [49] = SDIO_IRQHandler,
+        [50] = TIM5_IRQHandler,
+        [51] = SPI3_IRQHandler,
+        [56] = DMA2_Stream0_IRQHandler,
+        [57] = DMA2_Stream1_IRQHandler,
+        [58] = DMA2_Stream2_IRQHandler,
+        [59] = DMA2_Stream3_IRQHandler,
+        [60] = DMA2_Stream4_IRQHandler,
+        [67] = OTG_FS_IRQHandler,
+        [68] = DMA2_Stream5_IRQHandler,
+        [69] = DMA2_Stream6_IRQHandler,
+        [70] = DMA2_Stream7_IRQHandler,
+        [71] = USART6_IRQHandler,
+        [72] = I2C3_EV_IRQHandler,
+        [73] = I2C3_ER_IRQHandler,
+        [81] = FPU_IRQHandler,
+        [84] = SPI4_IRQHandler,
+        [85] = SPI5_IRQHandler,
+    },
+};
@@ -0,0 +1,203 @@
+// Startup code for STM32F446RE (Nucleo-F446RE): typed vector table (97 IRQs, RM0390 table 38), weak handlers, reset handler
+// Link with STM32F446RE.ld; see Startup.md for the build line.
+
+#include <stdint.h>
+
+#define VECTOR_IRQ_COUNT 97U
+
+#include "Startup_Common.h"
+
+/*-------------------------------------------Peripheral handlers (weak)---------------------------------------*/
+
+WEAK_HANDLER(WWDG_IRQHandler);
+WEAK_HANDLER(PVD_IRQHandler);
+WEAK_HANDLER(TAMP_STAMP_IRQHandler);
+WEAK_HANDLER(RTC_WKUP_IRQHandler);
+WEAK_HANDLER(FLASH_IRQHandler);
+WEAK_HANDLER(RCC_IRQHandler);
+WEAK_HANDLER(EXTI0_IRQHandler);
+WEAK_HANDLER(EXTI1_IRQHandler);
+WEAK_HANDLER(EXTI2_IRQHandler);
+WEAK_HANDLER(EXTI3_IRQHandler);
+WEAK_HANDLER(EXTI4_IRQHandler);
+WEAK_HANDLER(DMA1_Stream0_IRQHandler);
+WEAK_HANDLER(DMA1_Stream1_IRQHandler);
+WEAK_HANDLER(DMA1_Stream2_IRQHandler);
+WEAK_HANDLER(DMA1_Stream3_IRQHandler);
+WEAK_HANDLER(DMA1_Stream4_IRQHandler);
+WEAK_HANDLER(DMA1_Stream5_IRQHandler);
+WEAK_HANDLER(DMA1_Stream6_IRQHandler);
+WEAK_HANDLER(ADC_IRQHandler);
+WEAK_HANDLER(CAN1_TX_IRQHandler);
+WEAK_HANDLER(CAN1_RX0_IRQHandler);
+WEAK_HANDLER(CAN1_RX1_IRQHandler);
+WEAK_HANDLER(CAN1_SCE_IRQHandler);
+WEAK_HANDLER(EXTI9_5_IRQHandler);
+WEAK_HANDLER(TIM1_BRK_TIM9_IRQHandler);
+WEAK_HANDLER(TIM1_UP_TIM10_IRQHandler);
+WEAK_HANDLER(TIM1_TRG_COM_TIM11_IRQHandler);
+WEAK_HANDLER(TIM1_CC_IRQHandler);
+WEAK_HANDLER(TIM2_IRQHandler);
+WEAK_HANDLER(TIM3_IRQHandler);
+WEAK_HANDLER(TIM4_IRQHandler);
+WEAK_HANDLER(I2C1_EV_IRQHandler);
+WEAK_HANDLER(I2C1_ER_IRQHandler);
+WEAK_HANDLER(I2C2_EV_IRQHandler);
+WEAK_HANDLER(I2C2_ER_IRQHandler);
+WEAK_HANDLER(SPI1_IRQHandler);
+WEAK_HANDLER(SPI2_IRQHandler);
+WEAK_HANDLER(USART1_IRQHandler);
+WEAK_HANDLER(USART2_IRQHandler);
+WEAK_HANDLER(USART3_IRQHandler);
+WEAK_HANDLER(EXTI15_10_IRQHandler);
+WEAK_HANDLER(RTC_Alarm_IRQHandler);
+WEAK_HANDLER(OTG_FS_WKUP_IRQHandler);
+WEAK_HANDLER(TIM8_BRK_TIM12_IRQHandler);
+WEAK_HANDLER(TIM8_UP_TIM13_IRQHandler);
+WEAK_HANDLER(TIM8_TRG_COM_TIM14_IRQHandler);
+WEAK_HANDLER(TIM8_CC_IRQHandler);
+WEAK_HANDLER(DMA1_Stream7_IRQHandler);
+WEAK_HANDLER(FMC_IRQHandler);
+WEAK_HANDLER(SDIO_IRQHandler);
+WEAK_HANDLER(TIM5_IRQHandler);
+WEAK_HANDLER(SPI3_IRQHandler);
+WEAK_HANDLER(UART4_IRQHandler);
+WEAK_HANDLER(UART5_IRQHandler);
+WEAK_HANDLER(TIM6_DAC_IRQHandler);
+WEAK_HANDLER(TIM7_IRQHandler);
+WEAK_HANDLER(DMA2_Stream0_IRQHandler);
+WEAK_HANDLER(DMA2_Stream1_IRQHandler);
+WEAK_HANDLER(DMA2_Stream2_IRQHandler);
+WEAK_HANDLER(DMA2_Stream3_IRQHandler);
+WEAK_HANDLER(DMA2_Stream4_IRQHandler);
+WEAK_HANDLER(CAN2_TX_IRQHandler);
+WEAK_HANDLER(CAN2_RX0_IRQHandler);
+WEAK_HANDLER(CAN2_RX1_IRQHandler);
+WEAK_HANDLER(CAN2_SCE_IRQHandler);
+WEAK_HANDLER(OTG_FS_IRQHandler);
+WEAK_HANDLER(DMA2_Stream5_IRQHandler);
+WEAK_HANDLER(DMA2_Stream6_IRQHandler);
+WEAK_HANDLER(DMA2_Stream7_IRQHandler);
+WEAK_HANDLER(USART6_IRQHandler);
+WEAK_HANDLER(I2C3_EV_IRQHandler);
+WEAK_HANDLER(I2C3_ER_IRQHandler);
+WEAK_HANDLER(OTG_HS_EP1_OUT_IRQHandler);
+WEAK_HANDLER(OTG_HS_EP1_IN_IRQHandler);
+WEAK_HANDLER(OTG_HS_WKUP_IRQHandler);
+WEAK_HANDLER(OTG_HS_IRQHandler);
+WEAK_HANDLER(DCMI_IRQHandler);
+WEAK_HANDLER(FPU_IRQHandler);
+WEAK_HANDLER(SPI4_IRQHandler);
+WEAK_HANDLER(SAI1_IRQHandler);
+WEAK_HANDLER(SAI2_IRQHandler);
+WEAK_HANDLER(QUADSPI_IRQHandler);
+WEAK_HANDLER(CEC_IRQHandler);
+WEAK_HANDLER(SPDIF_RX_IRQHandler);
+WEAK_HANDLER(FMPI2C1_EV_IRQHandler);
+WEAK_HANDLER(FMPI2C1_ER_IRQHandler);
+
+/*-------------------------------------------Vector table----------------------------------------------------*/
+
+__attribute__((section(".isr_vector"), used)) const Vector_Table_t Vector_Table =
+{
+    .initial_sp = &_estack,
+    .reset = Reset_Handler,
+    .nmi = NMI_Handler,
+    .hard_fault = HardFault_Handler,
+    .mem_manage = MemManage_Handler,
+    .bus_fault = BusFault_Handler,
+    .usage_fault = UsageFault_Handler,
+    .svc = SVC_Handler,
+    .debug_monitor = DebugMon_Handler,
+    .pendsv = PendSV_Handler,
+    .systick = SysTick_Handler,
+    .irq =
+    {
+        [0] = WWDG_IRQHandler,
+        [1] = PVD_IRQHandler,
+        [2] = TAMP_STAMP_IRQHandler,
+        [3] = RTC_WKUP_IRQHandler,
+        [4] = FLASH_IRQHandler,
+        [5] = RCC_IRQHandler,
+        [6] = EXTI0_IRQHandler,
+        [7] = EXTI1_IRQHandler,
+        [8] = EXTI2_IRQHandler,
+        [9] = EXTI3_IRQHandler,
+        [10] = EXTI4_IRQHandler,
+        [11] = DMA1_Stream0_IRQHandler,
+        [12] = DMA1_Stream1_IRQHandler,
+        [13] = DMA1_Stream2_IRQHandler,
+        [14] = DMA1_Stream3_IRQHandler,
+        [15] = DMA1_Stream4_IRQHandler,
+        [16] = DMA1_Stream5_IRQHandler,
+        [17] = DMA1_Stream6_IRQHandler,
+        [18] = ADC_IRQHandler,
+        [19] = CAN1_TX_IRQHandler,
+        [20] = CAN1_RX0_IRQHandler,
+        [21] = CAN1_RX1_IRQHandler,
+        [22] = CAN1_SCE_IRQHandler,
+        [23] = EXTI9_5_IRQHandler,
+        [24] = TIM1_BRK_TIM9_IRQHandler,
+        [25] = TIM1_UP_TIM10_IRQHandler,
+        [26] = TIM1_TRG_COM_TIM11_IRQHandler,
+        [27] = TIM1_CC_IRQHandler,
+        [28] = TIM2_IRQHandler,
+        [29] = TIM3_IRQHandler,
+        [30] = TIM4_IRQHandler,
+        [31] = I2C1_EV_IRQHandler,
+        [32] = I2C1_ER_IRQHandler,
+        [33] = I2C2_EV_IRQHandler,
+        [34] = I2C2_ER_IRQHandler,
+        [35] = SPI1_IRQHandler,
+        [36] = SPI2_IRQHandler,
+        [37] = USART1_IRQHandler,
+        [38] = USART2_IRQHandler,
+        [39] = USART3_IRQHandler,
+        [40] = EXTI15_10_IRQHandler,
+        [41] = RTC_Alarm_IRQHandler,
+        [42] = OTG_FS_WKUP_IRQHandler,
+        [43] = TIM8_BRK_TIM12_IRQHandler,
+        [44] = TIM8_UP_TIM13_IRQHandler,
+        [45] = TIM8_TRG_COM_TIM14_IRQHandler,
+        [46] = TIM8_CC_IRQHandler,
+        [47] = DMA1_Stream7_IRQHandler,
+        [48] = FMC_IRQHandler,
+        [49] = SDIO_IRQHandler,
+        [50] = TIM5_IRQHandler,
+        [51] = SPI3_IRQHandler,
+        [52] = UART4_IRQHandler,
+        [53] = UART5_IRQHandler,
+        [54] = TIM6_DAC_IRQHandler,
+        [55] = TIM7_IRQHandler,
+        [56] = DMA2_Stream0_IRQHandler,
+        [57] = DMA2_Stream1_IRQHandler,
+        [58] = DMA2_Stream2_IRQHandler,
+        [59] = DMA2_Stream3_IRQHandler,
+        [60] = DMA2_Stream4_IRQHandler,
+        [63] = CAN2_TX_IRQHandler,
+        [64] = CAN2_RX0_IRQHandler,
+        [65] = CAN2_RX1_IRQHandler,
+        [66] = CAN2_SCE_IRQHandler,
+        [67] = OTG_FS_IRQHandler,
+        [68] = DMA2_Stream5_IRQHandler,
+        [69] = DMA2_Stream6_IRQHandler,
+        [70] = DMA2_Stream7_IRQHandler,
+        [71] = USART6_IRQHandler,
+        [72] = I2C3_EV_IRQHandler,
+        [73] = I2C3_ER_IRQHandler,
+        [74] = OTG_HS_EP1_OUT_IRQHandler,
+        [75] = OTG_HS_EP1_IN_IRQHandler,
+        [76] = OTG_HS_WKUP_IRQHandler,
+        [77] = OTG_HS_IRQHandler,
+        [78] = DCMI_IRQHandler,
+        [81] = FPU_IRQHandler,
+        [84] = SPI4_IRQHandler,
+        [87] = SAI1_IRQHandler,
+        [91] = SAI2_IRQHandler,
+        [92] = QUADSPI_IRQHandler,
+        [93] = CEC_IRQHandler,
+        [94] = SPDIF_RX_IRQHandler,
+        [95] = FMPI2C1_EV_IRQHandler,
+        [96] = FMPI2C1_ER_IRQHandler,
+    },
+};
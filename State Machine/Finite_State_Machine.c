@@ -1,34 +1,14 @@
 //event-driven Moore finite state machine implemented in a super-loop architecture
 
 #include <stdint.h>
-
-#define RCC_BASE 0x40023800UL
-#define RCC_AHB1ENR (*(volatile uint32_t *)(RCC_BASE + 0x30)) // FOR GPIO
-#define RCC_APB2ENR (*(volatile uint32_t *)(RCC_BASE + 0x44)) // FOR EXTI
-#define RCC_APB1ENR (*(volatile uint32_t *)(RCC_BASE + 0x40)) // FOR TM2
-
-// GPIOA
-#define GPIOA_BASE 0x40020000UL
-#define GPIOA_MODER (*(volatile uint32_t *)(GPIOA_BASE + 0x00))
-#define GPIOA_BSRR (*(volatile uint32_t *)(GPIOA_BASE + 0x18))
-#define GPIOA_ODR (*(volatile uint32_t *)(GPIOA_BASE + 0x14))
-#define GPIOA_AFRL (*(volatile uint32_t *)(GPIOA_BASE + 0x20))
+#include "../Device_Driver_Devlopment/TIM2_PWM_Driver_STM32F4xx.h" // GPIOA and TIM2 registers, RCC clock manager
+#include "../Atomics/Atomics.h"
 
 // SYStick
 #define SYST_CSR (*(volatile uint32_t *)0xE000E010)
 #define SYST_RVR (*(volatile uint32_t *)0xE000E014)
 #define SYST_CVR (*(volatile uint32_t *)0xE000E018)
 
-// TM2
-#define TIM2_BASE 0x40000000UL
-#define TIM2_CR1 (*(volatile uint32_t *)(TIM2_BASE + 0x00))
-#define TIM2_CCMR1 (*(volatile uint32_t *)(TIM2_BASE + 0x18))
-#define TIM2_CCER (*(volatile uint32_t *)(TIM2_BASE + 0x1C))
-#define TIM2_PSC (*(volatile uint32_t *)(TIM2_BASE + 0x28))
-#define TIM2_ARR (*(volatile uint32_t *)(TIM2_BASE + 0x2C))
-#define TIM2_CCR1 (*(volatile uint32_t *)(TIM2_BASE + 0x34))
-#define TIM2_EGR (*(volatile uint32_t *)(TIM2_BASE + 0x14))
-
 // SYSCFG
 #define SYSCFG_BASE 0x40013800
 #define SYSCFG_EXTICR1 (*(volatile uint32_t *)(SYSCFG_BASE + 0x08))
@@ -49,12 +29,14 @@ typedef enum LED_STATE
     LED_PWM = 3
 } led_state_en;
 
-led_state_en button_sate = LED_OFF;
+volatile uint32_t button_sate = LED_OFF; // written by EXTI1, read by the super loop
 uint8_t duty = 0;
-uint8_t pwm_flag = 0;
+uint8_t toggle_level = 0;
+RCC_Clock_Report_t clock_report; // active clock set after init, for the debugger
 
 #define LED_PIN_GPIOA0 0
 #define PUSH_BUTTON_GPIOA1 1
+#define LED_TIM2_CH 1 // PA0 = TIM2_CH1 (AF1)
 
 #define CLK_FRQ 16000000UL // Using STM32F411 CPU Clock
 #define LOAD_VAL (CLK_FRQ / 1000) - 1
@@ -78,108 +60,63 @@ void delay_ms(uint32_t ms)
 
 void GPIOA_Init(void)
 {
-    RCC_AHB1ENR |= 1 << 0;
-    GPIOA_MODER &= ~(3 << (2 * LED_PIN_GPIOA0));
-    GPIOA_MODER |= (1 << (2 * LED_PIN_GPIOA0));
+    RCC_Clock_Ensure(RCC_CLK_GPIOA); // shared with the PWM channel: one reference, one RCC write
     GPIOA_MODER &= ~(3 << (2 * PUSH_BUTTON_GPIOA1));
 }
 
-void GPIOA_Init_AF(void)
-{
-    RCC_AHB1ENR |= 1 << 0;
-    GPIOA_MODER &= ~(3 << (2 * LED_PIN_GPIOA0));
-    GPIOA_MODER |= (2 << (2 * LED_PIN_GPIOA0));
-
-    GPIOA_AFRL &= ~(0xF << (4 * LED_PIN_GPIOA0));
-    GPIOA_AFRL |= (1 << (4 * LED_PIN_GPIOA0));
-}
-
 void EXTI1_IRQHandler(void)
 {
-    button_sate++;
+    Atomic_Fetch_Add_Mod(&button_sate, 1U, 4U); // LED_OFF .. LED_PWM, never a transient 4
     EXTI_PR = (1 << PUSH_BUTTON_GPIOA1);
-
-    if (button_sate > 3)
-    {
-        button_sate = 0;
-    }
 }
 
+// Timer and pin are configured once; states only switch the OC1M field afterwards
 void TIM2_PWM_Init(void)
 {
-    RCC_APB1ENR |= (1 << 0); // TIM2 clock
-
-    TIM2_PSC = 15;   // 16MHz / 16 = 1MHz
-    TIM2_ARR = 1000; // 1kHz PWM
-    TIM2_CCR1 = 0;
-
-    TIM2_CCMR1 = 0;
-    TIM2_CCMR1 |= (6 << 4); // PWM mode 1
-    TIM2_CCMR1 |= (1 << 3); // preload enable
-
-    TIM2_CCER = 0;
-    TIM2_CCER |= (1 << 0); // enable CH1
-
-    TIM2_CR1 |= (1 << 7); // ARPE
-    TIM2_EGR = (1 << 0);  // update
-    TIM2_CR1 |= (1 << 0); // start timer
+    PWM_Output_Init(15, 999);                             // 16MHz / 16 = 1MHz, 1kHz PWM
+    PWM_Output_Channel_Init(LED_TIM2_CH, LED_PIN_GPIOA0); // PA0 AF1, starts forced low
 }
 
 int main(void)
 {
 
-    RCC_APB2ENR |= (1 << 14);
+    // SYSCFG is only needed to write EXTICR; the line mapping holds with its clock gated again
+    RCC_Clock_Enable(RCC_CLK_SYSCFG);
     SYSCFG_EXTICR1 &= ~(0xF << 8);
+    RCC_Clock_Release(RCC_CLK_SYSCFG);
 
     EXTI_IMR |= 1 << PUSH_BUTTON_GPIOA1;
     EXTI_RTSR |= 1 << PUSH_BUTTON_GPIOA1;
     NVIC_ISER0 |= 1 << 7;
 
-    RCC_AHB1ENR |= 1 << 0;
-
     Sys_Timer_Init();
+    GPIOA_Init();
+    TIM2_PWM_Init();
+
+    RCC_Clock_Get_Report(&clock_report); // GPIOA + TIM2 on, SYSCFG off; unmanaged = enabled outside the manager
 
     while (1)
     {
-        if (pwm_flag && button_sate != LED_PWM)
-        {
-            GPIOA_Init();
-            pwm_flag = 0;
-            TIM2_CR1 &= ~(1 << 0);
-        }
-
-        switch (button_sate)
+        switch ((led_state_en)button_sate)
         {
         case LED_OFF:
-            GPIOA_BSRR = 1 << (LED_PIN_GPIOA0 + 16);
+            PWM_Output_Set_Mode(LED_TIM2_CH, PWM_OUT_FORCE_INACTIVE);
             break;
 
         case LED_ON:
-            GPIOA_BSRR = 1 << (LED_PIN_GPIOA0);
+            PWM_Output_Set_Mode(LED_TIM2_CH, PWM_OUT_FORCE_ACTIVE);
             break;
 
         case LED_TOGGLE:
-            if (GPIOA_ODR & (1 << LED_PIN_GPIOA0))
-            {
-                GPIOA_BSRR = 1 << (LED_PIN_GPIOA0 + 16);
-            }
-            else
-            {
-                GPIOA_BSRR = 1 << LED_PIN_GPIOA0;
-            }
+            toggle_level ^= 1;
+            PWM_Output_Set_Mode(LED_TIM2_CH, toggle_level ? PWM_OUT_FORCE_ACTIVE : PWM_OUT_FORCE_INACTIVE);
             delay_ms(1000);
             break;
 
         case LED_PWM:
-
-            if (!pwm_flag)
-            {
-                GPIOA_Init_AF();
-                TIM2_PWM_Init();
-                duty = 0;
-                pwm_flag = 1;
-            }
-            TIM2_CCR1 = (TIM2_ARR * duty) / 100;
+            // Duty ramp continues where it left off; the counter never stopped
+            PWM_Output_Set_Mode(LED_TIM2_CH, PWM_OUT_PWM1);
+            PWM_Output_Set_Duty(LED_TIM2_CH, duty);
             delay_ms(50);
             duty += 1;
             if (duty > 100)
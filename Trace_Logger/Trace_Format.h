@@ -0,0 +1,49 @@
+// Wire format of the binary trace stream, shared by the target logger and the host decoder
+// Record = header word, timestamp word, 0..4 argument words (little endian, as the Cortex-M4 stores them)
+
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <stdint.h>
+#include "Trace_Messages.h"
+
+#define TRACE_SYNC 0xA5U    // low byte of every header, lets the decoder resynchronise after a lost byte
+#define TRACE_MAX_ARGS 4U
+#define TRACE_MAX_WORDS (2U + TRACE_MAX_ARGS)
+
+// header = id (31:16) | argument count (11:8) | sync (7:0)
+#define TRACE_HEADER(id, nargs) (((uint32_t)(id) << 16) | ((uint32_t)(nargs) << 8) | TRACE_SYNC)
+#define TRACE_HEADER_ID(h) ((uint16_t)((h) >> 16))
+#define TRACE_HEADER_NARGS(h) ((uint8_t)(((h) >> 8) & 0xFU))
+#define TRACE_HEADER_VALID(h) ((((h) & 0xFFU) == TRACE_SYNC) && (((h) & 0xF000U) == 0U) && \
+                               (TRACE_HEADER_NARGS(h) <= TRACE_MAX_ARGS))
+
+#ifndef TRACE_TICK_HZ
+#define TRACE_TICK_HZ 1000000UL // timestamp = TIM2_CNT at 1 MHz
+#endif
+
+/*-------------------------------------------Message IDs--------------------------------------------------*/
+
+#define TRACE_ENUM(name, format) name,
+
+typedef enum TRACE_ID
+{
+    TRACE_ID_DROPPED = 0, // emitted by the logger itself after the ring overflowed
+    TRACE_MESSAGES(TRACE_ENUM)
+    TRACE_ID_COUNT
+} TRACE_ID;
+
+// Format strings exist only in the host build: the target stores IDs, never text
+#ifdef TRACE_HOST
+
+#define TRACE_STRING(name, format) format,
+
+static const char *const Trace_Format_Table[TRACE_ID_COUNT] =
+{
+    "<%u trace records dropped>",
+    TRACE_MESSAGES(TRACE_STRING)
+};
+
+#endif
+
+#endif
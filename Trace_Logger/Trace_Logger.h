@@ -0,0 +1,206 @@
+// Deferred-formatting binary trace logger for STM32F411x / STM32F446xx
+// A log site stores a message ID, a timestamp and up to four raw 32-bit arguments in a RAM ring
+// (~20-30 cycles, callable from any ISR). The ring drains over USART TX DMA in the background;
+// trace_decode on the host turns the records back into text with the table in Trace_Messages.h.
+
+#ifndef TRACE_LOGGER_H
+#define TRACE_LOGGER_H
+
+#include <stdint.h>
+#include "Trace_Format.h"
+#include "../Device_Driver_Devlopment/UART_DMA_Driver_STM32F4xx.h"
+
+/*-------------------------------------------TIM2 (timestamp)---------------------------------------------*/
+
+#define TIM2_BASE 0x40000000UL
+#define TIM2_CR1 (*(volatile uint32_t *)(TIM2_BASE + 0x00))
+#define TIM2_EGR (*(volatile uint32_t *)(TIM2_BASE + 0x14))
+#define TIM2_CNT (*(volatile uint32_t *)(TIM2_BASE + 0x24))
+#define TIM2_PSC (*(volatile uint32_t *)(TIM2_BASE + 0x28))
+#define TIM2_ARR (*(volatile uint32_t *)(TIM2_BASE + 0x2C))
+
+// Any free-running 32-bit counter at TRACE_TICK_HZ works, e.g. DWT_CYCCNT with TRACE_TICK_HZ = CLK_FRQ
+#ifndef TRACE_TIMESTAMP
+#define TRACE_TIMESTAMP() (TIM2_CNT)
+#endif
+
+/*-------------------------------------------Ring---------------------------------------------------------*/
+
+#ifndef TRACE_RING_WORDS
+#define TRACE_RING_WORDS 512U // power of two, 2 KB
+#endif
+
+#define TRACE_RING_MASK (TRACE_RING_WORDS - 1U)
+
+#if (TRACE_RING_WORDS & TRACE_RING_MASK) != 0
+#error "TRACE_RING_WORDS must be a power of two"
+#endif
+
+// Head and tail run freely and are masked on access: head - tail = words waiting
+static uint32_t Trace_Ring[TRACE_RING_WORDS];
+static volatile uint32_t Trace_Head;
+static volatile uint32_t Trace_Tail;
+static volatile uint32_t Trace_Dropped;
+static volatile uint32_t Trace_Tx_Errors; // DMA transfer errors, resent from the ring
+static volatile uint32_t Trace_In_Flight; // words currently owned by the TX DMA
+static UART_PORTS Trace_Port;
+
+/*-------------------------------------------Lock---------------------------------------------------------*/
+
+// PRIMASK, not BASEPRI: log sites run at every priority including TIM2 at the top of the plan,
+// and the masked window is only a handful of stores.
+static inline __attribute__((always_inline)) uint32_t Trace_Lock(void)
+{
+    uint32_t primask;
+
+    __asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) : : "memory");
+    return primask;
+}
+
+static inline __attribute__((always_inline)) void Trace_Unlock(uint32_t Primask)
+{
+    __asm volatile("msr primask, %0" : : "r"(Primask) : "memory");
+}
+
+/*-------------------------------------------Log sites----------------------------------------------------*/
+
+// Inlined at every call site; with a constant Nargs the unused argument stores disappear.
+static inline __attribute__((always_inline)) void Trace_Write(uint32_t Header, uint32_t Nargs, uint32_t A0,
+                                                              uint32_t A1, uint32_t A2, uint32_t A3)
+{
+    uint32_t primask = Trace_Lock();
+    uint32_t head = Trace_Head;
+    uint32_t need = 2U + Nargs + (Trace_Dropped ? 3U : 0U);
+
+    if ((TRACE_RING_WORDS - (head - Trace_Tail)) < need)
+    {
+        Trace_Dropped++;
+        Trace_Unlock(primask);
+        return;
+    }
+
+    uint32_t now = TRACE_TIMESTAMP();
+
+    // First record after an overflow reports how many were lost
+    if (Trace_Dropped)
+    {
+        Trace_Ring[head & TRACE_RING_MASK] = TRACE_HEADER(TRACE_ID_DROPPED, 1);
+        Trace_Ring[(head + 1U) & TRACE_RING_MASK] = now;
+        Trace_Ring[(head + 2U) & TRACE_RING_MASK] = Trace_Dropped;
+        Trace_Dropped = 0;
+        head += 3U;
+    }
+
+    Trace_Ring[head & TRACE_RING_MASK] = Header;
+    Trace_Ring[(head + 1U) & TRACE_RING_MASK] = now;
+
+    if (Nargs > 0U)
+    {
+        Trace_Ring[(head + 2U) & TRACE_RING_MASK] = A0;
+    }
+
+    if (Nargs > 1U)
+    {
+        Trace_Ring[(head + 3U) & TRACE_RING_MASK] = A1;
+    }
+
+    if (Nargs > 2U)
+    {
+        Trace_Ring[(head + 4U) & TRACE_RING_MASK] = A2;
+    }
+
+    if (Nargs > 3U)
+    {
+        Trace_Ring[(head + 5U) & TRACE_RING_MASK] = A3;
+    }
+
+    Trace_Head = head + 2U + Nargs;
+    Trace_Unlock(primask);
+}
+
+#define TRACE0(id) Trace_Write(TRACE_HEADER(id, 0), 0, 0, 0, 0, 0)
+#define TRACE1(id, a) Trace_Write(TRACE_HEADER(id, 1), 1, (uint32_t)(a), 0, 0, 0)
+#define TRACE2(id, a, b) Trace_Write(TRACE_HEADER(id, 2), 2, (uint32_t)(a), (uint32_t)(b), 0, 0)
+#define TRACE3(id, a, b, c) Trace_Write(TRACE_HEADER(id, 3), 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), 0)
+#define TRACE4(id, a, b, c, d) \
+    Trace_Write(TRACE_HEADER(id, 4), 4, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d))
+
+/*-------------------------------------------Drain over UART DMA------------------------------------------*/
+
+void Trace_Drain(void);
+
+// TX DMA complete: release the words just sent and chain the next piece straight from the ISR.
+// On a transfer error the words stay in the ring and the next Trace_Drain() from the main loop resends
+// them (not chained here, so a persistent error cannot turn into an interrupt storm).
+void Trace_Tx_Done(UART_STATUS Status)
+{
+    if (Status != UART_OK)
+    {
+        Trace_In_Flight = 0;
+        Trace_Tx_Errors++;
+        return;
+    }
+
+    Trace_Tail += Trace_In_Flight;
+    Trace_In_Flight = 0;
+    Trace_Drain();
+}
+
+// Starts one DMA transfer of the words between tail and head (up to the end of the ring).
+// Call it from the main loop; once running, further pieces are chained by Trace_Tx_Done.
+void Trace_Drain(void)
+{
+    uint32_t primask = Trace_Lock();
+
+    if ((Trace_In_Flight == 0U) && (Trace_Head != Trace_Tail))
+    {
+        uint32_t index = Trace_Tail & TRACE_RING_MASK;
+        uint32_t words = Trace_Head - Trace_Tail;
+
+        if (words > (TRACE_RING_WORDS - index))
+        {
+            words = TRACE_RING_WORDS - index; // wrapped: rest goes in the next transfer
+        }
+
+        Trace_In_Flight = words;
+
+        if (UART_DMA_Transmit(Trace_Port, (const uint8_t *)&Trace_Ring[index], (uint16_t)(4U * words),
+                              Trace_Tx_Done) != UART_OK)
+        {
+            Trace_In_Flight = 0; // TX used by someone else, try again on the next call
+        }
+    }
+
+    Trace_Unlock(primask);
+}
+
+uint32_t Trace_Pending_Words(void)
+{
+    return Trace_Head - Trace_Tail;
+}
+
+/*-------------------------------------------Init---------------------------------------------------------*/
+
+// Free-running 32-bit TIM2 at TRACE_TICK_HZ (1 us, wraps after 71 minutes; the decoder extends it)
+void Trace_Timebase_Init(uint32_t Timer_Clock)
+{
+    RCC_Clock_Ensure(RCC_CLK_TIM2);
+
+    TIM2_PSC = (Timer_Clock / TRACE_TICK_HZ) - 1U;
+    TIM2_ARR = 0xFFFFFFFFUL;
+    TIM2_EGR = (1 << 0);
+    TIM2_CR1 |= (1 << 0);
+}
+
+// Port must already be set up with UART_DMA_Init; the trace stream owns its TX direction
+void Trace_Init(UART_PORTS Port)
+{
+    Trace_Port = Port;
+    Trace_Head = 0;
+    Trace_Tail = 0;
+    Trace_Dropped = 0;
+    Trace_Tx_Errors = 0;
+    Trace_In_Flight = 0;
+}
+
+#endif
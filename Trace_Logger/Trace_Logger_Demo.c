@@ -0,0 +1,137 @@
+// Binary trace logging from EXTI2_IRQHandler, TIM2_IRQHandler and the main loop, drained over USART1 DMA (STM32F411)
+// Decode on the host: ./trace_decode /dev/ttyUSB0
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/EXTI_Driver_STM32F4xx.h"
+#include "Trace_Logger.h"
+
+// TIM2 compare channel 1 (periodic event on the free-running trace timebase) ----------
+
+#define TIM2_DIER (*(volatile uint32_t *)(TIM2_BASE + 0x0C))
+#define TIM2_SR (*(volatile uint32_t *)(TIM2_BASE + 0x10))
+#define TIM2_CCR1 (*(volatile uint32_t *)(TIM2_BASE + 0x34))
+
+#define TIM2_IRQn 28U
+#define TIM_DIER_CC1IE (1U << 1)
+#define TIM_SR_CC1IF (1U << 1)
+
+// DWT (only used to measure the cost of a log site) ---------------------------------
+
+#define DEMCR (*(volatile uint32_t *)(0xE000EDFCUL))
+#define DWT_CTRL (*(volatile uint32_t *)(0xE0001000UL))
+#define DWT_CYCCNT (*(volatile uint32_t *)(0xE0001004UL))
+
+// GPIOA -------------------------------------------------------------------------
+
+#define GPIOA_BASE 0x40020000UL
+#define GPIOA_MODER (*(volatile uint32_t *)(GPIOA_BASE + 0x00))
+#define GPIOA_ODR (*(volatile uint32_t *)(GPIOA_BASE + 0x14))
+#define GPIOA_BSRR (*(volatile uint32_t *)(GPIOA_BASE + 0x18))
+
+#define HSI_CLK 16000000U
+#define TRACE_BAUD 2000000UL
+#define TICK_PERIOD 100000U // 100 ms at 1 MHz
+
+#define LED_PA5 5
+#define BUTTON_PA2 2 // EXTI2 (dedicated vector)
+
+uint8_t Rx_Ring[64];
+
+volatile uint32_t tick_count = 0;
+volatile uint32_t button_count = 0;
+
+void Rx_Ignore(const uint8_t *Data, uint16_t Length)
+{
+    (void)Data;
+    (void)Length;
+}
+
+// ISR latency = timer ticks between the compare match and the first instruction that reads CNT
+void TIM2_IRQHandler(void)
+{
+    uint32_t latency = TIM2_CNT - TIM2_CCR1;
+
+    TIM2_SR = ~TIM_SR_CC1IF;
+    TIM2_CCR1 += TICK_PERIOD; // next match, no drift: the counter never stops
+
+    tick_count++;
+    TRACE2(TRACE_ID_TICK, tick_count, latency);
+}
+
+void Button_Pressed(uint8_t Line)
+{
+    uint32_t on = (GPIOA_ODR & (1U << LED_PA5)) ? 0U : 1U;
+
+    GPIOA_BSRR = on ? (1U << LED_PA5) : (1U << (LED_PA5 + 16));
+
+    button_count++;
+    TRACE2(TRACE_ID_BUTTON, Line, button_count);
+    TRACE2(TRACE_ID_LED, LED_PA5, on);
+}
+
+void Tick_Init(void)
+{
+    TIM2_CCR1 = TIM2_CNT + TICK_PERIOD;
+    TIM2_SR = ~TIM_SR_CC1IF;
+    TIM2_DIER |= TIM_DIER_CC1IE;
+
+    NVIC_Setup_IRQ(TIM2_IRQn, NVIC_PREEMPT_TIMEBASE, 0);
+}
+
+// Cycles for one inlined log site, measured once at boot and logged like any other message
+void Trace_Measure_Cost(void)
+{
+    uint32_t start;
+    uint32_t one;
+    uint32_t four;
+
+    DEMCR |= (1UL << 24);
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= (1UL << 0);
+
+    start = DWT_CYCCNT;
+    TRACE1(TRACE_ID_LOOP, 0);
+    one = DWT_CYCCNT - start;
+
+    start = DWT_CYCCNT;
+    TRACE4(TRACE_ID_COST, 1, 2, 3, 4);
+    four = DWT_CYCCNT - start;
+
+    TRACE2(TRACE_ID_COST, one, four);
+}
+
+int main(void)
+{
+    uint32_t last_tick = 0;
+    uint32_t loop_passes = 0;
+
+    NVIC_Init();
+
+    RCC_Clock_Ensure(RCC_CLK_GPIOA);
+    GPIOA_MODER &= ~((3U << (LED_PA5 * 2)) | (3U << (BUTTON_PA2 * 2)));
+    GPIOA_MODER |= (1U << (LED_PA5 * 2));
+
+    UART_DMA_Init(UART_1, TRACE_BAUD, Rx_Ring, sizeof(Rx_Ring), Rx_Ignore);
+    Trace_Timebase_Init(HSI_CLK);
+    Trace_Init(UART_1);
+
+    TRACE2(TRACE_ID_BOOT, HSI_CLK, TRACE_RING_WORDS);
+    Trace_Measure_Cost();
+
+    Tick_Init();
+    EXTI_Init(EXTI_PORT_A, BUTTON_PA2, EXTI_EDGE_RISING, Button_Pressed);
+
+    while (1)
+    {
+        loop_passes++;
+
+        if (tick_count != last_tick)
+        {
+            last_tick = tick_count;
+            TRACE1(TRACE_ID_LOOP, loop_passes);
+            loop_passes = 0;
+        }
+
+        Trace_Drain(); // no-op while a transfer is running
+    }
+}
@@ -0,0 +1,16 @@
+// Trace message table of the application: one line per log site type, ID name + printf format.
+// Arguments are 32-bit words: use %u %d %x %X %c; floats go in as fixed point.
+// The firmware and trace_decode must be built from the same version of this file.
+
+#ifndef TRACE_MESSAGES_H
+#define TRACE_MESSAGES_H
+
+#define TRACE_MESSAGES(X)                                                    \
+    X(TRACE_ID_BOOT, "boot: core clock %u Hz, trace ring %u words")          \
+    X(TRACE_ID_BUTTON, "EXTI%u: button pressed, count %u")                  \
+    X(TRACE_ID_TICK, "TIM2 CC1: tick %u, ISR latency %u timer ticks")        \
+    X(TRACE_ID_LOOP, "main: %u loop passes since last tick")                 \
+    X(TRACE_ID_COST, "trace cost: %u cycles (1 arg), %u cycles (4 args)")    \
+    X(TRACE_ID_LED, "LED PA%u -> %u")
+
+#endif
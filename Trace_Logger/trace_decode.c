@@ -0,0 +1,228 @@
+// Host side (Linux) decoder for the binary trace stream of Trace_Logger.h
+// Build: gcc -O2 -Wall -o trace_decode trace_decode.c
+// Use:   ./trace_decode /dev/ttyUSB0          (serial port is switched to raw 2 Mbaud)
+//        ./trace_decode -b 921600 /dev/ttyACM0
+//        ./trace_decode capture.bin           (file recorded earlier, or stdin when no path is given)
+
+#define TRACE_HOST
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Trace_Format.h"
+
+#define BUFFER_SIZE 4096U
+
+static uint32_t Read_Le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static speed_t Baud_To_Speed(long Baud)
+{
+    switch (Baud)
+    {
+    case 115200:
+        return B115200;
+    case 230400:
+        return B230400;
+    case 460800:
+        return B460800;
+    case 921600:
+        return B921600;
+    case 1000000:
+        return B1000000;
+    case 2000000:
+        return B2000000;
+    default:
+        return 0;
+    }
+}
+
+static int Serial_Configure(int Fd, long Baud)
+{
+    struct termios tty;
+    speed_t speed = Baud_To_Speed(Baud);
+
+    if (speed == 0)
+    {
+        fprintf(stderr, "unsupported baud rate %ld\n", Baud);
+        return -1;
+    }
+
+    if (tcgetattr(Fd, &tty) != 0)
+    {
+        perror("tcgetattr");
+        return -1;
+    }
+
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = 0;
+
+    if (tcsetattr(Fd, TCSANOW, &tty) != 0)
+    {
+        perror("tcsetattr");
+        return -1;
+    }
+
+    tcflush(Fd, TCIFLUSH);
+    return 0;
+}
+
+static int Is_Header(const uint8_t *Data)
+{
+    uint32_t header = Read_Le32(Data);
+
+    return TRACE_HEADER_VALID(header) && (TRACE_HEADER_ID(header) < TRACE_ID_COUNT);
+}
+
+// Prints one record, returns its size in bytes, 0 if more bytes are needed, -1 if the header is not valid
+static long Decode_Record(const uint8_t *Data, size_t Length, uint64_t *Epoch, uint32_t *Last_Timestamp)
+{
+    uint32_t header;
+    uint32_t timestamp;
+    uint32_t args[TRACE_MAX_ARGS] = {0};
+    uint8_t nargs;
+    uint16_t id;
+    uint64_t ticks;
+
+    if (Length < 4U)
+    {
+        return 0;
+    }
+
+    if (!Is_Header(Data))
+    {
+        return -1;
+    }
+
+    header = Read_Le32(Data);
+
+    id = TRACE_HEADER_ID(header);
+    nargs = TRACE_HEADER_NARGS(header);
+
+    if (Length < (8U + (4U * nargs)))
+    {
+        return 0;
+    }
+
+    timestamp = Read_Le32(&Data[4]);
+
+    for (uint8_t i = 0; i < nargs; i++)
+    {
+        args[i] = Read_Le32(&Data[8U + (4U * i)]);
+    }
+
+    // 32-bit timestamp wrapped since the previous record (records are written in time order)
+    if (timestamp < *Last_Timestamp)
+    {
+        *Epoch += 1ULL << 32;
+    }
+
+    *Last_Timestamp = timestamp;
+    ticks = *Epoch + timestamp;
+
+    printf("[%6llu.%06llu] ", (unsigned long long)(ticks / TRACE_TICK_HZ),
+           (unsigned long long)(((ticks % TRACE_TICK_HZ) * 1000000ULL) / TRACE_TICK_HZ));
+    printf(Trace_Format_Table[id], args[0], args[1], args[2], args[3]);
+    printf("\n");
+    fflush(stdout);
+
+    return (long)(8U + (4U * nargs));
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t buffer[BUFFER_SIZE];
+    size_t fill = 0;
+    long baud = 2000000;
+    const char *path = 0;
+    int fd = STDIN_FILENO;
+    uint64_t epoch = 0;
+    uint32_t last_timestamp = 0;
+    unsigned long skipped = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-b") == 0) && ((i + 1) < argc))
+        {
+            baud = strtol(argv[++i], 0, 10);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (path)
+    {
+        fd = open(path, O_RDONLY | O_NOCTTY);
+
+        if (fd < 0)
+        {
+            perror(path);
+            return 1;
+        }
+
+        if (isatty(fd) && (Serial_Configure(fd, baud) != 0))
+        {
+            return 1;
+        }
+    }
+
+    while (1)
+    {
+        ssize_t n = read(fd, &buffer[fill], BUFFER_SIZE - fill);
+        size_t pos = 0;
+
+        if (n <= 0)
+        {
+            break;
+        }
+
+        fill += (size_t)n;
+
+        while (pos < fill)
+        {
+            long used;
+
+            if (skipped && ((fill - pos) >= 4U) && Is_Header(&buffer[pos]))
+            {
+                printf("<resynchronised after %lu bytes>\n", skipped);
+                skipped = 0;
+            }
+
+            used = Decode_Record(&buffer[pos], fill - pos, &epoch, &last_timestamp);
+
+            if (used == 0)
+            {
+                break;
+            }
+
+            if (used < 0)
+            {
+                skipped++; // lost byte or start mid-record: slide one byte and look for the next header
+                pos++;
+                continue;
+            }
+
+            pos += (size_t)used;
+        }
+
+        memmove(buffer, &buffer[pos], fill - pos);
+        fill -= pos;
+    }
+
+    if (path)
+    {
+        close(fd);
+    }
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+// USART2 at 2 Mbaud with DMA: frames echoed back without copying, periodic telemetry line (STM32F411 / F446)
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/UART_DMA_Driver_STM32F4xx.h"
+
+#define SYST_CSR (*(volatile uint32_t *)(0xE000E010UL))
+#define SYST_RVR (*(volatile uint32_t *)(0xE000E014UL))
+#define SYST_CVR (*(volatile uint32_t *)(0xE000E018UL))
+
+#define CLK_FRQ 16000000UL // Using STM32F411 CPU Clock
+#define LOAD_VAL (CLK_FRQ / 1000) - 1
+
+#define UART_BAUD 2000000UL
+#define RX_RING_SIZE 256U
+
+uint8_t Rx_Ring[RX_RING_SIZE];
+uint8_t Telemetry[16] = "T:00000000\r\n";
+
+volatile uint32_t rx_bytes = 0;
+volatile uint32_t rx_frames = 0;
+
+void SysTimer_Init(void)
+{
+    SYST_RVR = LOAD_VAL;
+    SYST_CVR = 0;
+
+    SYST_CSR = 0;
+    SYST_CSR |= (1 << 0) | (1 << 2);
+}
+
+void delay_ms(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        while (((SYST_CSR >> 16) & 1) == 0);
+    }
+}
+
+// Called from IRQ on IDLE line / half / full ring. Data is echoed straight out of the ring.
+void Frame_Received(const uint8_t *Data, uint16_t Length)
+{
+    rx_bytes += Length;
+    rx_frames++;
+
+    UART_DMA_Transmit(UART_2, Data, Length, 0); // dropped if the previous TX is still running
+}
+
+void Hex_Write(uint8_t *Out, uint32_t Value)
+{
+    for (int8_t i = 7; i >= 0; i--)
+    {
+        uint8_t nibble = (uint8_t)(Value & 0xFU);
+        Out[i] = (uint8_t)((nibble < 10U) ? ('0' + nibble) : ('A' + nibble - 10));
+        Value >>= 4;
+    }
+}
+
+int main(void)
+{
+    NVIC_Init();
+    SysTimer_Init();
+
+    UART_DMA_Init(UART_2, UART_BAUD, Rx_Ring, RX_RING_SIZE, Frame_Received);
+
+    while (1)
+    {
+        delay_ms(1000);
+
+        if (!UART_DMA_Tx_Busy(UART_2))
+        {
+            Hex_Write(&Telemetry[2], rx_bytes);
+            UART_DMA_Transmit(UART_2, Telemetry, 12, 0);
+        }
+    }
+}
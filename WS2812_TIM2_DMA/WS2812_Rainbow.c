@@ -0,0 +1,92 @@
+// 300-LED WS2812B strip on TIM2_CH1 (PA0) with DMA: moving rainbow at 60 fps, no bit-banging, interrupts on
+// STM32F411x / STM32F446xx at 16 MHz HSI. 5 V strip: drive DIN through a 74AHCT125 or similar level shifter.
+// SysTick paces the frames; the strip takes 9.4 ms per frame, leaving the rest of each 16.7 ms to the CPU.
+
+#include <stdint.h>
+#include "../Device_Driver_Devlopment/WS2812_Driver_STM32F4xx.h"
+
+// SysTick Registers-------------------------------------------------------------------
+#define SYST_CSR (*(volatile uint32_t *)(0xE000E010UL))
+#define SYST_RVR (*(volatile uint32_t *)(0xE000E014UL))
+#define SYST_CVR (*(volatile uint32_t *)(0xE000E018UL))
+
+#define CLK_FRQ 16000000UL
+#define FRAME_RATE 60U
+
+#define LED_COUNT 300U
+#define BRIGHTNESS 64U // of 255: 300 LEDs at full white would draw 18 A
+
+uint8_t Frame[3U * LED_COUNT]; // 900 bytes; the DMA buffer adds a fixed 768 bytes for any length
+
+volatile uint8_t frame_due;
+
+void SysTick_Handler(void)
+{
+    frame_due = 1;
+}
+
+// Hue 0..767 -> R, G, B on the colour wheel (three linear ramps), scaled by BRIGHTNESS
+void Hue_To_Rgb(uint16_t Hue, uint8_t *Red, uint8_t *Green, uint8_t *Blue)
+{
+    uint8_t ramp = (uint8_t)(Hue & 0xFFU);
+    uint8_t up = (uint8_t)((ramp * BRIGHTNESS) >> 8);
+    uint8_t down = (uint8_t)(((255U - ramp) * BRIGHTNESS) >> 8);
+
+    switch (Hue >> 8)
+    {
+    case 0:
+        *Red = down;
+        *Green = up;
+        *Blue = 0;
+        break;
+
+    case 1:
+        *Red = 0;
+        *Green = down;
+        *Blue = up;
+        break;
+
+    default:
+        *Red = up;
+        *Green = 0;
+        *Blue = down;
+        break;
+    }
+}
+
+int main(void)
+{
+    uint16_t offset = 0;
+
+    NVIC_Init();
+    WS2812_Init(Frame, LED_COUNT, CLK_FRQ);
+
+    SYST_RVR = (CLK_FRQ / FRAME_RATE) - 1U;
+    SYST_CVR = 0;
+    SYST_CSR = (1 << 0) | (1 << 1) | (1 << 2);
+
+    while (1)
+    {
+        __asm volatile("wfi");
+
+        if (!frame_due || WS2812_Busy())
+        {
+            continue;
+        }
+
+        frame_due = 0;
+
+        for (uint16_t i = 0; i < LED_COUNT; i++)
+        {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+
+            Hue_To_Rgb((uint16_t)(((i * 768U) / LED_COUNT + offset) % 768U), &r, &g, &b);
+            WS2812_Set_Pixel(i, r, g, b);
+        }
+
+        offset = (uint16_t)((offset + 4U) % 768U);
+        (void)WS2812_Show();
+    }
+}